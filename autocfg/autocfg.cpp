@@ -24,6 +24,19 @@
 #   - Support for standard .env file                                      #
 #   - Log all infos to stderr instead of stdout                           #
 #                                                                         #
+#  V0.3.0 19.10.2026                                                      #
+#                                                                         #
+#   - External value resolvers per key prefix with TTL cache              #
+#   - JSON patch mode to set values via JSON pointer                      #
+#   - Generate OTS JSON from SERVERSETUP_ variables without template      #
+#   - {{#each}} blocks for indexed variables and hashed variable lookup   #
+#   - Validate rendered JSON output while writing                         #
+#   - Render daemon on a Unix domain socket with warm configuration       #
+#   - Atomic buffered output with selectable durability                   #
+#   - Template includes with {{> file }} and shared fragment cache        #
+#   - Parallel rendering of large templates in line aligned chunks        #
+#   - UTF-8 BOM and UTF-16 detection for templates and env files          #
+#                                                                         #
 #                                                                         #
 ###########################################################################
 */
@@ -36,8 +49,13 @@
 #include <sys/stat.h>
 
 #include "cfg.hpp"
+#include "resolver.hpp"
+#include "json.hpp"
+#include "otsgen.hpp"
+#include "daemon.hpp"
+#include "parallel.hpp"
 
-#define VERSION "0.2.0"
+#define VERSION "0.3.0"
 
 #define MAX_CFG 1024
 
@@ -51,7 +69,17 @@ int file_exists (const char *pszFilename)
     return (0 == stat (pszFilename, &buffer));
 }
 
-int RunAutoConfig (const char *pszJsonTemplate, const char *pszJsonOutput, const char *pszEnvFile, const char *pszProgram, int prompt)
+int RunPatch (JsonPatch *pPatch, const char *pszJsonInput, const char *pszJsonOutput, int validate, int keep, int durability)
+{
+    AutoConfig AutoCfg;
+
+    AutoCfg.SetValidate (validate, keep);
+    AutoCfg.SetDurability (durability);
+
+    return AutoCfg.FilePatch (pPatch, pszJsonInput, pszJsonOutput);
+}
+
+int RunAutoConfig (const char *pszJsonTemplate, const char *pszJsonOutput, const char *pszEnvFile, const char *pszProgram, int prompt, int generate, int validate, int keep, int durability, int threads, CfgResolver *pResolver)
 {
     int ret = 0;
 
@@ -67,8 +95,29 @@ int RunAutoConfig (const char *pszJsonTemplate, const char *pszJsonOutput, const
             goto Done;
     }
 
-    if (IsNullStr (pszProgram))
+    if ( (pResolver) && (pResolver->HasResolvers()) )
+        AutoCfg.SetResolver (pResolver);
+
+    /* Generated output is always valid JSON. Only rendered templates are validated */
+    if (!generate)
+        AutoCfg.SetValidate (validate, keep);
+
+    AutoCfg.SetDurability (durability);
+
+    if (generate)
     {
+        ret = FileGenerateOts (&AutoCfg, pszJsonOutput);
+    }
+    else if ( (threads > 1) && ( (!IsNullStr (pszProgram)) || (strcmp (pszJsonTemplate, "-")) ) )
+    {
+        ret = FileUpdateParallel (&AutoCfg, pszJsonTemplate, pszProgram, pszJsonOutput, threads);
+    }
+    else if (IsNullStr (pszProgram))
+    {
+        ret = AutoCfg.PrefetchPlaceholders (pszJsonTemplate);
+        if (ret)
+            goto Done;
+
         ret = AutoCfg.FileUpdatePlaceholders (pszJsonTemplate, pszJsonOutput);
     }
     else
@@ -76,6 +125,9 @@ int RunAutoConfig (const char *pszJsonTemplate, const char *pszJsonOutput, const
         ret = AutoCfg.FileUpdateFromProgram (pszProgram, pszJsonOutput);
     }
 
+    if (pResolver)
+        pResolver->WriteCache();
+
     if (ret)
         goto Done;
 
@@ -83,8 +135,15 @@ int RunAutoConfig (const char *pszJsonTemplate, const char *pszJsonOutput, const
     if (ret)
         goto Done;
 
-    if (*pszJsonOutput)
+    if (generate)
+    {
+        if (*pszJsonOutput)
+            fprintf (stderr, "\nCreated [%s] from SERVERSETUP_ variables\n\n", pszJsonOutput);
+    }
+    else if (*pszJsonOutput)
+    {
         fprintf (stderr, "\nCreated [%s] from template [%s]\n\n", pszJsonOutput, pszJsonTemplate);
+    }
 
 Done:
 
@@ -124,12 +183,27 @@ int main (int argc, const char *argv[])
     int i      = 0;
     int count  = 0;
     int prompt = 0;
+    int generate = 0;
+    int validate = 0;
+    int keep     = 0;
+    int threads  = 0;
+    int durability = OUTPUT_DURABILITY_NONE;
 
     const char *pParam       = NULL;
     char szTemplate[MAX_CFG] = {0};
     char szConfig[MAX_CFG]   = {0};
     char szEnvFile[MAX_CFG]  = {0};
     char szProgram[MAX_CFG]  = {0};
+    char szCacheFile[MAX_CFG] = {0};
+    char szNumber[40]         = {0};
+    char szResolver[MAX_BUFFER] = {0};
+    char szSocket[MAX_CFG]    = {0};
+    char szAssignment[MAX_BUFFER+JSON_MAX_POINTER] = {0};
+    long lTTL                 = RESOLVER_DEFAULT_TTL;
+
+    CfgResolver Resolver;
+    JsonPatch   Patch;
+    CfgDaemon   Daemon;
 
     for (i=1; i<argc; i++)
     {
@@ -150,6 +224,79 @@ int main (int argc, const char *argv[])
             if (GetParam (pParam, "-p=", szProgram, sizeof (szProgram)))
                 continue;
 
+            if (GetParam (pParam, "-resolver=", szResolver, sizeof (szResolver)))
+            {
+                if (Resolver.AddResolver (szResolver))
+                    goto Syntax;
+                continue;
+            }
+
+            if (GetParam (pParam, "-parallel=", szNumber, sizeof (szNumber)))
+            {
+                Resolver.SetParallel (atoi (szNumber));
+                continue;
+            }
+
+            if (GetParam (pParam, "-daemon=", szSocket, sizeof (szSocket)))
+                continue;
+
+            if (GetParam (pParam, "-threads=", szNumber, sizeof (szNumber)))
+            {
+                threads = atoi (szNumber);
+                continue;
+            }
+
+            if (GetParam (pParam, "-durability=", szNumber, sizeof (szNumber)))
+            {
+                durability = GetDurability (szNumber);
+
+                if (durability < 0)
+                    goto Syntax;
+                continue;
+            }
+
+            if (GetParam (pParam, "-cache=", szCacheFile, sizeof (szCacheFile)))
+                continue;
+
+            if (GetParam (pParam, "-ttl=", szNumber, sizeof (szNumber)))
+            {
+                lTTL = atol (szNumber);
+                continue;
+            }
+
+            if (GetParam (pParam, "-set=", szAssignment, sizeof (szAssignment)))
+            {
+                if (Patch.AddAssignment (szAssignment))
+                    goto Syntax;
+                continue;
+            }
+
+            if (GetParam (pParam, "-setfile=", szAssignment, sizeof (szAssignment)))
+            {
+                if (Patch.ReadAssignments (szAssignment))
+                    goto Syntax;
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-generate"))
+            {
+                generate = 1;
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-validate"))
+            {
+                validate = 1;
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-keep-on-error"))
+            {
+                validate = 1;
+                keep     = 1;
+                continue;
+            }
+
             if (0 == strcmp (pParam, "-prompt"))
             {
                 prompt = 1;
@@ -191,12 +338,42 @@ int main (int argc, const char *argv[])
 
     } /* for */
 
-    if ( (!*szTemplate) && (!*szProgram) )
+    /* Generate mode does not use a template. A single file name is the output file */
+    if ( (generate) && (*szTemplate) && ('\0' == *szConfig) )
+    {
+        strdncpy (szConfig, szTemplate, sizeof (szConfig));
+        *szTemplate = '\0';
+    }
+
+    if (*szSocket)
+    {
+        if (Resolver.HasResolvers())
+            fprintf (stderr, "Warning: Resolvers are not used in daemon mode\n");
+
+        if ( ('\0' == *szEnvFile) && (file_exists (".env")) )
+            snprintf (szEnvFile, sizeof (szEnvFile)-1, ".env");
+
+        ret = Daemon.Run (szSocket, szEnvFile, threads, validate, keep, durability);
+        goto Done;
+    }
+
+    if ( (!*szTemplate) && (!*szProgram) && (!generate) )
     {
         fprintf (stderr, "\nError: No template file or program specified!\n\n");
         goto Done;
     }
 
+    /* Patch mode: Only values addressed by JSON pointer are replaced in the input file */
+    if (Patch.HasAssignments())
+    {
+        ret = RunPatch (&Patch, szTemplate, szConfig, validate, keep, durability);
+
+        if ( (0 == ret) && (*szConfig) )
+            fprintf (stderr, "\nPatched [%s] into [%s]\n\n", szTemplate, szConfig);
+
+        goto Done;
+    }
+
     /* Check if default .env file is present and use it (like docker-compose does) */
     if ( '\0' == *szEnvFile)
     {
@@ -207,7 +384,10 @@ int main (int argc, const char *argv[])
        }
     }
 
-    ret = RunAutoConfig (szTemplate, szConfig, szEnvFile, szProgram, prompt);
+    if (*szCacheFile)
+        Resolver.SetCacheFile (szCacheFile, lTTL);
+
+    ret = RunAutoConfig (szTemplate, szConfig, szEnvFile, szProgram, prompt, generate, validate, keep, durability, threads, &Resolver);
 
 Done:
 
@@ -216,7 +396,11 @@ Done:
 Syntax:
 
     if (argc)
-        fprintf (stderr, "\nSyntax: %s [-env=<file>] [-prompt] [-f=<template-file>] [-o=<output-file>] [-p=<popen stdout as input>]\n\n", argv[0]);
+        fprintf (stderr, "\nSyntax: %s [-env=<file>] [-prompt] [-f=<template-file>] [-o=<output-file>] [-p=<popen stdout as input>]\n"
+                         "        [-resolver=<prefix>=<command>] [-parallel=<n>] [-cache=<file>] [-ttl=<seconds>]\n"
+                         "        [-set=<JSON pointer>=<value>] [-set=<JSON pointer>:=<raw JSON>] [-setfile=<file>]\n"
+                         "        [-generate] [-validate] [-keep-on-error] [-daemon=<socket>] [-threads=<n>]\n"
+                         "        [-durability=none|data|full]\n\n", argv[0]);
     
     return 1;
 }
@@ -21,8 +21,22 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <process.h>
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 
 #include "cfg.hpp"
+#include "resolver.hpp"
+#include "json.hpp"
+#include "tplcache.hpp"
+#include "textin.hpp"
 
 #define SERVERSETUP_ENV "SERVERSETUP_"
 
@@ -58,10 +72,48 @@ void AutoConfig::Init()
     m_CfgEntriesMax = 0;
     m_CfgEntries    = 0;
     m_Interactive    = 0;
+    m_pResolver      = NULL;
+
+    m_pNameIndex       = NULL;
+    m_NameIndexSize    = 0;
+    m_NameIndexEntries = 0;
+    m_pNameIndexArray  = NULL;
+
+    m_pFamilies        = NULL;
+    m_Families         = 0;
+    m_FamiliesMax      = 0;
+    m_FamilyIndexBuilt = 0;
+
+    m_InBlock          = 0;
+    *m_szBlockFamily   = '\0';
+    m_pBlockBody       = NULL;
+    m_BlockBodyLen     = 0;
+    m_BlockBodyMax     = 0;
+    m_pEachFamily      = NULL;
+    m_EachPos          = 0;
+
+    m_pBase            = NULL;
+
+    m_pValidator       = NULL;
+    m_ValidateError    = 0;
+    m_KeepOnError      = 0;
+    *m_szTempOutput    = '\0';
+    m_pOutputBuffer    = NULL;
+    m_Durability       = OUTPUT_DURABILITY_NONE;
+
+    *m_szTemplateDir   = '\0';
+    m_IncludeDepth     = 0;
+    m_RenderError      = 0;
+
+    m_pMemOutput       = NULL;
+    m_MemOutputSize    = 0;
+    m_MemOutputMax     = 0;
 }
 
 void AutoConfig::Release()
 {
+    int i = 0;
+
     if (m_pCfgArrayHead)
     {
         free (m_pCfgArrayHead);
@@ -70,6 +122,59 @@ void AutoConfig::Release()
         m_pCfgArrayNext = NULL;
         m_CfgEntries    = 0;
     }
+
+    if (m_pNameIndex)
+    {
+        free (m_pNameIndex);
+
+        m_pNameIndex       = NULL;
+        m_NameIndexSize    = 0;
+        m_NameIndexEntries = 0;
+    }
+
+    if (m_pFamilies)
+    {
+        for (i=0; i<m_Families; i++)
+        {
+            if (m_pFamilies[i].pIndexes)
+                free (m_pFamilies[i].pIndexes);
+        }
+
+        free (m_pFamilies);
+
+        m_pFamilies   = NULL;
+        m_Families    = 0;
+        m_FamiliesMax = 0;
+    }
+
+    m_FamilyIndexBuilt = 0;
+
+    if (m_pBlockBody)
+    {
+        free (m_pBlockBody);
+
+        m_pBlockBody   = NULL;
+        m_BlockBodyLen = 0;
+        m_BlockBodyMax = 0;
+    }
+
+    if (m_pValidator)
+    {
+        delete m_pValidator;
+        m_pValidator = NULL;
+    }
+
+    if (m_pOutputBuffer)
+    {
+        free (m_pOutputBuffer);
+        m_pOutputBuffer = NULL;
+    }
+
+    if (m_pMemOutput)
+    {
+        free (m_pMemOutput);
+        m_pMemOutput = NULL;
+    }
 }
 
 AutoConfig::AutoConfig()
@@ -89,8 +194,11 @@ int AutoConfig::AddEntry (char *pszName, char *pszValue)
 
     if (m_CfgEntries >= m_CfgEntriesMax)
     {
-        /* Increase array size and re-allocate memory */
-        m_CfgEntriesMax += INCREASE_ARRAY_ELEMENTS;
+        /* Increase array size and re-allocate memory. Grow by half of the current size for large files */
+        if (m_CfgEntriesMax / 2 > INCREASE_ARRAY_ELEMENTS)
+            m_CfgEntriesMax += m_CfgEntriesMax / 2;
+        else
+            m_CfgEntriesMax += INCREASE_ARRAY_ELEMENTS;
 
         pNewArrayPtr = (CFG_STRUCT *) realloc (m_pCfgArrayHead, m_CfgEntriesMax * sizeof (CFG_STRUCT));
 
@@ -116,11 +224,112 @@ Done:
     return error;
 }
 
-char *AutoConfig::CheckCfgArray (const char *pszName)
+static unsigned int HashName (const char *pszName, int len)
+{
+    /* Case insensitive FNV-1a hash to match STRICMP lookups */
+
+    unsigned int hash = 2166136261u;
+    unsigned char c = 0;
+    int i = 0;
+
+    for (i=0; i<len; i++)
+    {
+        c = (unsigned char) pszName[i];
+
+        if ( (c >= 'A') && (c <= 'Z') )
+            c += 'a' - 'A';
+
+        hash = (hash ^ c) * 16777619u;
+    }
+
+    return hash;
+}
+
+int AutoConfig::BuildNameIndex()
 {
+    /* Open addressing hash table with entry numbers. The first entry of a name wins like in a linear search */
+
+    int  i    = 0;
+    int  Size = 0;
+    int  *pNewIndex = NULL;
+    unsigned int pos = 0;
+
+    if ( (m_pNameIndex) && (m_NameIndexSize >= 2 * m_CfgEntries) )
+    {
+        i = m_NameIndexEntries;
+    }
+    else
+    {
+        Size = 64;
+        while (Size < 2 * m_CfgEntries)
+            Size *= 2;
+
+        pNewIndex = (int *) malloc (Size * sizeof (int));
+
+        if (NULL == pNewIndex)
+            return 2;
+
+        if (m_pNameIndex)
+            free (m_pNameIndex);
 
+        m_pNameIndex    = pNewIndex;
+        m_NameIndexSize = Size;
+
+        for (pos=0; pos < (unsigned int) Size; pos++)
+            m_pNameIndex[pos] = -1;
+
+        i = 0;
+    }
+
+    for (; i<m_CfgEntries; i++)
+    {
+        pos = HashName (m_pCfgArrayHead[i].szName, (int) strlen (m_pCfgArrayHead[i].szName)) & (m_NameIndexSize-1);
+
+        while (m_pNameIndex[pos] >= 0)
+        {
+            if (0 == STRICMP (m_pCfgArrayHead[m_pNameIndex[pos]].szName, m_pCfgArrayHead[i].szName))
+                break;
+
+            pos = (pos+1) & (m_NameIndexSize-1);
+        }
+
+        if (m_pNameIndex[pos] < 0)
+            m_pNameIndex[pos] = i;
+    }
+
+    m_NameIndexEntries = m_CfgEntries;
+    return 0;
+}
+
+char *AutoConfig::CheckCfgArray (const char *pszName)
+{
     CFG_STRUCT *pEntry;
+    unsigned int pos = 0;
+
+    if (0 == m_CfgEntries)
+        return NULL;
+
+    if ( (NULL == m_pNameIndex) || (m_NameIndexEntries != m_CfgEntries) )
+        BuildNameIndex();
+
+    if ( (m_pNameIndex) && (m_NameIndexEntries == m_CfgEntries) )
+    {
+        pos = HashName (pszName, (int) strlen (pszName)) & (m_NameIndexSize-1);
+
+        while (m_pNameIndex[pos] >= 0)
+        {
+            pEntry = m_pCfgArrayHead + m_pNameIndex[pos];
+
+            if (0 == STRICMP (pszName, pEntry->szName))
+                return pEntry->szValue;
 
+            pos = (pos+1) & (m_NameIndexSize-1);
+        }
+
+        return NULL;
+    }
+
+    /* Fallback if the index cannot be allocated */
     pEntry = m_pCfgArrayHead;
 
     while (pEntry < m_pCfgArrayNext)
@@ -134,6 +343,231 @@ char *AutoConfig::CheckCfgArray (const char *pszName)
     return NULL;
 }
 
+static int CompareIndex (const void *p1, const void *p2)
+{
+    return *((const int *) p1) - *((const int *) p2);
+}
+
+int AutoConfig::AddFamilyMember (const char *pszFamily, int FamilyLen, int Index)
+{
+    int f = 0;
+    int *pNewIndexes = NULL;
+    CFG_FAMILY *pNewFamilies = NULL;
+    CFG_FAMILY *pFamily = NULL;
+
+    for (f=0; f<m_Families; f++)
+    {
+        if ( ('\0' == m_pFamilies[f].szName[FamilyLen]) && (0 == STRNICMP (m_pFamilies[f].szName, pszFamily, FamilyLen)) )
+            break;
+    }
+
+    if (f == m_Families)
+    {
+        if (m_Families >= m_FamiliesMax)
+        {
+            m_FamiliesMax += INCREASE_ARRAY_ELEMENTS;
+            pNewFamilies = (CFG_FAMILY *) realloc (m_pFamilies, m_FamiliesMax * sizeof (CFG_FAMILY));
+
+            if (NULL == pNewFamilies)
+            {
+                printf ("\nError: Cannot re-allocate family array (%d)\n\n", m_FamiliesMax);
+                return 2;
+            }
+
+            m_pFamilies = pNewFamilies;
+        }
+
+        memset (&m_pFamilies[f], 0, sizeof (CFG_FAMILY));
+        memcpy (m_pFamilies[f].szName, pszFamily, FamilyLen);
+        m_pFamilies[f].szName[FamilyLen] = '\0';
+        m_Families++;
+    }
+
+    pFamily = &m_pFamilies[f];
+
+    if (pFamily->Count >= pFamily->Max)
+    {
+        pFamily->Max = pFamily->Max ? pFamily->Max * 2 : INITAL_ARRAY_ELEMENTS;
+        pNewIndexes = (int *) realloc (pFamily->pIndexes, pFamily->Max * sizeof (int));
+
+        if (NULL == pNewIndexes)
+        {
+            printf ("\nError: Cannot re-allocate family index (%d)\n\n", pFamily->Max);
+            return 2;
+        }
+
+        pFamily->pIndexes = pNewIndexes;
+    }
+
+    pFamily->pIndexes[pFamily->Count++] = Index;
+    return 0;
+}
+
+int AutoConfig::AddFamilyIndex (const char *pszName, int NameLen)
+{
+    /* Every "_<number>" segment followed by "_" or end of name adds the number to the family named by the part before it */
+
+    int error  = 0;
+    int i      = 0;
+    int j      = 0;
+    int num    = 0;
+    int digits = 0;
+
+    for (i=1; i<NameLen; i++)
+    {
+        if ('_' != pszName[i])
+            continue;
+
+        num    = 0;
+        digits = 0;
+
+        for (j=i+1; (j<NameLen) && (pszName[j] >= '0') && (pszName[j] <= '9'); j++)
+        {
+            num = num * 10 + (pszName[j] - '0');
+            digits++;
+        }
+
+        if ( (0 == digits) || (digits > 9) || (i > MAX_ENTRY_LEN) )
+            continue;
+
+        if ( (j < NameLen) && ('_' != pszName[j]) )
+            continue;
+
+        error = AddFamilyMember (pszName, i, num);
+        if (error)
+            return error;
+    }
+
+    return 0;
+}
+
+int AutoConfig::BuildFamilyIndex()
+{
+    /* Built once from cfg entries and environment. Blocks only look up their family afterwards */
+
+    int  error = 0;
+    int  i     = 0;
+    int  j     = 0;
+    int  n     = 0;
+    char **ppEnv = NULL;
+    const char *pEqual = NULL;
+
+    if (m_FamilyIndexBuilt)
+        return 0;
+
+    for (i=0; i<m_CfgEntries; i++)
+    {
+        error = AddFamilyIndex (m_pCfgArrayHead[i].szName, (int) strlen (m_pCfgArrayHead[i].szName));
+        if (error)
+            goto Done;
+    }
+
+    /* Environment and base entries are already part of the base family index */
+    if (m_pBase)
+    {
+        m_pBase->BuildFamilyIndex();
+
+        for (i=0; i<m_pBase->m_Families; i++)
+        {
+            for (j=0; j<m_pBase->m_pFamilies[i].Count; j++)
+            {
+                error = AddFamilyMember (m_pBase->m_pFamilies[i].szName, (int) strlen (m_pBase->m_pFamilies[i].szName), m_pBase->m_pFamilies[i].pIndexes[j]);
+                if (error)
+                    goto Done;
+            }
+        }
+    }
+
+    for (ppEnv = m_pBase ? NULL : ENVIRON; ppEnv && *ppEnv; ppEnv++)
+    {
+        pEqual = strchr (*ppEnv, '=');
+
+        if (NULL == pEqual)
+            continue;
+
+        error = AddFamilyIndex (*ppEnv, (int) (pEqual - *ppEnv));
+        if (error)
+            goto Done;
+    }
+
+    /* Sort and remove duplicates (one entry per variable of a family member) */
+    for (i=0; i<m_Families; i++)
+    {
+        qsort (m_pFamilies[i].pIndexes, m_pFamilies[i].Count, sizeof (int), CompareIndex);
+
+        n = 0;
+        for (j=0; j<m_pFamilies[i].Count; j++)
+        {
+            if ( (n) && (m_pFamilies[i].pIndexes[n-1] == m_pFamilies[i].pIndexes[j]) )
+                continue;
+
+            m_pFamilies[i].pIndexes[n++] = m_pFamilies[i].pIndexes[j];
+        }
+
+        m_pFamilies[i].Count = n;
+    }
+
+    m_FamilyIndexBuilt = 1;
+
+Done:
+
+    return error;
+}
+
+CFG_FAMILY *AutoConfig::FindFamily (const char *pszName)
+{
+    int i = 0;
+
+    if (IsNullStr (pszName))
+        return NULL;
+
+    for (i=0; i<m_Families; i++)
+    {
+        if (0 == STRICMP (m_pFamilies[i].szName, pszName))
+            return &m_pFamilies[i];
+    }
+
+    return NULL;
+}
+
+char *AutoConfig::LookupValue (const char *pszName)
+{
+    /* Lookup in cfg entries, base config and environment without resolvers */
+
+    char *pVal = NULL;
+
+    pVal = CheckCfgArray (pszName);
+
+    if ( (NULL == pVal) && (m_pBase) )
+        pVal = m_pBase->CheckCfgArray (pszName);
+
+    /* Empty values in file overwrite environment vars */
+    if (NULL == pVal)
+        pVal = getenv (pszName);
+
+    return pVal;
+}
+
+char *AutoConfig::GetValue (char *pszName)
+{
+    char *pVal = NULL;
+    char szValue[MAX_ENTRY_LEN+1] = {0};
+
+    pVal = LookupValue (pszName);
+
+    /* Keys not found in prefetch (e.g. template read from stdin) are resolved on demand */
+    if ( (NULL == pVal) && (m_pResolver) )
+    {
+        if (m_pResolver->Resolve (pszName, szValue, sizeof (szValue)))
+        {
+            AddEntry (pszName, szValue);
+            pVal = CheckCfgArray (pszName);
+        }
+    }
+
+    return pVal;
+}
+
 int AutoConfig::CheckCfgBuffer (char *pszBuffer)
 {
     /* Note: Input buffer will be modified */
@@ -158,7 +592,7 @@ int AutoConfig::CheckCfgBuffer (char *pszBuffer)
 
     while (*p)
     {
-        if (*p < 32)
+        if ((unsigned char) *p < 32)
             *p = '\0';
         p++;
     }
@@ -173,7 +607,7 @@ Done:
 int AutoConfig::ReadCfg (const char *pszFileName)
 {
     int error = 0;
-    FILE  *fpInput = NULL;
+    TextInput Input;
     char  szBuffer[10240] = {0};
 
     if (IsNullStr (pszFileName))
@@ -183,9 +617,7 @@ int AutoConfig::ReadCfg (const char *pszFileName)
         goto Done;
     }
 
-    fpInput = fopen (pszFileName, "r");
-
-    if (NULL == fpInput)
+    if (Input.Open (pszFileName))
     {
         printf ("\nError: Cannot open config file: [%s]\n\n", pszFileName);
         error = 1;
@@ -207,20 +639,86 @@ int AutoConfig::ReadCfg (const char *pszFileName)
 
     m_pCfgArrayNext = m_pCfgArrayHead;
 
-    while ( fgets (szBuffer, sizeof (szBuffer)-1, fpInput) )
+    while ( Input.GetLine (szBuffer, sizeof (szBuffer)-1) )
     {
         CheckCfgBuffer (szBuffer);
     }
 
 Done:
 
-    if (fpInput)
+    Input.Close();
+
+    return error;
+}
+
+int AutoConfig::WritePlaceholder (const char *pszName, FILE *fpOutput)
+{
+    /* Writes the value of a trimmed placeholder name. Returns 1 if the value is empty */
+
+    int  ret = 0;
+    const char *pEnv = pszName;
+    char *pVal = NULL;
+
+    char szLine[1024] = {0};
+    char szBlockName[MAX_ENTRY_LEN+1] = {0};
+
+    /* Include within a line */
+    if ('>' == *pEnv)
     {
-        fclose (fpInput);
-        fpInput = NULL;
+        pEnv++;
+
+        while (' ' == *pEnv)
+            pEnv++;
+
+        if (IncludeTemplate (pEnv, fpOutput))
+            ret = 1;
+
+        return ret;
     }
 
-    return error;
+    /* Names relative to the current {{#each}} block */
+    if ( (m_pEachFamily) && ( ('.' == *pEnv) || ('@' == *pEnv) ) )
+    {
+        if (0 == strcmp (pEnv, "@index"))
+        {
+            snprintf (szLine, sizeof (szLine)-1, "%d", m_pEachFamily->pIndexes[m_EachPos]);
+            WriteOutput (szLine, fpOutput);
+            return 0;
+        }
+
+        if (0 == strcmp (pEnv, "@comma"))
+        {
+            if (m_EachPos+1 < m_pEachFamily->Count)
+                WriteOutput (",", fpOutput);
+
+            return 0;
+        }
+
+        if (GetBlockName (pEnv, szBlockName, sizeof (szBlockName)))
+            pEnv = szBlockName;
+    }
+
+    pVal = GetValue ((char *) pEnv);
+
+    if (pVal && *pVal)
+    {
+        WriteOutput (pVal, fpOutput);
+    }
+    else if (m_Interactive)
+    {
+        if (PromptValue (pEnv, szLine, sizeof (szLine)))
+        {
+            WriteOutput (szLine, fpOutput);
+            AddEntry ((char *) pEnv, szLine);
+        }
+    }
+    else
+    {
+        // printf ("Info: [%s] not found\n", pEnv);
+        ret = 1;
+    }
+
+    return ret;
 }
 
 int AutoConfig::CheckWriteBuffer (char *pszBuffer, FILE *fpOutput)
@@ -231,11 +729,8 @@ int AutoConfig::CheckWriteBuffer (char *pszBuffer, FILE *fpOutput)
     char *pBegin = NULL;
     char *pEnd   = NULL;
     char *pEnv   = NULL;
-    char *pVal   = NULL;
     char *p      = NULL;
 
-    char szLine[1024] = {0};
-
     /* Note: Input parameter pszBuffer is modified in routine! */
 
     pBegin = strstr ( (char *) pszBuffer, "{{");
@@ -254,7 +749,7 @@ int AutoConfig::CheckWriteBuffer (char *pszBuffer, FILE *fpOutput)
     if (len)
     {
         *pBegin = '\0';
-        fputs (pszBuffer, fpOutput);
+        WriteOutput (pszBuffer, fpOutput);
     }
 
     pEnv = pBegin+2;
@@ -279,82 +774,814 @@ int AutoConfig::CheckWriteBuffer (char *pszBuffer, FILE *fpOutput)
         *p = '\0';
     }
 
-    pVal = CheckCfgArray (pEnv);
+    ret = WritePlaceholder (pEnv, fpOutput);
 
-    /* Empty values in file overwrite environment vars */
-    if (NULL == pVal)
-        pVal = getenv (pEnv);
+    /* Write end of line after placeholder */
+    pEnd +=2;
 
-    if (pVal && *pVal)
-    {
-        fputs (pVal, fpOutput);
-    }
-    else if (m_Interactive)
-    {
-        /* Skip server SERVERSETUP_ prefix */
-        p = strstr (pEnv, SERVERSETUP_ENV);
-        if (NULL == p)
-        {
-            p = pEnv;
-        }
-        else
-        {
-            p += strlen (SERVERSETUP_ENV);
-        }
+    /* Now check for the remaining line or another placeholder ... */
+    if (*pEnd)
+        CheckWriteBuffer (pEnd, fpOutput);
 
-        fprintf (stderr, "%s: ", p);
+    return ret;
 
-        *szLine='\0';
+WriteLine:
 
-        if (fgets (szLine, sizeof(szLine)-1, stdin))
-        {
-            p = szLine;
-            while (*p)
-            {
-                if (*p < 32)
-                    *p = '\0';
-                p++;
+    WriteOutput (pszBuffer, fpOutput);
+    return ret;
+}
+
+int AutoConfig::PromptValue (const char *pszName, char *retpszValue, int MaxValueSize)
+{
+    /* Returns 1 if a non empty value was entered */
+
+    char *p = NULL;
+
+    /* Skip server SERVERSETUP_ prefix */
+    p = (char *) strstr (pszName, SERVERSETUP_ENV);
+    if (NULL == p)
+    {
+        p = (char *) pszName;
+    }
+    else
+    {
+        p += strlen (SERVERSETUP_ENV);
+    }
+
+    fprintf (stderr, "%s: ", p);
+
+    *retpszValue='\0';
+
+    if (NULL == fgets (retpszValue, MaxValueSize-1, stdin))
+        return 0;
+
+    p = retpszValue;
+    while (*p)
+    {
+        if ((unsigned char) *p < 32)
+            *p = '\0';
+        p++;
+    }
+
+    return (*retpszValue) ? 1 : 0;
+}
+
+int AutoConfig::GetBlockName (const char *pszName, char *retpszName, int MaxNameSize)
+{
+    /* ".FIELD" -> <family>_<index>_FIELD and "." -> <family>_<index> */
+
+    int len = 0;
+
+    if ('.' != *pszName)
+        return 0;
+
+    if ('\0' == pszName[1])
+        len = snprintf (retpszName, MaxNameSize, "%s_%d", m_szBlockFamily, m_pEachFamily->pIndexes[m_EachPos]);
+    else
+        len = snprintf (retpszName, MaxNameSize, "%s_%d_%s", m_szBlockFamily, m_pEachFamily->pIndexes[m_EachPos], pszName+1);
+
+    return ( (len > 0) && (len < MaxNameSize) );
+}
+
+int AutoConfig::ExpandBlock (FILE *fpOutput)
+{
+    /* Renders the buffered block body once per family member. Output is streamed, only the body is kept in memory */
+
+    int  ret   = 0;
+    int  len   = 0;
+    const char *p    = NULL;
+    const char *pEnd = NULL;
+    const char *pEol = NULL;
+
+    char szBuffer[10240] = {0};
+
+    BuildFamilyIndex();
+
+    m_pEachFamily = FindFamily (m_szBlockFamily);
+
+    if ( (NULL == m_pEachFamily) || (0 == m_pEachFamily->Count) )
+    {
+        fprintf (stderr, "Info: No entries found for [%s]\n", m_szBlockFamily);
+        goto Done;
+    }
+
+    pEnd = m_pBlockBody + m_BlockBodyLen;
+
+    for (m_EachPos = 0; m_EachPos < m_pEachFamily->Count; m_EachPos++)
+    {
+        p = m_pBlockBody;
+
+        while (p < pEnd)
+        {
+            pEol = (const char *) memchr (p, '\n', pEnd - p);
+            len  = pEol ? (int) (pEol - p + 1) : (int) (pEnd - p);
+
+            if (len >= (int) sizeof (szBuffer))
+                len = sizeof (szBuffer) - 1;
+
+            memcpy (szBuffer, p, len);
+            szBuffer[len] = '\0';
+            p += len;
+
+            ret += CheckWriteBuffer (szBuffer, fpOutput);
+        }
+    }
+
+Done:
+
+    m_pEachFamily  = NULL;
+    m_EachPos      = 0;
+    m_BlockBodyLen = 0;
+    m_InBlock      = 0;
+
+    return ret;
+}
+
+int AutoConfig::RenderLine (char *pszBuffer, FILE *fpOutput)
+{
+    /* Handles {{#each <family>}} .. {{/each}} blocks and {{> <file>}} includes on separate lines, all other lines are written via CheckWriteBuffer */
+
+    int  len    = 0;
+    char *pNewBody = NULL;
+    const char *p    = pszBuffer;
+    const char *pEnd = NULL;
+
+    char szInclude[MAX_BUFFER+1] = {0};
+
+    while ( (' ' == *p) || ('\t' == *p) )
+        p++;
+
+    if (m_InBlock)
+    {
+        if (0 == strncmp (p, EACH_END_MARKER, strlen (EACH_END_MARKER)))
+            return ExpandBlock (fpOutput);
+
+        if (0 == strncmp (p, EACH_BEGIN_MARKER, strlen (EACH_BEGIN_MARKER)))
+            fprintf (stderr, "Warning: Nested {{#each}} blocks are not supported\n");
+
+        len = (int) strlen (pszBuffer);
+
+        if (m_BlockBodyLen + len + 1 > m_BlockBodyMax)
+        {
+            m_BlockBodyMax = (m_BlockBodyLen + len + 1) * 2;
+            pNewBody = (char *) realloc (m_pBlockBody, m_BlockBodyMax);
+
+            if (NULL == pNewBody)
+            {
+                printf ("\nError: Cannot re-allocate block buffer (%d)\n\n", m_BlockBodyMax);
+                return 1;
             }
 
-            if (*szLine)
-            {
-                fputs (szLine, fpOutput);
-                AddEntry (pEnv, szLine);
-            }
-        }
+            m_pBlockBody = pNewBody;
+        }
+
+        memcpy (m_pBlockBody + m_BlockBodyLen, pszBuffer, len+1);
+        m_BlockBodyLen += len;
+        return 0;
+    }
+
+    if (0 == strncmp (p, INCLUDE_MARKER, strlen (INCLUDE_MARKER)))
+    {
+        pEnd = strstr (p, "}}");
+
+        if ( (pEnd) && (GetPlaceholderName (p + strlen (INCLUDE_MARKER) - 2, pEnd, szInclude, sizeof (szInclude))) )
+            return IncludeTemplate (szInclude, fpOutput);
+    }
+
+    if (0 == strncmp (p, EACH_BEGIN_MARKER, strlen (EACH_BEGIN_MARKER)))
+    {
+        pEnd = strstr (p, "}}");
+
+        if ( (pEnd) && (GetPlaceholderName (p + strlen (EACH_BEGIN_MARKER) - 2, pEnd, m_szBlockFamily, sizeof (m_szBlockFamily))) )
+        {
+            m_InBlock      = 1;
+            m_BlockBodyLen = 0;
+            return 0;
+        }
+    }
+
+    return CheckWriteBuffer (pszBuffer, fpOutput);
+}
+
+int AutoConfig::FinishRender (FILE *fpOutput)
+{
+    if (0 == m_InBlock)
+        return 0;
+
+    fprintf (stderr, "Warning: Missing %s for [%s]\n", EACH_END_MARKER, m_szBlockFamily);
+
+    return ExpandBlock (fpOutput);
+}
+
+int AutoConfig::SetValidate (int Validate, int KeepOnError)
+{
+    m_KeepOnError   = KeepOnError;
+    m_ValidateError = 0;
+
+    if (0 == Validate)
+        return 0;
+
+    if (NULL == m_pValidator)
+        m_pValidator = new JsonScanner();
+
+    m_pValidator->Reset();
+    return 0;
+}
+
+void AutoConfig::WriteOutput (const char *pszText, FILE *fpOutput)
+{
+    WriteData (pszText, strlen (pszText), fpOutput);
+}
+
+void AutoConfig::WriteData (const char *pData, size_t Size, FILE *fpOutput)
+{
+    /* All rendered output is written here, so validation sees exactly the written bytes without reading the file again.
+       Without output file the data is appended to the memory output buffer */
+
+    size_t i = 0;
+    size_t NewMax = 0;
+    char   *pNewBuffer = NULL;
+
+    if ( (m_pValidator) && (0 == m_ValidateError) )
+    {
+        for (i=0; i<Size; i++)
+        {
+            if (JSON_EVENT_ERROR & m_pValidator->Feed ((unsigned char) pData[i]))
+            {
+                m_ValidateError = 1;
+                break;
+            }
+        }
+    }
+
+    if (fpOutput)
+    {
+        fwrite (pData, 1, Size, fpOutput);
+        return;
+    }
+
+    if (m_MemOutputSize + Size > m_MemOutputMax)
+    {
+        NewMax = m_MemOutputMax ? m_MemOutputMax : 65536;
+
+        while (NewMax < m_MemOutputSize + Size)
+            NewMax *= 2;
+
+        pNewBuffer = (char *) realloc (m_pMemOutput, NewMax);
+
+        if (NULL == pNewBuffer)
+        {
+            printf ("\nError: Cannot re-allocate output buffer (%lu)\n\n", (unsigned long) NewMax);
+            m_RenderError = 1;
+            return;
+        }
+
+        m_pMemOutput   = pNewBuffer;
+        m_MemOutputMax = NewMax;
+    }
+
+    memcpy (m_pMemOutput + m_MemOutputSize, pData, Size);
+    m_MemOutputSize += Size;
+}
+
+char *AutoConfig::DetachMemoryOutput (size_t *retpSize)
+{
+    /* Caller owns and frees the returned buffer */
+
+    char *pBuffer = m_pMemOutput;
+
+    if (retpSize)
+        *retpSize = m_MemOutputSize;
+
+    m_pMemOutput    = NULL;
+    m_MemOutputSize = 0;
+    m_MemOutputMax  = 0;
+
+    return pBuffer;
+}
+
+#ifndef _WIN32
+static mode_t GetCreateMode()
+{
+    /* mkstemp creates files with 0600. Output files get the same mode fopen() would use */
+
+    mode_t Mask = umask (0);
+    umask (Mask);
+
+    return 0666 & ~Mask;
+}
+#endif
+
+FILE *AutoConfig::OpenOutput (const char *pszOutputFile)
+{
+    /* Output is written to a temporary file in the same directory and renamed over the output file when complete */
+
+    int  fd  = -1;
+    FILE *fp = NULL;
+
+    *m_szTempOutput = '\0';
+
+    if (IsNullStr (pszOutputFile))
+        return stdout;
+
+#ifdef _WIN32
+
+    snprintf (m_szTempOutput, sizeof (m_szTempOutput)-1, "%s.%d.tmp", pszOutputFile, _getpid());
+    fp = fopen (m_szTempOutput, "w");
+
+#else
+
+    static mode_t CreateMode = GetCreateMode();
+    struct stat FileStat = {0};
+
+    snprintf (m_szTempOutput, sizeof (m_szTempOutput)-1, "%s.XXXXXX", pszOutputFile);
+    fd = mkstemp (m_szTempOutput);
+
+    if (fd >= 0)
+    {
+        /* Keep permissions of an existing output file */
+        fchmod (fd, stat (pszOutputFile, &FileStat) ? CreateMode : (FileStat.st_mode & 07777));
+        fp = fdopen (fd, "w");
+
+        if (NULL == fp)
+            close (fd);
+    }
+
+#endif
+
+    if (NULL == fp)
+    {
+        if (*m_szTempOutput)
+            remove (m_szTempOutput);
+
+        *m_szTempOutput = '\0';
+        return NULL;
+    }
+
+    if (NULL == m_pOutputBuffer)
+        m_pOutputBuffer = (char *) malloc (OUTPUT_BUFFER_SIZE);
+
+    if (m_pOutputBuffer)
+        setvbuf (fp, m_pOutputBuffer, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+    return fp;
+}
+
+int AutoConfig::SyncOutput (const char *pszOutputFile, FILE *fpOutput)
+{
+    /* Flushes the buffer and writes data (and metadata) to disk depending on durability level */
+
+    int fd = fileno (fpOutput);
+
+    if (fflush (fpOutput))
+        return 1;
+
+    if (OUTPUT_DURABILITY_NONE == m_Durability)
+        return 0;
+
+#ifdef _WIN32
+
+    return _commit (fd) ? 1 : 0;
+
+#else
+
+    if (OUTPUT_DURABILITY_DATA == m_Durability)
+        return FDATASYNC (fd) ? 1 : 0;
+
+    return fsync (fd) ? 1 : 0;
+
+#endif
+}
+
+int AutoConfig::SyncDirectory (const char *pszOutputFile)
+{
+    /* Makes the rename durable. Only required for full durability */
+
+#ifdef _WIN32
+
+    return 0;
+
+#else
+
+    int  error = 0;
+    int  fd    = -1;
+    char *p    = NULL;
+    char szDir[MAX_BUFFER+1] = {0};
+
+    strdncpy (szDir, pszOutputFile, sizeof (szDir));
+
+    p = strrchr (szDir, '/');
+
+    if (NULL == p)
+        strdncpy (szDir, ".", sizeof (szDir));
+    else if (p == szDir)
+        szDir[1] = '\0';
+    else
+        *p = '\0';
+
+    fd = open (szDir, O_RDONLY);
+
+    if (fd < 0)
+        return 1;
+
+    if (fsync (fd))
+        error = 1;
+
+    close (fd);
+    return error;
+
+#endif
+}
+
+int AutoConfig::CloseOutput (const char *pszOutputFile, FILE *fpOutput, int error)
+{
+    int ret = 0;
+
+    if ( (NULL == fpOutput) || (stdout == fpOutput) )
+    {
+        fflush (stdout);
+    }
+    else
+    {
+        if ( (0 == error) && (SyncOutput (pszOutputFile, fpOutput)) )
+        {
+            printf ("\nError: Cannot write output file: [%s]\n\n", pszOutputFile);
+            error = 2;
+        }
+
+        if ( (fclose (fpOutput)) && (0 == error) )
+        {
+            printf ("\nError: Cannot write output file: [%s]\n\n", pszOutputFile);
+            error = 2;
+        }
+    }
+
+    if (0 == error)
+        error = CheckOutput (pszOutputFile);
+
+    if ('\0' == *m_szTempOutput)
+        return error;
+
+    /* Invalid JSON output replaces the output file unless the previous file should be kept */
+    if ( (error) && ( (5 != error) || (m_KeepOnError) ) )
+    {
+        remove (m_szTempOutput);
+    }
+    else
+    {
+#ifdef _WIN32
+        ret = MoveFileExA (m_szTempOutput, pszOutputFile, MOVEFILE_REPLACE_EXISTING | ((OUTPUT_DURABILITY_FULL == m_Durability) ? MOVEFILE_WRITE_THROUGH : 0)) ? 0 : 1;
+#else
+        ret = rename (m_szTempOutput, pszOutputFile);
+#endif
+
+        if (ret)
+        {
+            printf ("\nError: Cannot rename [%s] to [%s]\n\n", m_szTempOutput, pszOutputFile);
+            remove (m_szTempOutput);
+            error = 2;
+        }
+        else if ( (OUTPUT_DURABILITY_FULL == m_Durability) && (SyncDirectory (pszOutputFile)) )
+        {
+            printf ("\nError: Cannot sync directory of output file: [%s]\n\n", pszOutputFile);
+            error = 2;
+        }
+    }
+
+    *m_szTempOutput = '\0';
+
+    return error;
+}
+
+int GetDurability (const char *pszDurability)
+{
+    /* Returns the durability level for "none", "data" or "full" and -1 for invalid values */
+
+    if (0 == STRICMP (pszDurability, "none"))
+        return OUTPUT_DURABILITY_NONE;
+
+    if (0 == STRICMP (pszDurability, "data"))
+        return OUTPUT_DURABILITY_DATA;
+
+    if (0 == STRICMP (pszDurability, "full"))
+        return OUTPUT_DURABILITY_FULL;
+
+    return -1;
+}
+
+int AutoConfig::Prepare()
+{
+    /* Builds all indexes up front. Afterwards lookups do not modify the object and it can be shared as read-only base */
+
+    int error = 0;
+
+    if (m_CfgEntries)
+    {
+        error = BuildNameIndex();
+        if (error)
+            return error;
+    }
+
+    return BuildFamilyIndex();
+}
+
+int AutoConfig::RenderData (const char *pData, size_t Size, FILE *fpOutput)
+{
+    /* Renders template data from memory line by line. Returns the number of placeholders with empty values */
+
+    int  count = 0;
+    int  len   = 0;
+    const char *p    = pData;
+    const char *pEnd = pData + Size;
+    const char *pEol = NULL;
+
+    char szBuffer[TEMPLATE_MAX_LINE] = {0};
+
+    while (p < pEnd)
+    {
+        pEol = (const char *) memchr (p, '\n', pEnd - p);
+        len  = pEol ? (int) (pEol - p + 1) : (int) (pEnd - p);
+
+        if (len >= (int) sizeof (szBuffer))
+            len = sizeof (szBuffer) - 1;
+
+        memcpy (szBuffer, p, len);
+        szBuffer[len] = '\0';
+        p += len;
+
+        if (RenderLine (szBuffer, fpOutput))
+            count++;
+    }
+
+    return count;
+}
+
+int AutoConfig::RenderBuffer (const char *pData, size_t Size, FILE *fpOutput)
+{
+    int count = RenderData (pData, Size, fpOutput);
+
+    if (FinishRender (fpOutput))
+        count++;
+
+    return count;
+}
+
+int AutoConfig::RenderTemplateLines (const TEMPLATE_ENTRY *pTemplate, FILE *fpOutput)
+{
+    /* Renders a template split by the template cache. Same result as RenderData() without searching and copying each line.
+       Lines within a {{#each}} block are collected as text via RenderLine() */
+
+    int  count = 0;
+    int  ret   = 0;
+    int  i     = 0;
+    int  j     = 0;
+    const TEMPLATE_LINE *pLine = NULL;
+    const TEMPLATE_PART *pPart = NULL;
+
+    char szBuffer[TEMPLATE_MAX_LINE] = {0};
+
+    for (i=0; i<pTemplate->Lines; i++)
+    {
+        pLine = pTemplate->pLines + i;
+
+        if (m_InBlock)
+        {
+            memcpy (szBuffer, pLine->pLine, pLine->Len);
+            szBuffer[pLine->Len] = '\0';
+
+            if (RenderLine (szBuffer, fpOutput))
+                count++;
+
+            continue;
+        }
+
+        if (TEMPLATE_LINE_INCLUDE == pLine->Type)
+        {
+            if (IncludeTemplate (pLine->pszName, fpOutput))
+                count++;
+
+            continue;
+        }
+
+        if (TEMPLATE_LINE_EACH == pLine->Type)
+        {
+            strdncpy (m_szBlockFamily, pLine->pszName, sizeof (m_szBlockFamily));
+            m_InBlock      = 1;
+            m_BlockBodyLen = 0;
+            continue;
+        }
+
+        /* Like CheckWriteBuffer() a line counts by its first placeholder */
+        ret = -1;
+
+        for (j=0; j<pLine->Parts; j++)
+        {
+            pPart = pTemplate->pParts + pLine->FirstPart + j;
+
+            if (pPart->TextLen)
+                WriteData (pPart->pText, pPart->TextLen, fpOutput);
+
+            if (NULL == pPart->pszName)
+                continue;
+
+            if (WritePlaceholder (pPart->pszName, fpOutput))
+            {
+                if (ret < 0)
+                    ret = 1;
+            }
+            else if (ret < 0)
+            {
+                ret = 0;
+            }
+        }
+
+        if (ret > 0)
+            count++;
+    }
+
+    return count;
+}
+
+int AutoConfig::RenderTemplate (const TEMPLATE_ENTRY *pTemplate, FILE *fpOutput)
+{
+    int count = RenderTemplateLines (pTemplate, fpOutput);
+
+    if (FinishRender (fpOutput))
+        count++;
+
+    return count;
+}
+
+void AutoConfig::SetTemplatePath (const char *pszTemplate)
+{
+    /* Relative includes are resolved from the directory of the template */
+
+    char *p = NULL;
+
+    *m_szTemplateDir = '\0';
+
+    if ( (IsNullStr (pszTemplate)) || (0 == strcmp (pszTemplate, "-")) )
+        return;
+
+    strdncpy (m_szTemplateDir, pszTemplate, sizeof (m_szTemplateDir));
+
+    p = strrchr (m_szTemplateDir, '/');
+
+#ifdef _WIN32
+    if ( (NULL == p) || (strrchr (m_szTemplateDir, '\\') > p) )
+        p = strrchr (m_szTemplateDir, '\\');
+#endif
+
+    if (p)
+        *(p+1) = '\0';
+    else
+        *m_szTemplateDir = '\0';
+}
+
+int AutoConfig::IncludeTemplate (const char *pszInclude, FILE *fpOutput)
+{
+    /* Fragments are read once per process via the template cache and rendered like template lines */
+
+    int  count = 0;
+    TEMPLATE_ENTRY *pFragment = NULL;
+
+    char szPath[MAX_BUFFER+1]   = {0};
+    char szSaveDir[MAX_BUFFER+1] = {0};
+
+    if (m_IncludeDepth >= MAX_INCLUDE_DEPTH)
+    {
+        fprintf (stderr, "\nError: Maximum include depth exceeded: [%s]\n\n", pszInclude);
+        m_RenderError = 1;
+        return 0;
     }
+
+#ifdef _WIN32
+    if ( ('/' == *pszInclude) || ('\\' == *pszInclude) || (':' == pszInclude[1]) )
+#else
+    if ('/' == *pszInclude)
+#endif
+        *szSaveDir = '\0';
     else
+        strdncpy (szSaveDir, m_szTemplateDir, sizeof (szSaveDir));
+
+    if (strlen (szSaveDir) + strlen (pszInclude) >= sizeof (szPath))
     {
-        // printf ("Info: [%s] not found\n", pEnv);
-        ret = 1;
+        fprintf (stderr, "\nError: Include path too long: [%s]\n\n", pszInclude);
+        m_RenderError = 1;
+        return 0;
     }
 
-    /* Write end of line after placeholder */
-    pEnd +=2;
+    strcpy (szPath, szSaveDir);
+    strcat (szPath, pszInclude);
 
-    /* Now check for the remaining line or another placeholder ... */
-    if (*pEnd)
-        CheckWriteBuffer (pEnd, fpOutput);
+    pFragment = g_TemplateCache.Get (szPath);
 
-    return ret;
+    if (NULL == pFragment)
+    {
+        m_RenderError = 1;
+        return 0;
+    }
 
-WriteLine:
+    strdncpy (szSaveDir, m_szTemplateDir, sizeof (szSaveDir));
+    SetTemplatePath (szPath);
+    m_IncludeDepth++;
 
-    fputs (pszBuffer, fpOutput);
-    return ret;
+    count = RenderTemplateLines (pFragment, fpOutput);
+
+    m_IncludeDepth--;
+    strdncpy (m_szTemplateDir, szSaveDir, sizeof (m_szTemplateDir));
+
+    g_TemplateCache.Release (pFragment);
+
+    return count;
 }
 
-int AutoConfig::FileUpdatePlaceholders (const char *pszInputFile, const char *pszOutputFile)
+int AutoConfig::CheckOutput (const char *pszOutputName)
 {
-    int   error      = 0;
-    int   ret        = 0;
-    int   count      = 0;
-    FILE  *fpInput   = NULL;
-    FILE  *fpOutput  = NULL;
-    FILE  *fpIn      = NULL;
-    FILE  *fpOut     = NULL;
+    /* Returns 6 if an include failed and 5 if output validation is enabled and the rendered output is not valid JSON */
 
-    char  szBuffer[10240] = {0};
+    if (m_RenderError)
+        return 6;
+
+    if (NULL == m_pValidator)
+        return 0;
+
+    if ( (0 == m_ValidateError) && (0 == (JSON_EVENT_ERROR & m_pValidator->Finish())) )
+        return 0;
+
+    fprintf (stderr, "\nError: Invalid JSON output [%s] at line %ld, column %ld: %s\n\n",
+             IsNullStr (pszOutputName) ? "stdout" : pszOutputName,
+             m_pValidator->GetLine(), m_pValidator->GetColumn(), m_pValidator->GetError());
+
+    return 5;
+}
+
+int AutoConfig::FileUpdateFromBuffer (const char *pData, size_t Size, const char *pszOutputFile)
+{
+    int   error = 0;
+    FILE  *fpOut = NULL;
+
+    fpOut = OpenOutput (pszOutputFile);
+
+    if (NULL == fpOut)
+    {
+        printf ("\nError: Cannot open output file: [%s]\n\n", pszOutputFile);
+        error = 2;
+        goto Done;
+    }
+
+    RenderBuffer (pData, Size, fpOut);
+
+Done:
+
+    if (fpOut)
+    {
+        error = CloseOutput (pszOutputFile, fpOut, error);
+        fpOut = NULL;
+    }
+
+    return error;
+}
+
+int AutoConfig::FileUpdateFromTemplate (const TEMPLATE_ENTRY *pTemplate, const char *pszOutputFile)
+{
+    int   error = 0;
+    FILE  *fpOut = NULL;
+
+    fpOut = OpenOutput (pszOutputFile);
+
+    if (NULL == fpOut)
+    {
+        printf ("\nError: Cannot open output file: [%s]\n\n", pszOutputFile);
+        error = 2;
+        goto Done;
+    }
+
+    RenderTemplate (pTemplate, fpOut);
+
+Done:
+
+    if (fpOut)
+    {
+        error = CloseOutput (pszOutputFile, fpOut, error);
+        fpOut = NULL;
+    }
+
+    return error;
+}
+
+int AutoConfig::FilePatch (JsonPatch *pPatch, const char *pszInputFile, const char *pszOutputFile)
+{
+    /* Patched output is written like rendered output: temporary file, durability and rename.
+       The patch writes directly to the stream. With validation it is written to a temporary stream first and copied through WriteData */
+
+    int    error     = 0;
+    size_t len       = 0;
+    FILE   *fpInput  = NULL;
+    FILE   *fpIn     = NULL;
+    FILE   *fpOut    = NULL;
+    FILE   *fpPatched = NULL;
+    char   Buffer[16384];
 
     if ( (IsNullStr (pszInputFile)) || (0 == strcmp (pszInputFile, "-")) )
     {
@@ -362,27 +1589,319 @@ int AutoConfig::FileUpdatePlaceholders (const char *pszInputFile, const char *ps
     }
     else
     {
-        fpInput = fopen (pszInputFile, "r");
+        fpInput = fopen (pszInputFile, "rb");
         fpIn = fpInput;
     }
 
     if (NULL == fpIn)
     {
-        printf ("\nError: Cannot open input file: [%s]\n\n", pszInputFile);
+        fprintf (stderr, "\nError: Cannot open input file: [%s]\n\n", pszInputFile);
         error = 1;
         goto Done;
     }
 
-    if (IsNullStr (pszOutputFile))
+    fpOut = OpenOutput (pszOutputFile);
+
+    if (NULL == fpOut)
+    {
+        printf ("\nError: Cannot open output file: [%s]\n\n", pszOutputFile);
+        error = 2;
+        goto Done;
+    }
+
+    if (m_pValidator)
+    {
+        fpPatched = tmpfile();
+
+        if (NULL == fpPatched)
+        {
+            printf ("\nError: Cannot create temporary file for validation\n\n");
+            error = 2;
+            goto Done;
+        }
+    }
+
+    error = pPatch->Apply (fpIn, fpPatched ? fpPatched : fpOut);
+
+    if ( (0 == error) && (fpPatched) )
+    {
+        rewind (fpPatched);
+
+        while ((len = fread (Buffer, 1, sizeof (Buffer), fpPatched)) > 0)
+            WriteData (Buffer, len, fpOut);
+    }
+
+Done:
+
+    if (fpPatched)
+    {
+        fclose (fpPatched);
+        fpPatched = NULL;
+    }
+
+    if (fpInput)
+    {
+        fclose (fpInput);
+        fpInput = NULL;
+    }
+
+    if (fpOut)
+    {
+        error = CloseOutput (pszOutputFile, fpOut, error);
+        fpOut = NULL;
+    }
+
+    return error;
+}
+
+int GetPlaceholderName (const char *pBegin, const char *pEnd, char *retpszName, int MaxNameSize)
+{
+    /* Returns trimmed name between "{{" and "}}" markers */
+
+    int len = 0;
+
+    if ( (NULL == retpszName) || (MaxNameSize <= 0) )
+        return 0;
+
+    *retpszName = '\0';
+
+    pBegin += 2;
+
+    while ( (pBegin < pEnd) && (' ' == *pBegin) )
+        pBegin++;
+
+    while ( (pEnd > pBegin) && (' ' == *(pEnd-1)) )
+        pEnd--;
+
+    len = (int) (pEnd - pBegin);
+
+    if (len >= MaxNameSize)
+        return 0;
+
+    memcpy (retpszName, pBegin, len);
+    retpszName[len] = '\0';
+
+    return len;
+}
+
+int AutoConfig::CollectPlaceholders (const char *pData, size_t Size, RESOLVER_LOOKUP **ppLookups, int *pCount, int *pLookupMax)
+{
+    /* Adds each unknown placeholder name to the lookup array once. Block and include placeholders are skipped */
+
+    int   i      = 0;
+    const char *p     = pData;
+    const char *pEnd  = pData + Size;
+    const char *pName = NULL;
+    const char *pValue = NULL;
+    RESOLVER_LOOKUP *pNewLookups = NULL;
+
+    char  szName[MAX_ENTRY_LEN+1] = {0};
+
+    while (p+1 < pEnd)
+    {
+        p = (const char *) memchr (p, '{', pEnd - p - 1);
+
+        if (NULL == p)
+            break;
+
+        if ('{' != p[1])
+        {
+            p++;
+            continue;
+        }
+
+        for (pName = p+2; (pName+1 < pEnd) && ( ('}' != pName[0]) || ('}' != pName[1]) ) && ('\n' != *pName); pName++);
+
+        if ( (pName+1 >= pEnd) || ('\n' == *pName) )
+        {
+            p += 2;
+            continue;
+        }
+
+        GetPlaceholderName (p, pName, szName, sizeof (szName));
+        p = pName+2;
+
+        if ( ('\0' == *szName) || (strchr (".@>#/", *szName)) )
+            continue;
+
+        /* Empty values are prompted in interactive mode */
+        pValue = LookupValue (szName);
+
+        if ( (pValue) && ( (*pValue) || (0 == m_Interactive) ) )
+            continue;
+
+        if ( (0 == m_Interactive) && ( (NULL == m_pResolver) || (NULL == m_pResolver->FindResolver (szName)) ) )
+            continue;
+
+        for (i=0; i<*pCount; i++)
+        {
+            if (0 == strcmp ((*ppLookups)[i].szName, szName))
+                break;
+        }
+
+        if (i < *pCount)
+            continue;
+
+        if (*pCount >= *pLookupMax)
+        {
+            *pLookupMax += INITAL_ARRAY_ELEMENTS;
+
+            pNewLookups = (RESOLVER_LOOKUP *) realloc (*ppLookups, *pLookupMax * sizeof (RESOLVER_LOOKUP));
+
+            if (NULL == pNewLookups)
+            {
+                printf ("\nError: Cannot re-allocate lookup array (%d)\n\n", *pLookupMax);
+                return 2;
+            }
+
+            *ppLookups = pNewLookups;
+        }
+
+        memset (&(*ppLookups)[*pCount], 0, sizeof (RESOLVER_LOOKUP));
+        strdncpy ((*ppLookups)[*pCount].szName, szName, sizeof ((*ppLookups)[*pCount].szName));
+        (*pCount)++;
+    }
+
+    return 0;
+}
+
+int AutoConfig::ResolveLookups (RESOLVER_LOOKUP *pLookups, int Count)
+{
+    /* Resolves collected names concurrently and prompts for the remaining names in interactive mode */
+
+    int  i     = 0;
+    int  found = 0;
+    char szValue[MAX_ENTRY_LEN+1] = {0};
+
+    if (0 == Count)
+        return 0;
+
+    if ( (m_pResolver) && (m_pResolver->HasResolvers()) )
+    {
+        found = m_pResolver->ResolveKeys (pLookups, Count);
+        fprintf (stderr, "Info: %d of %d keys resolved\n", found, Count);
+    }
+
+    for (i=0; i<Count; i++)
+    {
+        if (pLookups[i].Found)
+        {
+            AddEntry (pLookups[i].szName, pLookups[i].szValue);
+            continue;
+        }
+
+        if ( (m_Interactive) && (PromptValue (pLookups[i].szName, szValue, sizeof (szValue))) )
+            AddEntry (pLookups[i].szName, szValue);
+    }
+
+    return 0;
+}
+
+int AutoConfig::PrefetchPlaceholders (const char *pszInputFile)
+{
+    /* Collects all unknown placeholders handled by a resolver and looks them up concurrently before rendering */
+
+    int   error     = 0;
+    int   count     = 0;
+    int   LookupMax = 0;
+    int   Interactive = m_Interactive;
+    TextInput Input;
+
+    RESOLVER_LOOKUP *pLookups = NULL;
+
+    char  szBuffer[10240] = {0};
+
+    if ( (NULL == m_pResolver) || (0 == m_pResolver->HasResolvers()) )
+        goto Done;
+
+    /* Input from stdin cannot be read twice, those keys are resolved on demand */
+    if ( (IsNullStr (pszInputFile)) || (0 == strcmp (pszInputFile, "-")) )
+        goto Done;
+
+    if (Input.Open (pszInputFile))
+        goto Done;
+
+    /* Prompting stays in template order while rendering */
+    m_Interactive = 0;
+
+    while ( Input.GetLine (szBuffer, sizeof (szBuffer)-1) )
+    {
+        error = CollectPlaceholders (szBuffer, strlen (szBuffer), &pLookups, &count, &LookupMax);
+        if (error)
+            goto Done;
+    }
+
+    error = ResolveLookups (pLookups, count);
+
+Done:
+
+    m_Interactive = Interactive;
+
+    Input.Close();
+
+    if (pLookups)
+    {
+        free (pLookups);
+        pLookups = NULL;
+    }
+
+    return error;
+}
+
+int AutoConfig::PrefetchBuffer (const char *pData, size_t Size)
+{
+    /* Resolves all lookups which are not idempotent (resolvers, prompts) up front. Afterwards the data can be rendered in any order */
+
+    int   error     = 0;
+    int   count     = 0;
+    int   LookupMax = 0;
+
+    RESOLVER_LOOKUP *pLookups = NULL;
+
+    if ( (0 == m_Interactive) && ( (NULL == m_pResolver) || (0 == m_pResolver->HasResolvers()) ) )
+        return 0;
+
+    error = CollectPlaceholders (pData, Size, &pLookups, &count, &LookupMax);
+
+    if (0 == error)
+        error = ResolveLookups (pLookups, count);
+
+    if (pLookups)
     {
-        fpOut = stdout;
+        free (pLookups);
+        pLookups = NULL;
     }
+
+    return error;
+}
+
+int AutoConfig::FileUpdatePlaceholders (const char *pszInputFile, const char *pszOutputFile)
+{
+    int   error      = 0;
+    int   ret        = 0;
+    int   count      = 0;
+    int   InputError = 0;
+    FILE  *fpOut     = NULL;
+    TextInput Input;
+
+    char  szBuffer[10240] = {0};
+
+    if ( (IsNullStr (pszInputFile)) || (0 == strcmp (pszInputFile, "-")) )
+        InputError = Input.Attach (stdin);
     else
+        InputError = Input.Open (pszInputFile);
+
+    if (InputError)
     {
-        fpOutput = fopen (pszOutputFile, "w");
-        fpOut = fpOutput;
+        printf ("\nError: Cannot open input file: [%s]\n\n", pszInputFile);
+        error = 1;
+        goto Done;
     }
 
+    SetTemplatePath (pszInputFile);
+
+    fpOut = OpenOutput (pszOutputFile);
+
     if (NULL == fpOut)
     {
         printf ("\nError: Cannot open output file: [%s]\n\n", pszOutputFile);
@@ -390,14 +1909,17 @@ int AutoConfig::FileUpdatePlaceholders (const char *pszInputFile, const char *ps
         goto Done;
     }
 
-    while ( fgets (szBuffer, sizeof (szBuffer)-1, fpIn) )
+    while ( Input.GetLine (szBuffer, sizeof (szBuffer)-1) )
     {
-        ret = CheckWriteBuffer (szBuffer, fpOut);
+        ret = RenderLine (szBuffer, fpOut);
 
         if (ret)
             count++;
     }
 
+    if (FinishRender (fpOut))
+        count++;
+
     if (count)
     {
         if (!IsNullStr (pszOutputFile))
@@ -406,16 +1928,12 @@ int AutoConfig::FileUpdatePlaceholders (const char *pszInputFile, const char *ps
 
 Done:
 
-    if (fpInput)
-    {
-        fclose (fpInput);
-        fpInput = NULL;
-    }
+    Input.Close();
 
-    if (fpOutput)
+    if (fpOut)
     {
-        fclose (fpOutput);
-        fpOutput = NULL;
+        error = CloseOutput (pszOutputFile, fpOut, error);
+        fpOut = NULL;
     }
 
     return error;
@@ -427,8 +1945,8 @@ int AutoConfig::FileUpdateFromProgram (const char *pszProgram, const char *pszOu
     int   ret        = 0;
     int   count      = 0;
     FILE  *fpInput   = NULL;
-    FILE  *fpOutput  = NULL;
     FILE  *fpOut     = NULL;
+    TextInput Input;
 
     char  szBuffer[10240] = {0};
 
@@ -441,15 +1959,9 @@ int AutoConfig::FileUpdateFromProgram (const char *pszProgram, const char *pszOu
         goto Done;
     }
 
-    if (IsNullStr (pszOutputFile))
-    {
-        fpOut = stdout;
-    }
-    else
-    {
-        fpOutput = fopen (pszOutputFile, "w");
-        fpOut = fpOutput;
-    }
+    Input.Attach (fpInput);
+
+    fpOut = OpenOutput (pszOutputFile);
 
     if (NULL == fpOut)
     {
@@ -458,14 +1970,17 @@ int AutoConfig::FileUpdateFromProgram (const char *pszProgram, const char *pszOu
         goto Done;
     }
 
-    while ( fgets (szBuffer, sizeof (szBuffer)-1, fpInput) )
+    while ( Input.GetLine (szBuffer, sizeof (szBuffer)-1) )
     {
-        ret = CheckWriteBuffer (szBuffer, fpOut);
+        ret = RenderLine (szBuffer, fpOut);
 
         if (ret)
             count++;
     }
 
+    if (FinishRender (fpOut))
+        count++;
+
     if (count)
     {
         if (!IsNullStr (pszOutputFile))
@@ -474,16 +1989,18 @@ int AutoConfig::FileUpdateFromProgram (const char *pszProgram, const char *pszOu
 
 Done:
 
+    Input.Close();
+
     if (fpInput)
     {
         PCLOSE (fpInput);
         fpInput = NULL;
     }
 
-    if (fpOutput)
+    if (fpOut)
     {
-        fclose (fpOutput);
-        fpOutput = NULL;
+        error = CloseOutput (pszOutputFile, fpOut, error);
+        fpOut = NULL;
     }
 
     return error;
@@ -24,24 +24,42 @@
 #define MAX_ENTRY_LEN 255
 #define MAX_BUFFER    4096
 
+#define OUTPUT_BUFFER_SIZE      (1024*1024)
+
+#define OUTPUT_DURABILITY_NONE  0  /* Atomic rename only */
+#define OUTPUT_DURABILITY_DATA  1  /* Sync file data before rename */
+#define OUTPUT_DURABILITY_FULL  2  /* Sync file and directory */
+
 #define INITAL_ARRAY_ELEMENTS   50
 #define INCREASE_ARRAY_ELEMENTS 10
 
 #ifdef _WIN32
 
     #define STRICMP _stricmp
+    #define STRNICMP _strnicmp
     #define POPEN   _popen
     #define PCLOSE  _pclose
     #define GETCWD  _getcwd
     #define CHDIR   _chdir
+    #define ENVIRON _environ
 
 #else
 
+    extern char **environ;
+
     #define STRICMP strcasecmp
+    #define STRNICMP strncasecmp
     #define POPEN    popen
     #define PCLOSE   pclose
     #define GETCWD   getcwd
     #define CHDIR    chdir
+    #define ENVIRON  environ
+
+    #ifdef __APPLE__
+        #define FDATASYNC fsync
+    #else
+        #define FDATASYNC fdatasync
+    #endif
 
 #endif
 
@@ -52,7 +70,30 @@ typedef struct {
 } CFG_STRUCT;
 
 
-int IsNullStr (const char *pszStr);
+/* Family of indexed variables e.g. SERVERSETUP_USER_1_FIRSTNAME .. SERVERSETUP_USER_<n>_FIRSTNAME */
+typedef struct {
+    char szName[MAX_ENTRY_LEN+1];
+    int  *pIndexes;
+    int  Count;
+    int  Max;
+} CFG_FAMILY;
+
+#define EACH_BEGIN_MARKER "{{#each"
+#define EACH_END_MARKER   "{{/each}}"
+#define INCLUDE_MARKER    "{{>"
+
+#define MAX_INCLUDE_DEPTH 16
+
+class CfgResolver;
+class JsonScanner;
+class JsonPatch;
+struct _RESOLVER_LOOKUP;
+struct _TEMPLATE_ENTRY;
+
+int  IsNullStr (const char *pszStr);
+void strdncpy  (char *s, const char *ct, size_t n);
+int  GetPlaceholderName (const char *pBegin, const char *pEnd, char *retpszName, int MaxNameSize);
+int  GetDurability (const char *pszDurability);
 
 class AutoConfig
 {
@@ -71,6 +112,32 @@ public:
     int  CheckWriteBuffer       (char *pszBuffer, FILE *fpOutput);
     int  ReadCfg                (const char *pszFileName);
     char *CheckCfgArray         (const char *pszName);
+    char *GetValue              (char *pszName);
+    char *LookupValue           (const char *pszName);
+
+    int  PrefetchPlaceholders   (const char *pszInputFile);
+    int  PrefetchBuffer         (const char *pData, size_t Size);
+    int  RenderLine             (char *pszBuffer, FILE *fpOutput);
+    int  FinishRender           (FILE *fpOutput);
+
+    int  BuildFamilyIndex       ();
+    CFG_FAMILY *FindFamily      (const char *pszName);
+
+    void WriteOutput            (const char *pszText, FILE *fpOutput);
+    void WriteData              (const char *pData, size_t Size, FILE *fpOutput);
+    char *DetachMemoryOutput    (size_t *retpSize);
+    int  SetValidate            (int Validate, int KeepOnError);
+    int  CheckOutput            (const char *pszOutputName);
+    FILE *OpenOutput            (const char *pszOutputFile);
+    int  CloseOutput            (const char *pszOutputFile, FILE *fpOutput, int error);
+
+    int  Prepare                ();
+    int  RenderBuffer           (const char *pData, size_t Size, FILE *fpOutput);
+    int  RenderTemplate         (const struct _TEMPLATE_ENTRY *pTemplate, FILE *fpOutput);
+    void SetTemplatePath        (const char *pszTemplate);
+    int  FileUpdateFromBuffer   (const char *pData, size_t Size, const char *pszOutputFile);
+    int  FileUpdateFromTemplate (const struct _TEMPLATE_ENTRY *pTemplate, const char *pszOutputFile);
+    int  FilePatch              (JsonPatch *pPatch, const char *pszInputFile, const char *pszOutputFile);
 
     int AddEntry (char *pszName, char *pszValue);
 
@@ -79,6 +146,37 @@ public:
         m_Interactive = Value;
     }
 
+    void SetDurability (int Durability)
+    {
+        m_Durability = Durability;
+    }
+
+    void SetResolver (CfgResolver *pResolver)
+    {
+        m_pResolver = pResolver;
+    }
+
+    /* Entries not found in this object are looked up in the base object (must be prepared and not modified while in use) */
+    void SetBase (AutoConfig *pBase)
+    {
+        m_pBase = pBase;
+    }
+
+    int GetRenderError()
+    {
+        return m_RenderError;
+    }
+
+    int GetEntryCount()
+    {
+        return m_CfgEntries;
+    }
+
+    CFG_STRUCT *GetEntry (int Index)
+    {
+        return ( (Index >= 0) && (Index < m_CfgEntries) ) ? m_pCfgArrayHead + Index : NULL;
+    }
+
 private:
 
     CFG_STRUCT *m_pCfgArrayHead;
@@ -87,6 +185,64 @@ private:
     int m_CfgEntriesMax;
     int m_CfgEntries;
     int m_Interactive;
+
+    CfgResolver *m_pResolver;
+    AutoConfig  *m_pBase;
+
+    int  BuildNameIndex         ();
+    int  AddFamilyIndex         (const char *pszName, int NameLen);
+    int  AddFamilyMember        (const char *pszFamily, int FamilyLen, int Index);
+    int  ExpandBlock            (FILE *fpOutput);
+    int  GetBlockName           (const char *pszName, char *retpszName, int MaxNameSize);
+    int  SyncOutput             (const char *pszOutputFile, FILE *fpOutput);
+    int  SyncDirectory          (const char *pszOutputFile);
+    int  RenderData             (const char *pData, size_t Size, FILE *fpOutput);
+    int  RenderTemplateLines    (const struct _TEMPLATE_ENTRY *pTemplate, FILE *fpOutput);
+    int  WritePlaceholder       (const char *pszName, FILE *fpOutput);
+    int  IncludeTemplate        (const char *pszInclude, FILE *fpOutput);
+    int  PromptValue            (const char *pszName, char *retpszValue, int MaxValueSize);
+    int  CollectPlaceholders    (const char *pData, size_t Size, struct _RESOLVER_LOOKUP **ppLookups, int *pCount, int *pLookupMax);
+    int  ResolveLookups         (struct _RESOLVER_LOOKUP *pLookups, int Count);
+
+    /* Hash index into the cfg array */
+    int  *m_pNameIndex;
+    int  m_NameIndexSize;
+    int  m_NameIndexEntries;
+    CFG_STRUCT *m_pNameIndexArray;
+
+    CFG_FAMILY *m_pFamilies;
+    int  m_Families;
+    int  m_FamiliesMax;
+    int  m_FamilyIndexBuilt;
+
+    /* Current {{#each}} block */
+    int  m_InBlock;
+    char m_szBlockFamily[MAX_ENTRY_LEN+1];
+    char *m_pBlockBody;
+    int  m_BlockBodyLen;
+    int  m_BlockBodyMax;
+    CFG_FAMILY *m_pEachFamily;
+    int  m_EachPos;
+
+    /* Output validation */
+    JsonScanner *m_pValidator;
+    int  m_ValidateError;
+    int  m_KeepOnError;
+    char m_szTempOutput[MAX_BUFFER+1];
+
+    /* Output buffer and durability */
+    char *m_pOutputBuffer;
+    int  m_Durability;
+
+    /* Includes */
+    char m_szTemplateDir[MAX_BUFFER+1];
+    int  m_IncludeDepth;
+    int  m_RenderError;
+
+    /* Memory output used when no output file is passed */
+    char   *m_pMemOutput;
+    size_t m_MemOutputSize;
+    size_t m_MemOutputMax;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,566 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <thread>
+
+#ifndef _WIN32
+    #include <errno.h>
+    #include <signal.h>
+    #include <unistd.h>
+    #include <sys/time.h>
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+#include "daemon.hpp"
+#include "tplcache.hpp"
+
+#ifndef _WIN32
+static volatile sig_atomic_t g_DaemonShutdown = 0;
+static int g_DaemonSocket = -1;
+
+static void DaemonSignalHandler (int Signal)
+{
+    g_DaemonShutdown = 1;
+
+    /* Wakes up all workers waiting in accept() */
+    if (g_DaemonSocket >= 0)
+        shutdown (g_DaemonSocket, SHUT_RDWR);
+}
+
+static int SendAll (int sock, const char *pData, size_t Size)
+{
+    ssize_t Sent = 0;
+
+    while (Size)
+    {
+        Sent = send (sock, pData, Size, 0);
+
+        if (Sent < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            return 1;
+        }
+
+        pData += Sent;
+        Size  -= Sent;
+    }
+
+    return 0;
+}
+
+static int SendError (int sock, int error, const char *pszMessage)
+{
+    char szLine[MAX_BUFFER+40] = {0};
+
+    snprintf (szLine, sizeof (szLine)-1, "ERROR %d %s\n", error, pszMessage);
+    return SendAll (sock, szLine, strlen (szLine));
+}
+
+static const char *GetRenderErrorText (int error)
+{
+    /* Result codes of AutoConfig::CheckOutput() and CloseOutput() */
+
+    switch (error)
+    {
+        case 2:
+            return "Cannot write output file";
+
+        case 5:
+            return "Invalid JSON output";
+
+        case 6:
+            return "Cannot include fragment";
+
+        default:
+            return "Cannot render template";
+    }
+}
+#endif
+
+CfgDaemon::CfgDaemon()
+{
+    m_pEnv         = NULL;
+    *m_szEnvFile   = '\0';
+    m_ListenSocket = -1;
+    m_Validate     = 0;
+    m_KeepOnError  = 0;
+    m_Durability   = OUTPUT_DURABILITY_NONE;
+}
+
+CfgDaemon::~CfgDaemon()
+{
+    if (m_pEnv)
+    {
+        delete m_pEnv->pCfg;
+        free (m_pEnv);
+        m_pEnv = NULL;
+    }
+}
+
+DAEMON_ENV *CfgDaemon::LoadEnv (time_t tModified)
+{
+    DAEMON_ENV *pEnv = NULL;
+
+    pEnv = (DAEMON_ENV *) calloc (1, sizeof (DAEMON_ENV));
+
+    if (NULL == pEnv)
+        return NULL;
+
+    pEnv->pCfg      = new AutoConfig();
+    pEnv->tModified = tModified;
+
+    if ( (*m_szEnvFile) && (pEnv->pCfg->ReadCfg (m_szEnvFile)) )
+        goto Error;
+
+    /* Build name and family index once. Requests only read the base config */
+    if (pEnv->pCfg->Prepare())
+        goto Error;
+
+    return pEnv;
+
+Error:
+
+    delete pEnv->pCfg;
+    free (pEnv);
+
+    return NULL;
+}
+
+DAEMON_ENV *CfgDaemon::AcquireEnv()
+{
+    struct stat FileStat = {0};
+    DAEMON_ENV *pEnv = NULL;
+    DAEMON_ENV *pOld = NULL;
+
+    if (*m_szEnvFile)
+        stat (m_szEnvFile, &FileStat);
+
+    std::lock_guard<std::mutex> Lock (m_EnvMutex);
+
+    if ( (NULL == m_pEnv) || (m_pEnv->tModified != FileStat.st_mtime) )
+    {
+        pEnv = LoadEnv (FileStat.st_mtime);
+
+        if (pEnv)
+        {
+            if (m_pEnv)
+                fprintf (stderr, "Info: Reloaded [%s]\n", m_szEnvFile);
+
+            /* The previous config is deleted when the last request using it has finished */
+            pOld   = m_pEnv;
+            m_pEnv = pEnv;
+
+            if ( (pOld) && (0 == pOld->Refs) )
+            {
+                delete pOld->pCfg;
+                free (pOld);
+            }
+        }
+        else if (m_pEnv)
+        {
+            fprintf (stderr, "Warning: Cannot reload [%s] - using previous configuration\n", m_szEnvFile);
+            m_pEnv->tModified = FileStat.st_mtime;
+        }
+    }
+
+    if (m_pEnv)
+        m_pEnv->Refs++;
+
+    return m_pEnv;
+}
+
+void CfgDaemon::ReleaseEnv (DAEMON_ENV *pEnv)
+{
+    if (NULL == pEnv)
+        return;
+
+    std::lock_guard<std::mutex> Lock (m_EnvMutex);
+
+    pEnv->Refs--;
+
+    if ( (pEnv != m_pEnv) && (0 == pEnv->Refs) )
+    {
+        delete pEnv->pCfg;
+        free (pEnv);
+    }
+}
+
+#ifdef _WIN32
+
+int CfgDaemon::HandleRequest (int sock)
+{
+    return 1;
+}
+
+void CfgDaemon::Worker()
+{
+}
+
+void CfgDaemon::WorkerThread (CfgDaemon *pDaemon)
+{
+}
+
+int CfgDaemon::Run (const char *pszSocket, const char *pszEnvFile, int Threads, int Validate, int KeepOnError, int Durability)
+{
+    fprintf (stderr, "\nError: Daemon mode is not supported on Windows\n\n");
+    return 1;
+}
+
+#else
+
+int CfgDaemon::HandleRequest (int sock)
+{
+    int     error   = 0;
+    int     len     = 0;
+    ssize_t Read    = 0;
+    size_t  OutSize = 0;
+    char    *p      = NULL;
+    char    *pLine  = NULL;
+    char    *pEqual = NULL;
+    char    *pOut   = NULL;
+    FILE    *fpOut  = NULL;
+    const char *pszTemplate = NULL;
+    const char *pszOutput   = NULL;
+    DAEMON_ENV *pEnv = NULL;
+    TEMPLATE_ENTRY *pTemplate = NULL;
+    AutoConfig Request;
+
+    char szRequest[DAEMON_MAX_REQUEST+1] = {0};
+    char szHeader[80] = {0};
+
+    /* Read request until an empty line or end of input */
+    while (len < DAEMON_MAX_REQUEST)
+    {
+        Read = recv (sock, szRequest+len, DAEMON_MAX_REQUEST-len, 0);
+
+        if (Read < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            if ( (EAGAIN == errno) || (EWOULDBLOCK == errno) )
+                return SendError (sock, 1, "Request timeout");
+
+            return 1;
+        }
+
+        if (0 == Read)
+            break;
+
+        len += (int) Read;
+        szRequest[len] = '\0';
+
+        if ( (0 == strncmp (szRequest, "\n", 1)) || (strstr (szRequest, "\n\n")) || (strstr (szRequest, "\r\n\r\n")) )
+            break;
+    }
+
+    if (len >= DAEMON_MAX_REQUEST)
+        return SendError (sock, 1, "Request too large");
+
+    pEnv = AcquireEnv();
+
+    if (NULL == pEnv)
+    {
+        error = SendError (sock, 1, "Cannot read configuration");
+        goto Done;
+    }
+
+    Request.SetBase (pEnv->pCfg);
+    Request.SetValidate (m_Validate, m_KeepOnError);
+    Request.SetDurability (m_Durability);
+
+    p = szRequest;
+
+    while (p && *p)
+    {
+        pLine = p;
+        p = strchr (p, '\n');
+
+        if (p)
+            *p++ = '\0';
+
+        len = (int) strlen (pLine);
+
+        if ( (len) && ('\r' == pLine[len-1]) )
+            pLine[--len] = '\0';
+
+        if (0 == len)
+            break;
+
+        if (0 == strncmp (pLine, "template=", 9))
+        {
+            pszTemplate = pLine + 9;
+        }
+        else if (0 == strncmp (pLine, "output=", 7))
+        {
+            pszOutput = pLine + 7;
+        }
+        else if (0 == strncmp (pLine, "var=", 4))
+        {
+            pEqual = strchr (pLine+4, '=');
+
+            if (NULL == pEqual)
+            {
+                error = SendError (sock, 1, "Invalid variable");
+                goto Done;
+            }
+
+            *pEqual = '\0';
+            Request.AddEntry (pLine+4, pEqual+1);
+        }
+        else
+        {
+            error = SendError (sock, 1, "Invalid request");
+            goto Done;
+        }
+    }
+
+    if (IsNullStr (pszTemplate))
+    {
+        error = SendError (sock, 1, "No template specified");
+        goto Done;
+    }
+
+    pTemplate = g_TemplateCache.Get (pszTemplate);
+
+    if (NULL == pTemplate)
+    {
+        error = SendError (sock, 1, "Cannot read template");
+        goto Done;
+    }
+
+    Request.SetTemplatePath (pszTemplate);
+
+    if (!IsNullStr (pszOutput))
+    {
+        error = Request.FileUpdateFromTemplate (pTemplate, pszOutput);
+
+        if (error)
+            error = SendError (sock, error, GetRenderErrorText (error));
+        else
+            error = SendAll (sock, "OK 0\n", 5);
+
+        goto Done;
+    }
+
+    /* Inline response: Render into memory to send the size before the data */
+    fpOut = open_memstream (&pOut, &OutSize);
+
+    if (NULL == fpOut)
+    {
+        error = SendError (sock, 2, "Cannot allocate output buffer");
+        goto Done;
+    }
+
+    Request.RenderTemplate (pTemplate, fpOut);
+
+    fclose (fpOut);
+    fpOut = NULL;
+
+    error = Request.CheckOutput ("inline");
+
+    if (error)
+    {
+        error = SendError (sock, error, GetRenderErrorText (error));
+        goto Done;
+    }
+
+    snprintf (szHeader, sizeof (szHeader)-1, "OK %lu\n", (unsigned long) OutSize);
+
+    error = SendAll (sock, szHeader, strlen (szHeader));
+
+    if (0 == error)
+        error = SendAll (sock, pOut, OutSize);
+
+Done:
+
+    if (pOut)
+    {
+        free (pOut);
+        pOut = NULL;
+    }
+
+    g_TemplateCache.Release (pTemplate);
+    ReleaseEnv (pEnv);
+
+    return error;
+}
+
+void CfgDaemon::Worker()
+{
+    int sock = -1;
+    struct timeval Timeout;
+
+    /* A client which stops sending or reading must not block a worker */
+    memset (&Timeout, 0, sizeof (Timeout));
+    Timeout.tv_sec = DAEMON_IO_TIMEOUT;
+
+    while (0 == g_DaemonShutdown)
+    {
+        sock = accept (m_ListenSocket, NULL, NULL);
+
+        if (sock < 0)
+        {
+            if ( (EINTR == errno) || (ECONNABORTED == errno) )
+                continue;
+
+            if (0 == g_DaemonShutdown)
+                perror ("Error: accept");
+
+            break;
+        }
+
+        setsockopt (sock, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof (Timeout));
+        setsockopt (sock, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof (Timeout));
+
+        HandleRequest (sock);
+        close (sock);
+    }
+}
+
+void CfgDaemon::WorkerThread (CfgDaemon *pDaemon)
+{
+    pDaemon->Worker();
+}
+
+int CfgDaemon::Run (const char *pszSocket, const char *pszEnvFile, int Threads, int Validate, int KeepOnError, int Durability)
+{
+    int    error = 0;
+    int    i     = 0;
+    mode_t OldMask = 0;
+    DAEMON_ENV *pEnv = NULL;
+    std::thread *pThreads = NULL;
+    struct sockaddr_un Addr;
+
+    if (Threads < 1)
+        Threads = DAEMON_DEFAULT_THREADS;
+
+    if (Threads > DAEMON_MAX_THREADS)
+        Threads = DAEMON_MAX_THREADS;
+
+    m_Validate    = Validate;
+    m_KeepOnError = KeepOnError;
+    m_Durability  = Durability;
+
+    if (!IsNullStr (pszEnvFile))
+        strdncpy (m_szEnvFile, pszEnvFile, sizeof (m_szEnvFile));
+
+    memset (&Addr, 0, sizeof (Addr));
+    Addr.sun_family = AF_UNIX;
+
+    if (strlen (pszSocket) >= sizeof (Addr.sun_path))
+    {
+        fprintf (stderr, "\nError: Socket path too long: [%s]\n\n", pszSocket);
+        error = 1;
+        goto Done;
+    }
+
+    strdncpy (Addr.sun_path, pszSocket, sizeof (Addr.sun_path));
+
+    /* Warm up configuration before accepting requests */
+    pEnv = AcquireEnv();
+
+    if (NULL == pEnv)
+    {
+        fprintf (stderr, "\nError: Cannot read configuration\n\n");
+        error = 1;
+        goto Done;
+    }
+
+    ReleaseEnv (pEnv);
+
+    m_ListenSocket = socket (AF_UNIX, SOCK_STREAM, 0);
+
+    if (m_ListenSocket < 0)
+    {
+        perror ("Error: socket");
+        error = 2;
+        goto Done;
+    }
+
+    unlink (pszSocket);
+
+    /* Only the owner can connect */
+    OldMask = umask (077);
+
+    if (bind (m_ListenSocket, (struct sockaddr *) &Addr, sizeof (Addr)))
+    {
+        umask (OldMask);
+        perror ("Error: bind");
+        error = 2;
+        goto Done;
+    }
+
+    umask (OldMask);
+
+    if (listen (m_ListenSocket, DAEMON_LISTEN_BACKLOG))
+    {
+        perror ("Error: listen");
+        error = 2;
+        goto Done;
+    }
+
+    g_DaemonShutdown = 0;
+    g_DaemonSocket   = m_ListenSocket;
+
+    signal (SIGPIPE, SIG_IGN);
+    signal (SIGINT,  DaemonSignalHandler);
+    signal (SIGTERM, DaemonSignalHandler);
+
+    fprintf (stderr, "Info: Listening on [%s] with %d threads\n", pszSocket, Threads);
+
+    pThreads = new std::thread[Threads];
+
+    for (i=0; i<Threads; i++)
+        pThreads[i] = std::thread (WorkerThread, this);
+
+    for (i=0; i<Threads; i++)
+        pThreads[i].join();
+
+    delete [] pThreads;
+    pThreads = NULL;
+
+    fprintf (stderr, "Info: Shutdown\n");
+
+    unlink (pszSocket);
+
+Done:
+
+    g_DaemonSocket = -1;
+
+    if (m_ListenSocket >= 0)
+    {
+        close (m_ListenSocket);
+        m_ListenSocket = -1;
+    }
+
+    return error;
+}
+
+#endif
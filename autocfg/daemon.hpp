@@ -0,0 +1,86 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef DAEMON_HPP
+    #define DAEMON_HPP
+
+#include <time.h>
+
+#include <mutex>
+
+#include "cfg.hpp"
+
+#define DAEMON_DEFAULT_THREADS  4
+#define DAEMON_MAX_THREADS      64
+#define DAEMON_MAX_REQUEST      65536
+#define DAEMON_LISTEN_BACKLOG   64
+#define DAEMON_IO_TIMEOUT       10    /* Seconds a client may take to send a request or to read the response */
+
+typedef struct {
+    AutoConfig *pCfg;
+    time_t     tModified;
+    int        Refs;
+} DAEMON_ENV;
+
+
+/* Render daemon: Serves render requests over a Unix domain socket from a pool of worker threads.
+   Env file and environment are read once into a prepared base config and reloaded when the env file changes.
+   Templates are kept in the process wide template cache.
+
+   Request (lines terminated by an empty line or end of input):
+
+     template=<template file>
+     output=<output file>        optional, without output the rendered result is returned inline
+     var=<name>=<value>          optional, overrides env file and environment
+
+   Response: "OK <bytes>\n" followed by the rendered result or "ERROR <code> <message>\n" */
+
+class CfgDaemon
+{
+
+public:
+
+    CfgDaemon();
+    ~CfgDaemon();
+
+    int  Run (const char *pszSocket, const char *pszEnvFile, int Threads, int Validate, int KeepOnError, int Durability);
+
+private:
+
+    DAEMON_ENV *AcquireEnv ();
+    void ReleaseEnv (DAEMON_ENV *pEnv);
+    DAEMON_ENV *LoadEnv (time_t tModified);
+
+    void Worker ();
+    int  HandleRequest (int sock);
+
+    static void WorkerThread (CfgDaemon *pDaemon);
+
+    std::mutex m_EnvMutex;
+    DAEMON_ENV *m_pEnv;
+
+    char m_szEnvFile[MAX_BUFFER+1];
+    int  m_ListenSocket;
+    int  m_Validate;
+    int  m_KeepOnError;
+    int  m_Durability;
+};
+
+#endif
@@ -0,0 +1,984 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "json.hpp"
+
+/* Scanner states */
+#define JSON_STATE_VALUE          1
+#define JSON_STATE_VALUE_OR_END   2
+#define JSON_STATE_KEY_OR_END     3
+#define JSON_STATE_KEY            4
+#define JSON_STATE_COLON          5
+#define JSON_STATE_COMMA_OR_END   6
+#define JSON_STATE_STRING         7
+#define JSON_STATE_STRING_ESCAPE  8
+#define JSON_STATE_STRING_HEX     9
+#define JSON_STATE_SCALAR         10
+#define JSON_STATE_DONE           11
+#define JSON_STATE_ERROR          12
+
+/* Number states */
+#define JSON_NUM_SIGN             1
+#define JSON_NUM_ZERO             2
+#define JSON_NUM_INT              3
+#define JSON_NUM_DOT              4
+#define JSON_NUM_FRAC             5
+#define JSON_NUM_EXP              6
+#define JSON_NUM_EXP_SIGN         7
+#define JSON_NUM_EXP_DIGITS       8
+
+#define IS_JSON_WHITESPACE(c) ((' ' == (c)) || ('\t' == (c)) || ('\n' == (c)) || ('\r' == (c)))
+#define IS_DIGIT(c)           (((c) >= '0') && ((c) <= '9'))
+
+
+JsonScanner::JsonScanner()
+{
+    Reset();
+}
+
+void JsonScanner::Reset()
+{
+    m_Depth       = 0;
+    m_State       = JSON_STATE_VALUE;
+    m_ValueType   = JSON_TYPE_NONE;
+    m_StringIsKey = 0;
+    m_HexDigits   = 0;
+    m_ScalarState = 0;
+    m_pLiteral    = NULL;
+    m_Line        = 1;
+    m_Column      = 0;
+    *m_szError    = '\0';
+}
+
+int JsonScanner::SetError (const char *pszError)
+{
+    if (JSON_STATE_ERROR != m_State)
+        snprintf (m_szError, sizeof (m_szError)-1, "%s", pszError);
+
+    m_State = JSON_STATE_ERROR;
+    return JSON_EVENT_ERROR;
+}
+
+int JsonScanner::EndValue (int Events)
+{
+    m_State = m_Depth ? JSON_STATE_COMMA_OR_END : JSON_STATE_DONE;
+    return Events;
+}
+
+int JsonScanner::BeginValue (int c)
+{
+    JSON_LEVEL *pLevel = NULL;
+
+    switch (c)
+    {
+        case '{':
+        case '[':
+
+            if (m_Depth >= JSON_MAX_DEPTH)
+                return SetError ("Maximum nesting level exceeded");
+
+            pLevel = &m_Stack[m_Depth++];
+
+            pLevel->Type   = ('{' == c) ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY;
+            pLevel->Index  = 0;
+            pLevel->KeyLen = 0;
+            *pLevel->szKey = '\0';
+
+            m_ValueType = pLevel->Type;
+            m_State = ('{' == c) ? JSON_STATE_KEY_OR_END : JSON_STATE_VALUE_OR_END;
+            break;
+
+        case '"':
+            m_ValueType   = JSON_TYPE_STRING;
+            m_StringIsKey = 0;
+            m_State       = JSON_STATE_STRING;
+            break;
+
+        case 't':
+        case 'f':
+        case 'n':
+            m_ValueType = JSON_TYPE_LITERAL;
+            m_pLiteral  = ('t' == c) ? "rue" : ('f' == c) ? "alse" : "ull";
+            m_State     = JSON_STATE_SCALAR;
+            break;
+
+        default:
+
+            if ( ('-' != c) && !IS_DIGIT (c) )
+                return SetError ("Unexpected character");
+
+            m_ValueType   = JSON_TYPE_NUMBER;
+            m_pLiteral    = NULL;
+            m_ScalarState = ('-' == c) ? JSON_NUM_SIGN : ('0' == c) ? JSON_NUM_ZERO : JSON_NUM_INT;
+            m_State       = JSON_STATE_SCALAR;
+            break;
+    }
+
+    return JSON_EVENT_VALUE_BEGIN;
+}
+
+int JsonScanner::FeedScalar (int c)
+{
+    /* Returns 1 if the character belongs to the scalar, 0 if the scalar ended before it and -1 on error */
+
+    if (m_pLiteral)
+    {
+        if ('\0' == *m_pLiteral)
+            return 0;
+
+        if (c != *m_pLiteral)
+            return -1;
+
+        m_pLiteral++;
+        return 1;
+    }
+
+    switch (m_ScalarState)
+    {
+        case JSON_NUM_SIGN:
+            if (!IS_DIGIT (c))
+                return -1;
+
+            m_ScalarState = ('0' == c) ? JSON_NUM_ZERO : JSON_NUM_INT;
+            return 1;
+
+        case JSON_NUM_ZERO:
+        case JSON_NUM_INT:
+            if ( (JSON_NUM_INT == m_ScalarState) && IS_DIGIT (c) )
+                return 1;
+
+            if ('.' == c)
+            {
+                m_ScalarState = JSON_NUM_DOT;
+                return 1;
+            }
+
+            if ( ('e' == c) || ('E' == c) )
+            {
+                m_ScalarState = JSON_NUM_EXP;
+                return 1;
+            }
+
+            return IS_DIGIT (c) ? -1 : 0;
+
+        case JSON_NUM_DOT:
+            if (!IS_DIGIT (c))
+                return -1;
+
+            m_ScalarState = JSON_NUM_FRAC;
+            return 1;
+
+        case JSON_NUM_FRAC:
+            if (IS_DIGIT (c))
+                return 1;
+
+            if ( ('e' == c) || ('E' == c) )
+            {
+                m_ScalarState = JSON_NUM_EXP;
+                return 1;
+            }
+
+            return 0;
+
+        case JSON_NUM_EXP:
+            if ( ('+' == c) || ('-' == c) )
+            {
+                m_ScalarState = JSON_NUM_EXP_SIGN;
+                return 1;
+            }
+
+            /* fall through */
+
+        case JSON_NUM_EXP_SIGN:
+            if (!IS_DIGIT (c))
+                return -1;
+
+            m_ScalarState = JSON_NUM_EXP_DIGITS;
+            return 1;
+
+        case JSON_NUM_EXP_DIGITS:
+            return IS_DIGIT (c) ? 1 : 0;
+    }
+
+    return -1;
+}
+
+int JsonScanner::Feed (int c)
+{
+    int ret    = 0;
+    int Events = 0;
+    JSON_LEVEL *pLevel = NULL;
+
+    if (JSON_STATE_ERROR == m_State)
+        return JSON_EVENT_ERROR;
+
+    if ('\n' == c)
+    {
+        m_Line++;
+        m_Column = 0;
+    }
+    else
+    {
+        m_Column++;
+    }
+
+    pLevel = m_Depth ? &m_Stack[m_Depth-1] : NULL;
+
+    if (JSON_STATE_SCALAR == m_State)
+    {
+        ret = FeedScalar (c);
+
+        if (ret > 0)
+            return 0;
+
+        if (ret < 0)
+            return SetError (m_pLiteral ? "Invalid literal" : "Invalid number");
+
+        Events = EndValue (JSON_EVENT_SCALAR_END);
+    }
+
+    switch (m_State)
+    {
+        case JSON_STATE_STRING:
+
+            if ('"' == c)
+            {
+                if (m_StringIsKey)
+                {
+                    m_State = JSON_STATE_COLON;
+                    return 0;
+                }
+
+                return EndValue (JSON_EVENT_VALUE_END);
+            }
+
+            if ('\\' == c)
+            {
+                m_State = JSON_STATE_STRING_ESCAPE;
+                return 0;
+            }
+
+            if ( (c >= 0) && (c < 32) )
+                return SetError ("Control character in string");
+
+            if ( (m_StringIsKey) && (pLevel->KeyLen < MAX_ENTRY_LEN) )
+            {
+                pLevel->szKey[pLevel->KeyLen++] = (char) c;
+                pLevel->szKey[pLevel->KeyLen] = '\0';
+            }
+
+            return 0;
+
+        case JSON_STATE_STRING_ESCAPE:
+
+            if ('u' == c)
+            {
+                m_HexDigits = 0;
+                m_State = JSON_STATE_STRING_HEX;
+                return 0;
+            }
+
+            if (NULL == strchr ("\"\\/bfnrt", c))
+                return SetError ("Invalid escape sequence");
+
+            if ( (m_StringIsKey) && (pLevel->KeyLen < MAX_ENTRY_LEN) && (strchr ("\"\\/", c)) )
+            {
+                pLevel->szKey[pLevel->KeyLen++] = (char) c;
+                pLevel->szKey[pLevel->KeyLen] = '\0';
+            }
+
+            m_State = JSON_STATE_STRING;
+            return 0;
+
+        case JSON_STATE_STRING_HEX:
+
+            if ( !IS_DIGIT (c) && !((c >= 'a') && (c <= 'f')) && !((c >= 'A') && (c <= 'F')) )
+                return SetError ("Invalid unicode escape sequence");
+
+            if (++m_HexDigits >= 4)
+                m_State = JSON_STATE_STRING;
+
+            return 0;
+    }
+
+    if (IS_JSON_WHITESPACE (c))
+        return Events;
+
+    switch (m_State)
+    {
+        case JSON_STATE_VALUE_OR_END:
+
+            if (']' == c)
+            {
+                m_Depth--;
+                return EndValue (Events | JSON_EVENT_VALUE_END);
+            }
+
+            /* fall through */
+
+        case JSON_STATE_VALUE:
+            return Events | BeginValue (c);
+
+        case JSON_STATE_KEY_OR_END:
+
+            if ('}' == c)
+            {
+                m_Depth--;
+                return EndValue (Events | JSON_EVENT_VALUE_END);
+            }
+
+            /* fall through */
+
+        case JSON_STATE_KEY:
+
+            if ('"' != c)
+                return SetError ("Expected object key");
+
+            pLevel->KeyLen = 0;
+            *pLevel->szKey = '\0';
+
+            m_StringIsKey = 1;
+            m_State = JSON_STATE_STRING;
+            return Events;
+
+        case JSON_STATE_COLON:
+
+            if (':' != c)
+                return SetError ("Expected ':'");
+
+            m_State = JSON_STATE_VALUE;
+            return Events;
+
+        case JSON_STATE_COMMA_OR_END:
+
+            if (',' == c)
+            {
+                if (JSON_TYPE_ARRAY == pLevel->Type)
+                {
+                    pLevel->Index++;
+                    m_State = JSON_STATE_VALUE;
+                }
+                else
+                {
+                    m_State = JSON_STATE_KEY;
+                }
+
+                return Events;
+            }
+
+            if ( ('}' == c) && (JSON_TYPE_OBJECT == pLevel->Type) )
+            {
+                m_Depth--;
+                return EndValue (Events | JSON_EVENT_VALUE_END);
+            }
+
+            if ( (']' == c) && (JSON_TYPE_ARRAY == pLevel->Type) )
+            {
+                m_Depth--;
+                return EndValue (Events | JSON_EVENT_VALUE_END);
+            }
+
+            return SetError ("Expected ',' or end of object/array");
+
+        case JSON_STATE_DONE:
+            return SetError ("Unexpected data after end of document");
+    }
+
+    return SetError ("Invalid scanner state");
+}
+
+int JsonScanner::Finish()
+{
+    int Events = 0;
+
+    if (JSON_STATE_ERROR == m_State)
+        return JSON_EVENT_ERROR;
+
+    if (JSON_STATE_SCALAR == m_State)
+    {
+        if (FeedScalar (' ') < 0)
+            return SetError (m_pLiteral ? "Invalid literal" : "Invalid number");
+
+        Events = EndValue (JSON_EVENT_SCALAR_END);
+    }
+
+    if (JSON_STATE_DONE != m_State)
+        return SetError ("Unexpected end of document");
+
+    return Events;
+}
+
+
+int JsonIsScalar (const char *pszValue)
+{
+    /* Checks if a value can be written unquoted as a JSON number or literal */
+
+    JsonScanner Scanner;
+    const unsigned char *p = (const unsigned char *) pszValue;
+
+    if (IsNullStr (pszValue))
+        return 0;
+
+    while (*p)
+    {
+        if (JSON_EVENT_ERROR & Scanner.Feed (*p))
+            return 0;
+        p++;
+    }
+
+    if (JSON_EVENT_ERROR & Scanner.Finish())
+        return 0;
+
+    return ( (JSON_TYPE_NUMBER == Scanner.GetValueType()) || (JSON_TYPE_LITERAL == Scanner.GetValueType()) );
+}
+
+void JsonWriteStringLen (const char *pszValue, int len, FILE *fpOutput)
+{
+    const unsigned char *p = (const unsigned char *) pszValue;
+    const unsigned char *pEnd = p + len;
+
+    putc ('"', fpOutput);
+
+    while (p < pEnd)
+    {
+        switch (*p)
+        {
+            case '"':  fputs ("\\\"", fpOutput); break;
+            case '\\': fputs ("\\\\", fpOutput); break;
+            case '\b': fputs ("\\b",  fpOutput); break;
+            case '\f': fputs ("\\f",  fpOutput); break;
+            case '\n': fputs ("\\n",  fpOutput); break;
+            case '\r': fputs ("\\r",  fpOutput); break;
+            case '\t': fputs ("\\t",  fpOutput); break;
+
+            default:
+                if ((unsigned char) *p < 32)
+                    fprintf (fpOutput, "\\u%04x", (unsigned char) *p);
+                else
+                    putc (*p, fpOutput);
+                break;
+        }
+
+        p++;
+    }
+
+    putc ('"', fpOutput);
+}
+
+void JsonWriteString (const char *pszValue, FILE *fpOutput)
+{
+    JsonWriteStringLen (pszValue, pszValue ? (int) strlen (pszValue) : 0, fpOutput);
+}
+
+
+JsonWriter::JsonWriter (FILE *fpOutput)
+{
+    m_fpOutput = fpOutput;
+    m_Depth    = 0;
+    m_Error    = 0;
+    m_Type[0]  = JSON_TYPE_NONE;
+    m_Items[0] = 0;
+}
+
+void JsonWriter::Indent()
+{
+    int i = 0;
+
+    putc ('\n', m_fpOutput);
+
+    for (i=0; i<m_Depth; i++)
+        fputs ("  ", m_fpOutput);
+}
+
+int JsonWriter::BeginItem (const char *pszKey, int KeyLen)
+{
+    /* Writes separator, indent and key. Keys are required for object members only */
+
+    if (m_Error)
+        return m_Error;
+
+    if (0 == m_Depth)
+    {
+        if (m_Items[0])
+        {
+            fprintf (stderr, "\nError: JSON writer: Only one root value allowed\n\n");
+            return m_Error = 1;
+        }
+
+        m_Items[0]++;
+        return 0;
+    }
+
+    if ( (JSON_TYPE_OBJECT == m_Type[m_Depth]) && (NULL == pszKey) )
+    {
+        fprintf (stderr, "\nError: JSON writer: Object member without key\n\n");
+        return m_Error = 1;
+    }
+
+    if (m_Items[m_Depth])
+        putc (',', m_fpOutput);
+
+    m_Items[m_Depth]++;
+    Indent();
+
+    if (JSON_TYPE_OBJECT == m_Type[m_Depth])
+    {
+        JsonWriteStringLen (pszKey, (KeyLen < 0) ? (int) strlen (pszKey) : KeyLen, m_fpOutput);
+        fputs (": ", m_fpOutput);
+    }
+
+    return 0;
+}
+
+int JsonWriter::BeginObject (const char *pszKey, int KeyLen)
+{
+    if (BeginItem (pszKey, KeyLen))
+        return m_Error;
+
+    if (m_Depth >= JSON_MAX_DEPTH)
+    {
+        fprintf (stderr, "\nError: JSON writer: Maximum nesting level exceeded\n\n");
+        return m_Error = 1;
+    }
+
+    putc ('{', m_fpOutput);
+
+    m_Depth++;
+    m_Type[m_Depth]  = JSON_TYPE_OBJECT;
+    m_Items[m_Depth] = 0;
+
+    return 0;
+}
+
+int JsonWriter::BeginArray (const char *pszKey, int KeyLen)
+{
+    if (BeginItem (pszKey, KeyLen))
+        return m_Error;
+
+    if (m_Depth >= JSON_MAX_DEPTH)
+    {
+        fprintf (stderr, "\nError: JSON writer: Maximum nesting level exceeded\n\n");
+        return m_Error = 1;
+    }
+
+    putc ('[', m_fpOutput);
+
+    m_Depth++;
+    m_Type[m_Depth]  = JSON_TYPE_ARRAY;
+    m_Items[m_Depth] = 0;
+
+    return 0;
+}
+
+int JsonWriter::EndLevel (int Type)
+{
+    int Items = 0;
+
+    if (m_Error)
+        return m_Error;
+
+    if ( (0 == m_Depth) || (Type != m_Type[m_Depth]) )
+    {
+        fprintf (stderr, "\nError: JSON writer: Unbalanced end of object/array\n\n");
+        return m_Error = 1;
+    }
+
+    Items = m_Items[m_Depth];
+    m_Depth--;
+
+    if (Items)
+        Indent();
+
+    putc ( (JSON_TYPE_OBJECT == Type) ? '}' : ']', m_fpOutput);
+
+    return 0;
+}
+
+int JsonWriter::EndObject()
+{
+    return EndLevel (JSON_TYPE_OBJECT);
+}
+
+int JsonWriter::EndArray()
+{
+    return EndLevel (JSON_TYPE_ARRAY);
+}
+
+int JsonWriter::String (const char *pszKey, int KeyLen, const char *pszValue)
+{
+    if (BeginItem (pszKey, KeyLen))
+        return m_Error;
+
+    JsonWriteString (pszValue, m_fpOutput);
+    return 0;
+}
+
+int JsonWriter::Scalar (const char *pszKey, int KeyLen, const char *pszValue)
+{
+    /* Numbers and literals are written unquoted, anything else is written as string */
+
+    if (!JsonIsScalar (pszValue))
+        return String (pszKey, KeyLen, pszValue);
+
+    if (BeginItem (pszKey, KeyLen))
+        return m_Error;
+
+    fputs (pszValue, m_fpOutput);
+    return 0;
+}
+
+int JsonWriter::Finish()
+{
+    /* Closes all open levels */
+
+    while ( (0 == m_Error) && (m_Depth > 0) )
+        EndLevel (m_Type[m_Depth]);
+
+    if (0 == m_Error)
+        putc ('\n', m_fpOutput);
+
+    return m_Error;
+}
+
+
+JsonPatch::JsonPatch()
+{
+    m_pAssignments = NULL;
+    m_Count        = 0;
+    m_CountMax     = 0;
+}
+
+JsonPatch::~JsonPatch()
+{
+    if (m_pAssignments)
+    {
+        free (m_pAssignments);
+        m_pAssignments = NULL;
+    }
+
+    m_Count    = 0;
+    m_CountMax = 0;
+}
+
+int JsonPatch::AddAssignment (const char *pszAssignment)
+{
+    /* Format: <JSON pointer>=<value> or <JSON pointer>:=<raw JSON value> */
+
+    int  len    = 0;
+    int  offset = 0;
+    const char *pEqual   = NULL;
+    const char *p        = NULL;
+    JSON_ASSIGNMENT *pNew = NULL;
+    JSON_ASSIGNMENT *pAssignment = NULL;
+
+    if (IsNullStr (pszAssignment))
+        return 1;
+
+    if ('/' != *pszAssignment)
+    {
+        fprintf (stderr, "\nError: JSON pointer must start with '/': [%s]\n\n", pszAssignment);
+        return 1;
+    }
+
+    pEqual = strstr (pszAssignment, "=");
+
+    if (NULL == pEqual)
+    {
+        fprintf (stderr, "\nError: Invalid assignment: [%s] (expected <pointer>=<value>)\n\n", pszAssignment);
+        return 1;
+    }
+
+    if (m_Count >= m_CountMax)
+    {
+        m_CountMax += INCREASE_ARRAY_ELEMENTS;
+
+        pNew = (JSON_ASSIGNMENT *) realloc (m_pAssignments, m_CountMax * sizeof (JSON_ASSIGNMENT));
+
+        if (NULL == pNew)
+        {
+            fprintf (stderr, "\nError: Cannot re-allocate assignment array (%d)\n\n", m_CountMax);
+            return 2;
+        }
+
+        m_pAssignments = pNew;
+    }
+
+    pAssignment = &m_pAssignments[m_Count];
+    memset (pAssignment, 0, sizeof (JSON_ASSIGNMENT));
+
+    len = (int) (pEqual - pszAssignment);
+
+    if ( (len > 1) && (':' == *(pEqual-1)) )
+    {
+        pAssignment->Raw = 1;
+        len--;
+    }
+
+    if (len >= (int) sizeof (pAssignment->szPointer))
+    {
+        fprintf (stderr, "\nError: JSON pointer too long: [%s]\n\n", pszAssignment);
+        return 1;
+    }
+
+    memcpy (pAssignment->szPointer, pszAssignment, len);
+    pAssignment->szPointer[len] = '\0';
+    strdncpy (pAssignment->szValue, pEqual+1, sizeof (pAssignment->szValue));
+
+    /* Split pointer into unescaped segments (RFC 6901: ~1 = '/', ~0 = '~') */
+    p = pAssignment->szPointer;
+
+    while ('/' == *p)
+    {
+        if (pAssignment->Segments >= JSON_MAX_DEPTH)
+        {
+            fprintf (stderr, "\nError: JSON pointer too deep: [%s]\n\n", pAssignment->szPointer);
+            return 1;
+        }
+
+        p++;
+        pAssignment->SegmentOffset[pAssignment->Segments] = offset;
+        pAssignment->SegmentIndex[pAssignment->Segments]  = IS_DIGIT (*p) ? 0 : -1;
+
+        while ( (*p) && ('/' != *p) )
+        {
+            if ( ('~' == *p) && ('1' == *(p+1)) )
+            {
+                pAssignment->szSegments[offset++] = '/';
+                p++;
+            }
+            else if ( ('~' == *p) && ('0' == *(p+1)) )
+            {
+                pAssignment->szSegments[offset++] = '~';
+                p++;
+            }
+            else
+            {
+                pAssignment->szSegments[offset++] = *p;
+            }
+
+            if (pAssignment->SegmentIndex[pAssignment->Segments] >= 0)
+            {
+                if (IS_DIGIT (*p))
+                    pAssignment->SegmentIndex[pAssignment->Segments] = pAssignment->SegmentIndex[pAssignment->Segments] * 10 + (*p - '0');
+                else
+                    pAssignment->SegmentIndex[pAssignment->Segments] = -1;
+            }
+
+            p++;
+        }
+
+        pAssignment->szSegments[offset++] = '\0';
+        pAssignment->Segments++;
+    }
+
+    m_Count++;
+    return 0;
+}
+
+int JsonPatch::ReadAssignments (const char *pszFileName)
+{
+    int  error = 0;
+    FILE *fp   = NULL;
+    char *p    = NULL;
+    char szBuffer[MAX_BUFFER+JSON_MAX_POINTER] = {0};
+
+    fp = fopen (pszFileName, "r");
+
+    if (NULL == fp)
+    {
+        fprintf (stderr, "\nError: Cannot open assignment file: [%s]\n\n", pszFileName);
+        return 1;
+    }
+
+    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    {
+        p = szBuffer;
+
+        while (*p)
+        {
+            if ((unsigned char) *p < 32)
+                *p = '\0';
+            p++;
+        }
+
+        /* Skip empty lines and comments */
+        if ( ('\0' == *szBuffer) || ('#' == *szBuffer) )
+            continue;
+
+        error = AddAssignment (szBuffer);
+
+        if (error)
+            break;
+    }
+
+    fclose (fp);
+    fp = NULL;
+
+    return error;
+}
+
+JSON_ASSIGNMENT *JsonPatch::FindAssignment (int Depth)
+{
+    int i = 0;
+    int Level = 0;
+    const JSON_LEVEL *pLevel = NULL;
+    JSON_ASSIGNMENT  *pAssignment = NULL;
+
+    for (i=0; i<m_Count; i++)
+    {
+        pAssignment = &m_pAssignments[i];
+
+        if (pAssignment->Segments != Depth)
+            continue;
+
+        for (Level=0; Level<Depth; Level++)
+        {
+            pLevel = m_Scanner.GetLevel (Level);
+
+            if (JSON_TYPE_ARRAY == pLevel->Type)
+            {
+                if (pAssignment->SegmentIndex[Level] != pLevel->Index)
+                    break;
+            }
+            else if (strcmp (pAssignment->szSegments + pAssignment->SegmentOffset[Level], pLevel->szKey))
+            {
+                break;
+            }
+        }
+
+        if (Level == Depth)
+            return pAssignment;
+    }
+
+    return NULL;
+}
+
+void JsonPatch::WriteValue (JSON_ASSIGNMENT *pAssignment, int OrigType, FILE *fpOutput)
+{
+    /* Keep the type of the original value unless a raw JSON value is specified */
+
+    pAssignment->Applied++;
+
+    if (pAssignment->Raw)
+    {
+        fputs (pAssignment->szValue, fpOutput);
+    }
+    else if ( ( (JSON_TYPE_NUMBER == OrigType) || (JSON_TYPE_LITERAL == OrigType) ) && JsonIsScalar (pAssignment->szValue) )
+    {
+        fputs (pAssignment->szValue, fpOutput);
+    }
+    else
+    {
+        JsonWriteString (pAssignment->szValue, fpOutput);
+    }
+}
+
+int JsonPatch::Apply (FILE *fpInput, FILE *fpOutput)
+{
+    int  error     = 0;
+    int  c         = 0;
+    int  i         = 0;
+    int  Events    = 0;
+    int  Depth     = 0;
+    int  SkipDepth = 0;
+    int  OrigType  = JSON_TYPE_NONE;
+
+    JSON_ASSIGNMENT *pSkip = NULL;
+
+    m_Scanner.Reset();
+
+    while (EOF != (c = getc (fpInput)))
+    {
+        Depth  = m_Scanner.GetDepth();
+        Events = m_Scanner.Feed (c);
+
+        if (JSON_EVENT_ERROR & Events)
+            break;
+
+        if (pSkip)
+        {
+            /* Number or literal ends before the current character, which is written as usual */
+            if ( (JSON_EVENT_SCALAR_END & Events) && (Depth == SkipDepth) )
+            {
+                WriteValue (pSkip, OrigType, fpOutput);
+                pSkip = NULL;
+            }
+
+            /* String, object or array ends with the current character */
+            else if ( (JSON_EVENT_VALUE_END & Events) && (m_Scanner.GetDepth() == SkipDepth) )
+            {
+                WriteValue (pSkip, OrigType, fpOutput);
+                pSkip = NULL;
+                continue;
+            }
+
+            else
+            {
+                continue;
+            }
+        }
+
+        if (JSON_EVENT_VALUE_BEGIN & Events)
+        {
+            pSkip = FindAssignment (Depth);
+
+            if (pSkip)
+            {
+                SkipDepth = Depth;
+                OrigType  = m_Scanner.GetValueType();
+                continue;
+            }
+        }
+
+        putc (c, fpOutput);
+    }
+
+    Events = m_Scanner.Finish();
+
+    if ( (pSkip) && (JSON_EVENT_SCALAR_END & Events) )
+    {
+        WriteValue (pSkip, OrigType, fpOutput);
+        pSkip = NULL;
+    }
+
+    if (JSON_EVENT_ERROR & Events)
+    {
+        fprintf (stderr, "\nError: Invalid JSON at line %ld column %ld: %s\n\n", m_Scanner.GetLine(), m_Scanner.GetColumn(), m_Scanner.GetError());
+        error = 4;
+        goto Done;
+    }
+
+    for (i=0; i<m_Count; i++)
+    {
+        if (0 == m_pAssignments[i].Applied)
+        {
+            fprintf (stderr, "Error: JSON pointer not found: [%s]\n", m_pAssignments[i].szPointer);
+            error = 3;
+        }
+    }
+
+Done:
+
+    return error;
+}
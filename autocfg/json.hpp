@@ -0,0 +1,205 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef JSON_HPP
+    #define JSON_HPP
+
+#include <stdio.h>
+
+#include "cfg.hpp"
+
+#define JSON_MAX_DEPTH          64
+#define JSON_MAX_POINTER        1024
+
+/* Events returned by JsonScanner::Feed() for the current character */
+#define JSON_EVENT_VALUE_BEGIN  0x01  /* Character starts a value */
+#define JSON_EVENT_VALUE_END    0x02  /* Character ends a string, object or array value */
+#define JSON_EVENT_SCALAR_END   0x04  /* Number or literal ended before the character */
+#define JSON_EVENT_ERROR        0x80
+
+#define JSON_TYPE_NONE          0
+#define JSON_TYPE_OBJECT        1
+#define JSON_TYPE_ARRAY         2
+#define JSON_TYPE_STRING        3
+#define JSON_TYPE_NUMBER        4
+#define JSON_TYPE_LITERAL       5
+
+typedef struct {
+    int  Type;
+    int  Index;
+    int  KeyLen;
+    char szKey[MAX_ENTRY_LEN+1];
+} JSON_LEVEL;
+
+
+/* Streaming JSON scanner: Fed one character at a time, no document is built.
+   Memory is fixed and only depends on the maximum nesting level */
+
+class JsonScanner
+{
+
+public:
+
+    JsonScanner();
+
+    void Reset();
+    int  Feed   (int c);
+    int  Finish ();
+
+    int  GetDepth()
+    {
+        return m_Depth;
+    }
+
+    const JSON_LEVEL *GetLevel (int Level)
+    {
+        return ( (Level >= 0) && (Level < m_Depth) ) ? &m_Stack[Level] : NULL;
+    }
+
+    int  GetValueType()
+    {
+        return m_ValueType;
+    }
+
+    long GetLine()
+    {
+        return m_Line;
+    }
+
+    long GetColumn()
+    {
+        return m_Column;
+    }
+
+    const char *GetError()
+    {
+        return m_szError;
+    }
+
+private:
+
+    int  BeginValue  (int c);
+    int  EndValue    (int Events);
+    int  FeedScalar  (int c);
+    int  SetError    (const char *pszError);
+
+    JSON_LEVEL m_Stack[JSON_MAX_DEPTH];
+
+    int  m_Depth;
+    int  m_State;
+    int  m_ValueType;
+    int  m_StringIsKey;
+    int  m_HexDigits;
+    int  m_ScalarState;
+    const char *m_pLiteral;
+
+    long m_Line;
+    long m_Column;
+    char m_szError[MAX_ENTRY_LEN+1];
+};
+
+
+typedef struct {
+    char szPointer[JSON_MAX_POINTER];
+    char szValue[MAX_BUFFER];
+    char szSegments[JSON_MAX_POINTER];
+    int  SegmentOffset[JSON_MAX_DEPTH];
+    int  SegmentIndex[JSON_MAX_DEPTH];
+    int  Segments;
+    int  Raw;
+    int  Applied;
+} JSON_ASSIGNMENT;
+
+
+/* Applies JSON pointer assignments to an existing JSON file.
+   Only targeted values are replaced, all other bytes are copied unchanged */
+
+class JsonPatch
+{
+
+public:
+
+    JsonPatch();
+    ~JsonPatch();
+
+    int  AddAssignment   (const char *pszAssignment);
+    int  ReadAssignments (const char *pszFileName);
+    int  Apply           (FILE *fpInput, FILE *fpOutput);
+
+    int  HasAssignments()
+    {
+        return (m_Count > 0);
+    }
+
+private:
+
+    JSON_ASSIGNMENT *FindAssignment (int Depth);
+    void WriteValue (JSON_ASSIGNMENT *pAssignment, int OrigType, FILE *fpOutput);
+
+    JsonScanner m_Scanner;
+
+    JSON_ASSIGNMENT *m_pAssignments;
+    int m_Count;
+    int m_CountMax;
+};
+
+
+/* Streaming JSON writer: Structure and escaping is handled by the writer.
+   Output is written directly to the stream without per value allocations */
+
+class JsonWriter
+{
+
+public:
+
+    JsonWriter (FILE *fpOutput);
+
+    int  BeginObject (const char *pszKey, int KeyLen);
+    int  EndObject   ();
+    int  BeginArray  (const char *pszKey, int KeyLen);
+    int  EndArray    ();
+    int  String      (const char *pszKey, int KeyLen, const char *pszValue);
+    int  Scalar      (const char *pszKey, int KeyLen, const char *pszValue);
+    int  Finish      ();
+
+    int  GetDepth()
+    {
+        return m_Depth;
+    }
+
+private:
+
+    int  BeginItem   (const char *pszKey, int KeyLen);
+    int  EndLevel    (int Type);
+    void Indent      ();
+
+    FILE *m_fpOutput;
+    int  m_Depth;
+    int  m_Error;
+    int  m_Type[JSON_MAX_DEPTH+1];
+    int  m_Items[JSON_MAX_DEPTH+1];
+};
+
+
+int  JsonIsScalar       (const char *pszValue);
+void JsonWriteString    (const char *pszValue, FILE *fpOutput);
+void JsonWriteStringLen (const char *pszValue, int len, FILE *fpOutput);
+
+#endif
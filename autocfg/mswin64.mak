@@ -20,8 +20,10 @@ NODEBUG=1
 
 # Link command
 
-autocfg.exe: autocfg.obj cfg.obj
-	link /SUBSYSTEM:CONSOLE autocfg.obj cfg.obj msvcrt.lib /PDB:$*.pdb /DEBUG /PDBSTRIPPED:$*_small.pdb /NODEFAULTLIB:LIBCMT -out:$@
+OBJS=autocfg.obj cfg.obj resolver.obj json.obj otsgen.obj tplcache.obj daemon.obj parallel.obj textin.obj
+
+autocfg.exe: $(OBJS)
+	link /SUBSYSTEM:CONSOLE $(OBJS) msvcrt.lib msvcprt.lib /PDB:$*.pdb /DEBUG /PDBSTRIPPED:$*_small.pdb /NODEFAULTLIB:LIBCMT -out:$@
 	del $*.pdb $*.sym
 	rename $*_small.pdb $*.pdb
 
@@ -31,6 +33,27 @@ autocfg.exe: autocfg.obj cfg.obj
 cfg.obj: cfg.cpp
 	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  cfg.cpp
 
+resolver.obj: resolver.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  resolver.cpp
+
+json.obj: json.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  json.cpp
+
+otsgen.obj: otsgen.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  otsgen.cpp
+
+tplcache.obj: tplcache.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  tplcache.cpp
+
+daemon.obj: daemon.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  daemon.cpp
+
+parallel.obj: parallel.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  parallel.cpp
+
+textin.obj: textin.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  textin.cpp
+
 autocfg.obj: autocfg.cpp
 	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION  autocfg.cpp
 
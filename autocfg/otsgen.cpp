@@ -0,0 +1,671 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+/* Generates a OTS JSON file from SERVERSETUP_ variables without a template */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cfg.hpp"
+#include "json.hpp"
+#include "otsgen.hpp"
+
+/* Schema in document order. Entries of the same JSON object must be listed together.
+   Defaults and fixed values follow examples/ots_template.json */
+
+static const OTS_SCHEMA_ENTRY g_OtsSchema[] =
+{
+    { "SERVERSETUP_SERVER_TYPE",                   "serverSetup/server/type",                        OTS_TYPE_STRING, "first" },
+    { "SERVERSETUP_SERVER_NAME",                   "serverSetup/server/name",                        OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_SERVER_DOMAINNAME",             "serverSetup/server/domainName",                  OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_SERVER_TITLE",                  "serverSetup/server/title",                       OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_SERVER_PASSWORD",               "serverSetup/server/password",                    OTS_TYPE_NULL,   NULL },
+    { "SERVERSETUP_SERVER_MINPASSWORDLENGTH",      "serverSetup/server/minPasswordLength",           OTS_TYPE_NUMBER, "0" },
+    { "SERVERSETUP_SERVER_SERVERTASKS",            "serverSetup/server/serverTasks",                 OTS_TYPE_STRING, "replica,router,update,amgr,adminp,http,certmgr,nomad" },
+
+    { "SERVERSETUP_NETWORK_HOSTNAME",              "serverSetup/network/hostName",                   OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_NETWORK_ENABLEPORTENCRYPTION",  "serverSetup/network/enablePortEncryption",       OTS_TYPE_BOOL,   "true" },
+    { "SERVERSETUP_NETWORK_ENABLEPORTCOMPRESSION", "serverSetup/network/enablePortCompression",      OTS_TYPE_BOOL,   "true" },
+
+    { "SERVERSETUP_ORG_ORGNAME",                   "serverSetup/org/orgName",                        OTS_TYPE_STRING, NULL },
+    { NULL,                                        "serverSetup/org/certifierPassword",              OTS_TYPE_STRING, "{{ SERVERSETUP_ORG_CERTIFIERPASSWORD }}{{ SECRET_KEY1 }}" },
+
+    { "SERVERSETUP_ADMIN_FIRSTNAME",               "serverSetup/admin/firstName",                    OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_ADMIN_LASTNAME",                "serverSetup/admin/lastName",                     OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_ADMIN_PASSWORD",                "serverSetup/admin/password",                     OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_ADMIN_IDFILEPATH",              "serverSetup/admin/IDFilePath",                   OTS_TYPE_STRING, NULL },
+
+    { "SERVERSETUP_NOTESINI_CREATE_R12_DATABASES",               "serverSetup/notesINI/Create_R12_databases",               OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_CREATE_R85_LOG",                     "serverSetup/notesINI/Create_R85_log",                     OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_LOG_REPLICATION",                    "serverSetup/notesINI/LOG_REPLICATION",                    OTS_TYPE_STRING, "0" },
+    { "SERVERSETUP_NOTESINI_LOG_SESSIONS",                       "serverSetup/notesINI/LOG_SESSIONS",                       OTS_TYPE_STRING, "0" },
+    { "SERVERSETUP_NOTESINI_HTTPPUBLICURLS",                     "serverSetup/notesINI/HTTPPublicURLs",                     OTS_TYPE_STRING, "/iwaredir.nsf/*:/.well-known*" },
+    { "SERVERSETUP_NOTESINI_ENABLE_SNI",                         "serverSetup/notesINI/ENABLE_SNI",                         OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_HTTPENABLEMETHODS",                  "serverSetup/notesINI/HTTPEnableMethods",                  OTS_TYPE_STRING, "GET,POST,PUT,DELETE,HEAD" },
+    { "SERVERSETUP_NOTESINI_ADMIN_CLIENT_SKIP_DOMINO",           "serverSetup/notesINI/ADMIN_CLIENT_SKIP_DOMINO",           OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_COMPRESS_LZ1_CREATE",                "serverSetup/notesINI/COMPRESS_LZ1_CREATE",                OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_CREATE_NIFNSF_DATABASES",            "serverSetup/notesINI/CREATE_NIFNSF_DATABASES",            OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_NIFNSFENABLE",                       "serverSetup/notesINI/NIFNSFENABLE",                       OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_NIFBASEPATH",                        "serverSetup/notesINI/NIFBasePath",                        OTS_TYPE_STRING, "/local/nif" },
+    { "SERVERSETUP_NOTESINI_FTBASEPATH",                         "serverSetup/notesINI/FTBASEPATH",                         OTS_TYPE_STRING, "/local/ft" },
+    { "SERVERSETUP_NOTESINI_DAOS_ENCRYPT_NLO",                   "serverSetup/notesINI/DAOS_ENCRYPT_NLO",                   OTS_TYPE_STRING, "0" },
+    { "SERVERSETUP_NOTESINI_DAOS_MAX_FILES_PER_SUBCONTAINER",    "serverSetup/notesINI/DAOS_MAX_FILES_PER_SUBCONTAINER",    OTS_TYPE_STRING, "10000" },
+    { "SERVERSETUP_NOTESINI_EVENT_POOL_SIZE",                    "serverSetup/notesINI/EVENT_POOL_SIZE",                    OTS_TYPE_STRING, "41943040" },
+    { "SERVERSETUP_NOTESINI_SETUPLEAVESERVERTASKS",              "serverSetup/notesINI/SETUPLEAVESERVERTASKS",              OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_SSL_DISABLE_EXTENDED_MASTER_SECRET", "serverSetup/notesINI/SSL_DISABLE_EXTENDED_MASTER_SECRET", OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_SERVER_MINPOSSIBLETRANSTIME",        "serverSetup/notesINI/Server_MinPossibleTransTime",        OTS_TYPE_STRING, "1500" },
+    { "SERVERSETUP_NOTESINI_SERVER_MAXPOSSIBLETRANSTIME",        "serverSetup/notesINI/Server_MaxPossibleTransTime",        OTS_TYPE_STRING, "20000000" },
+    { "SERVERSETUP_NOTESINI_NSF_BUFFER_POOL_SIZE_MB",            "serverSetup/notesINI/NSF_BUFFER_POOL_SIZE_MB",            OTS_TYPE_STRING, "256" },
+    { "SERVERSETUP_NOTESINI_FT_FLY_INDEX_OFF",                   "serverSetup/notesINI/FT_FLY_INDEX_OFF",                   OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_UPDATE_FULLTEXT_THREAD",             "serverSetup/notesINI/UPDATE_FULLTEXT_THREAD",             OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_FTG_USE_SYS_MEMORY",                 "serverSetup/notesINI/FTG_USE_SYS_MEMORY",                 OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_CERTMGR_ACCEPT_TOU",                 "serverSetup/notesINI/CertMgr_ACCEPT_TOU",                 OTS_TYPE_STRING, "1" },
+    { "SERVERSETUP_NOTESINI_CERTMGR_INTERVAL",                   "serverSetup/notesINI/CERTMGR_INTERVAL",                   OTS_TYPE_STRING, "2" },
+    { "SERVERSETUP_NOTESINI_NOMAD_WEB_HOST",                     "serverSetup/notesINI/NOMAD_WEB_HOST",                     OTS_TYPE_STRING, "{{ SERVERSETUP_NETWORK_HOSTNAME }}" },
+    { "SERVERSETUP_NOTESINI_*",                                  "serverSetup/notesINI/*",                                  OTS_TYPE_STRING, NULL },
+
+    { "SERVERSETUP_SECURITY_ACL_PROHIBITANONYMOUSACCESS", "serverSetup/security/ACL/prohibitAnonymousAccess", OTS_TYPE_BOOL,   "true" },
+    { "SERVERSETUP_SECURITY_ACL_ADDLOCALDOMAINADMINS",    "serverSetup/security/ACL/addLocalDomainAdmins",    OTS_TYPE_BOOL,   "true" },
+    { "SERVERSETUP_SECURITY_TLSSETUP_METHOD",             "serverSetup/security/TLSSetup/method",             OTS_TYPE_STRING, "dominoMicroCA" },
+
+    { "SERVERSETUP_AUTOREGISTER_COUNT",                   "serverSetup/autoRegister/count",                   OTS_TYPE_NUMBER, "4" },
+    { "SERVERSETUP_AUTOREGISTER_IDPATH",                  "serverSetup/autoRegister/IDPath",                  OTS_TYPE_STRING, "/local/notesdata" },
+    { "SERVERSETUP_AUTOREGISTER_PATTERN",                 "serverSetup/autoRegister/pattern",                 OTS_TYPE_STRING, "domino#" },
+
+    { "SERVERSETUP_REGISTERUSERS_SAVEIDTOPERSONDOCUMENT",      "serverSetup/registerUsers/defaults/saveIDToPersonDocument",      OTS_TYPE_BOOL,   "false" },
+    { "SERVERSETUP_REGISTERUSERS_MAILTEMPLATEPATH",            "serverSetup/registerUsers/defaults/mailTemplatePath",            OTS_TYPE_STRING, "mail14.ntf" },
+    { "SERVERSETUP_REGISTERUSERS_PASSWORD",                    "serverSetup/registerUsers/defaults/password",                    OTS_TYPE_STRING, "default-super-secret-user-password" },
+    { "SERVERSETUP_REGISTERUSERS_ENABLEFULLTEXTINDEX",         "serverSetup/registerUsers/defaults/enableFullTextIndex",         OTS_TYPE_BOOL,   "true" },
+    { "SERVERSETUP_REGISTERUSERS_CERTIFICATEEXPIRATIONMONTHS", "serverSetup/registerUsers/defaults/certificateExpirationMonths", OTS_TYPE_NUMBER, "42" },
+
+    { "SERVERSETUP_1ST_USER_FIRSTNAME",               "serverSetup/registerUsers/users[]/firstName",              OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_1ST_USER_LASTNAME",                "serverSetup/registerUsers/users[]/lastName",               OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_1ST_USER_SHORTNAME",               "serverSetup/registerUsers/users[]/shortName",              OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_1ST_USER_SAVEIDTOPERSONDOCUMENT",  "serverSetup/registerUsers/users[]/saveIDToPersonDocument", OTS_TYPE_BOOL,   "false" },
+    { "SERVERSETUP_1ST_USER_INTERNET_ADDRESS",        "serverSetup/registerUsers/users[]/internetAddress",        OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_1ST_USER_IDFILEPATH",              "serverSetup/registerUsers/users[]/IDFilePath",             OTS_TYPE_STRING, "{{ SERVERSETUP_1ST_USER_SHORTNAME }}.id" },
+    { "SERVERSETUP_1ST_USER_PASSSWORD",               "serverSetup/registerUsers/users[]/password",               OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_1ST_USER_MAILFILEPATH",            "serverSetup/registerUsers/users[]/mailFilePath",           OTS_TYPE_STRING, "mail/{{ SERVERSETUP_1ST_USER_SHORTNAME }}.nsf" },
+
+    { "SERVERSETUP_AUTOCONFIG_STARTSERVERAFTERCONFIGURATION", "autoConfigPreferences/startServerAfterConfiguration", OTS_TYPE_BOOL, "true" },
+
+    { "SERVERSETUP_IDVAULT_NAME",                     "IDVault/name",                                   OTS_TYPE_STRING, "O={{ SERVERSETUP_ORG_ORGNAME }}_vault" },
+    { "SERVERSETUP_IDVAULT_DESCRIPTION",              "IDVault/description",                            OTS_TYPE_STRING, "{{ SERVERSETUP_ORG_ORGNAME }} Vault" },
+    { "SERVERSETUP_IDVAULT_IDFILE",                   "IDVault/IDFile",                                 OTS_TYPE_STRING, "vault.id" },
+    { "SERVERSETUP_IDVAULT_IDPASSWORD",               "IDVault/IDPassword",                             OTS_TYPE_STRING, NULL },
+    { "SERVERSETUP_IDVAULT_PATH",                     "IDVault/path",                                   OTS_TYPE_STRING, "IBM_ID_VAULT/{{ SERVERSETUP_ORG_ORGNAME }}_vault.nsf" },
+    { "SERVERSETUP_IDVAULT_PASSWORDRESET_HELPTEXT",   "IDVault/passwordReset/helpText",                 OTS_TYPE_STRING, "See Roy or Moss for a password reset. Good luck!" },
+    { "SERVERSETUP_IDVAULT_POLICY_NAME",              "IDVault/securitySettingsPolicy/name",            OTS_TYPE_STRING, "{{ SERVERSETUP_ORG_ORGNAME }} Vault Security Settings Policy" },
+    { "SERVERSETUP_IDVAULT_POLICY_DESCRIPTION",       "IDVault/securitySettingsPolicy/description",     OTS_TYPE_STRING, "{{ SERVERSETUP_ORG_ORGNAME }} Vault Security Settings" },
+    { "SERVERSETUP_IDVAULT_MASTERPOLICY_DESCRIPTION", "IDVault/masterPolicy/description",               OTS_TYPE_STRING, "{{ SERVERSETUP_ORG_ORGNAME }} Vault Master Policy Description" },
+
+    { NULL, "appConfiguration/databases[0]/filePath",                                            OTS_TYPE_STRING, "names.nsf" },
+    { NULL, "appConfiguration/databases[0]/action",                                              OTS_TYPE_STRING, "update" },
+
+    { NULL, "appConfiguration/databases[0]/documents[0]/action",                                 OTS_TYPE_STRING, "update" },
+
+    { NULL, "appConfiguration/databases[0]/documents[0]/findDocument/Type",                      OTS_TYPE_STRING, "Server" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/findDocument/ServerName",                OTS_TYPE_STRING, "CN={{ SERVERSETUP_SERVER_NAME }}/O={{ SERVERSETUP_ORG_ORGNAME }}" },
+
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_SSLKeyFile",                  OTS_TYPE_STRING, "{{ SERVERSETUP_NETWORK_HOSTNAME }}" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/TRANSLOG_AutoFixup",               OTS_TYPE_STRING, "" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/TRANSLOG_MaxSize",                 OTS_TYPE_NUMBER, "1024" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/TRANSLOG_Path",                    OTS_TYPE_STRING, "/local/translog" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/TRANSLOG_Performance",             OTS_TYPE_STRING, "2" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/TRANSLOG_Status",                  OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/TRANSLOG_Style",                   OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/TRANSLOG_UseAll",                  OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/QtaMthd",                          OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/DAOSEnable",                       OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/DAOSBasePath",                     OTS_TYPE_STRING, "/local/daos" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/DAOSMinObjSize",                   OTS_TYPE_STRING, "256000" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/DAOS_ENCRYPT_NLO",                 OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_HomeURL",                     OTS_TYPE_STRING, "homepage.nsf" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/FullAdmin",                        OTS_TYPE_STRING, "LocalDomainAdmins" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/CreateAccess",                     OTS_TYPE_STRING, "LocalDomainAdmins" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/ReplicaAccess",                    OTS_TYPE_STRING, "LocalDomainAdmins" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/UnrestrictedList",                 OTS_TYPE_STRING, "LocalDomainAdmins" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/OnBehalfOfLst",                    OTS_TYPE_STRING, "LocalDomainAdmins" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/RestrictedList",                   OTS_TYPE_STRING, "LocalDomainAdmins" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_EnableSessionAuth",           OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_TCPNP",                       OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_AllowAnonymous",              OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_NormalMode",                  OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_SSLMode",                     OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/HTTP_SSLAnonymous",                OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/NSDEnbld",                         OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/FREnbld",                          OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/FltRcvryNot",                      OTS_TYPE_STRING, "LocalDomainAdmins" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/ServerBuildNumber",                OTS_TYPE_STRING, "12.0.1" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/MajVer",                           OTS_TYPE_NUMBER, "12" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/SSLCipherList",                    OTS_TYPE_LIST,   "C030,9F,C02F,9E,C028,6B,C027,67" },
+    { NULL, "appConfiguration/databases[0]/documents[0]/items/SSLCipherSupportedList",           OTS_TYPE_LIST,   "C030,9F,C02F,9E,C028,6B,C027,67" },
+
+    { NULL, "appConfiguration/databases[0]/documents[1]/action",                                 OTS_TYPE_STRING, "create" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/computeWithForm",                        OTS_TYPE_BOOL,   "true" },
+
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/Form",                             OTS_TYPE_STRING, "ServerConfig" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/UseAsDefault",                     OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ServerName",                       OTS_TYPE_STRING, "*" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILEnforce",                        OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILLockIP",                         OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILCountAgainstIP",                 OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILLogLockouts",                    OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILLogFailures",                    OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILMaxTries",                       OTS_TYPE_NUMBER, "7" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILExpMinutes",                     OTS_TYPE_NUMBER, "10" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILExpNum",                         OTS_TYPE_NUMBER, "10" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILTimeFormat",                     OTS_TYPE_STRING, ",minutes" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILClearNum",                       OTS_TYPE_NUMBER, "10" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILClearMinutes",                   OTS_TYPE_NUMBER, "10" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/ILTimeFormat2",                    OTS_TYPE_STRING, ",minutes" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/PwdCheckInVault",                  OTS_TYPE_STRING, "2" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/DCLoc",                            OTS_TYPE_STRING, "CN=HCL Notes/O=Domino Fault Reports" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/DCMsgSize",                        OTS_TYPE_NUMBER, "50" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/DCNSDSize",                        OTS_TYPE_NUMBER, "40" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/DCDO",                             OTS_TYPE_NUMBER, "10000" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/FAEnabled",                        OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[0]/documents[1]/items/FADBs",                            OTS_TYPE_STRING, "1" },
+
+    { NULL, "appConfiguration/databases[1]/action",                                              OTS_TYPE_STRING, "create" },
+    { NULL, "appConfiguration/databases[1]/filePath",                                            OTS_TYPE_STRING, "domcfg.nsf" },
+    { NULL, "appConfiguration/databases[1]/title",                                               OTS_TYPE_STRING, "Domino Web Server Configuration" },
+    { NULL, "appConfiguration/databases[1]/templatePath",                                        OTS_TYPE_STRING, "domcfg5.ntf" },
+    { NULL, "appConfiguration/databases[1]/signUsingAdminp",                                     OTS_TYPE_BOOL,   "true" },
+
+    { NULL, "appConfiguration/databases[1]/documents[0]/action",                                 OTS_TYPE_STRING, "create" },
+
+    { NULL, "appConfiguration/databases[1]/documents[0]/items/Form",                             OTS_TYPE_STRING, "LoginMap" },
+    { NULL, "appConfiguration/databases[1]/documents[0]/items/LF_LoginForm",                     OTS_TYPE_STRING, "DWALoginForm" },
+    { NULL, "appConfiguration/databases[1]/documents[0]/items/LF_LoginFormDB",                   OTS_TYPE_STRING, "iwaredir.nsf" },
+    { NULL, "appConfiguration/databases[1]/documents[0]/items/LF_ServerType",                    OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[1]/documents[0]/items/LF_IP",                            OTS_TYPE_STRING, "" },
+    { NULL, "appConfiguration/databases[1]/documents[0]/items/$PublicAccess",                    OTS_TYPE_STRING, "1" },
+
+    { NULL, "appConfiguration/databases[2]/action",                                              OTS_TYPE_STRING, "create" },
+    { NULL, "appConfiguration/databases[2]/filePath",                                            OTS_TYPE_STRING, "iwaredir.nsf" },
+    { NULL, "appConfiguration/databases[2]/title",                                               OTS_TYPE_STRING, "Redirect" },
+    { NULL, "appConfiguration/databases[2]/templatePath",                                        OTS_TYPE_STRING, "iwaredir.ntf" },
+    { NULL, "appConfiguration/databases[2]/signUsingAdminp",                                     OTS_TYPE_BOOL,   "true" },
+
+    { NULL, "appConfiguration/databases[2]/documents[0]/action",                                 OTS_TYPE_STRING, "create" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/computeWithForm",                        OTS_TYPE_BOOL,   "true" },
+
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/Form",                             OTS_TYPE_STRING, "AutoLogin" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/ServerNameSelect",                 OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/RedirectMessageWebView",           OTS_TYPE_STRING, "Redirecting..." },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/$LANGUAGE",                        OTS_TYPE_STRING, "en" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/$ServerSettingsTable",             OTS_TYPE_STRING, "Select" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/EnableUltraliteRadioButton",       OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/MobileAgentKeywords",              OTS_TYPE_STRING, "ipod,iphone,android,ipad" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/SSLPort",                          OTS_TYPE_STRING, "443" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/RedirectionTime",                  OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/RedirectionMessageText",           OTS_TYPE_STRING, "Redirecting..." },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/WMRGlobalProfileURL",              OTS_TYPE_STRING, "/" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/ServerNameChange",                 OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/ForceSSL",                         OTS_TYPE_STRING, "1" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/OmitProtocol",                     OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/UseHomeMailServer",                OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/LoginOptions",                     OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/EncryptPassword",                  OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/WebMailRedirectEnableDebug",       OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/WebMailRedirectProfileEnable",     OTS_TYPE_STRING, "0" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/WMRVersion",                       OTS_TYPE_STRING, "650" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/WMRAttachmentNames",               OTS_TYPE_STRING, "BLANK" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/MailServerDomainName",             OTS_TYPE_STRING, "" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/RevProxyServerName",               OTS_TYPE_STRING, "" },
+    { NULL, "appConfiguration/databases[2]/documents[0]/items/ForcePath",                        OTS_TYPE_STRING, "" },
+
+    { NULL, NULL, 0, NULL }
+};
+
+typedef struct {
+    OTS_SEGMENT Open[OTS_MAX_SEGMENTS];
+    int  OpenCount;
+    int  Values;
+} OTS_GEN_CONTEXT;
+
+
+static int SplitPath (const char *pszPath, OTS_SEGMENT *pSegments)
+{
+    /* Returns number of segments. Segments point into the schema string, nothing is copied */
+
+    int count = 0;
+    const char *p = pszPath;
+    const char *pBegin = pszPath;
+    const char *pBracket = NULL;
+
+    while (count < OTS_MAX_SEGMENTS)
+    {
+        if ( ('/' != *p) && ('\0' != *p) )
+        {
+            p++;
+            continue;
+        }
+
+        pSegments[count].pName   = pBegin;
+        pSegments[count].len     = (int) (p - pBegin);
+        pSegments[count].IsArray = 0;
+        pSegments[count].Index   = 0;
+
+        pBracket = (const char *) memchr (pBegin, '[', p - pBegin);
+
+        if ( (pBracket) && (pBracket > pBegin) && (']' == *(p-1)) )
+        {
+            pSegments[count].len     = (int) (pBracket - pBegin);
+            pSegments[count].IsArray = 1;
+            pSegments[count].Index   = atoi (pBracket+1);
+        }
+
+        count++;
+
+        if ('\0' == *p)
+            break;
+
+        p++;
+        pBegin = p;
+    }
+
+    return count;
+}
+
+static int CloseLevels (JsonWriter *pWriter, OTS_GEN_CONTEXT *pCtx, int Keep)
+{
+    int error = 0;
+
+    while (pCtx->OpenCount > Keep)
+    {
+        pCtx->OpenCount--;
+
+        error = pWriter->EndObject();
+
+        if ( (0 == error) && (pCtx->Open[pCtx->OpenCount].IsArray) )
+            error = pWriter->EndArray();
+
+        if (error)
+            break;
+    }
+
+    return error;
+}
+
+static int EmitList (JsonWriter *pWriter, const char *pszKey, int KeyLen, const char *pszValue)
+{
+    /* Writes a comma separated list as array of strings */
+
+    int  error = 0;
+    int  len   = 0;
+    const char *p = pszValue;
+    const char *pEnd = NULL;
+
+    char szItem[MAX_ENTRY_LEN+1] = {0};
+
+    error = pWriter->BeginArray (pszKey, KeyLen);
+
+    while ( (0 == error) && (*p) )
+    {
+        while (' ' == *p)
+            p++;
+
+        pEnd = strchr (p, ',');
+
+        if (NULL == pEnd)
+            pEnd = p + strlen (p);
+
+        len = (int) (pEnd - p);
+
+        while ( (len > 0) && (' ' == p[len-1]) )
+            len--;
+
+        snprintf (szItem, sizeof (szItem), "%.*s", len, p);
+        error = pWriter->String (NULL, 0, szItem);
+
+        p = (',' == *pEnd) ? pEnd+1 : pEnd;
+    }
+
+    if (0 == error)
+        error = pWriter->EndArray();
+
+    return error;
+}
+
+static int EmitValue (JsonWriter *pWriter, OTS_GEN_CONTEXT *pCtx, const OTS_SCHEMA_ENTRY *pEntry, const char *pszSuffix, const char *pszValue)
+{
+    /* A NULL value is written as JSON null */
+
+    int error    = 0;
+    int count    = 0;
+    int common   = 0;
+    int i        = 0;
+    int NewElement = 0;
+    const char *pszKey = NULL;
+    int KeyLen   = 0;
+
+    OTS_SEGMENT Segments[OTS_MAX_SEGMENTS];
+
+    count = SplitPath (pEntry->pszPath, Segments);
+
+    if (count < 1)
+        return 0;
+
+    /* Keep all levels shared with the previous value open */
+    while ( (common < pCtx->OpenCount) && (common < count-1) )
+    {
+        if ( (pCtx->Open[common].len != Segments[common].len) ||
+             (pCtx->Open[common].IsArray != Segments[common].IsArray) ||
+             (strncmp (pCtx->Open[common].pName, Segments[common].pName, Segments[common].len)) )
+            break;
+
+        /* Same array, but the next object */
+        if (pCtx->Open[common].Index != Segments[common].Index)
+        {
+            NewElement = 1;
+            break;
+        }
+
+        common++;
+    }
+
+    if (NewElement)
+    {
+        error = CloseLevels (pWriter, pCtx, common+1);
+
+        if (0 == error)
+            error = pWriter->EndObject();
+
+        if (0 == error)
+            error = pWriter->BeginObject (NULL, 0);
+
+        if (error)
+            return error;
+
+        pCtx->Open[common].Index = Segments[common].Index;
+        common++;
+    }
+    else
+    {
+        error = CloseLevels (pWriter, pCtx, common);
+        if (error)
+            return error;
+    }
+
+    for (i=common; i<count-1; i++)
+    {
+        if (Segments[i].IsArray)
+        {
+            error = pWriter->BeginArray (Segments[i].pName, Segments[i].len);
+
+            if (0 == error)
+                error = pWriter->BeginObject (NULL, 0);
+        }
+        else
+        {
+            error = pWriter->BeginObject (Segments[i].pName, Segments[i].len);
+        }
+
+        if (error)
+            return error;
+
+        pCtx->Open[pCtx->OpenCount++] = Segments[i];
+    }
+
+    pszKey = Segments[count-1].pName;
+    KeyLen = Segments[count-1].len;
+
+    if ( (pszSuffix) && (1 == KeyLen) && ('*' == *pszKey) )
+    {
+        pszKey = pszSuffix;
+        KeyLen = -1;
+    }
+
+    if ( ( (OTS_TYPE_NUMBER == pEntry->Type) || (OTS_TYPE_BOOL == pEntry->Type) ) && (!JsonIsScalar (pszValue)) )
+        fprintf (stderr, "Warning: [%s] is not a valid number or boolean value, written as string\n", pEntry->pszName ? pEntry->pszName : pEntry->pszPath);
+
+    if (NULL == pszValue)
+        error = pWriter->Scalar (pszKey, KeyLen, "null");
+    else if (OTS_TYPE_LIST == pEntry->Type)
+        error = EmitList (pWriter, pszKey, KeyLen, pszValue);
+    else if ( (OTS_TYPE_NUMBER == pEntry->Type) || (OTS_TYPE_BOOL == pEntry->Type) )
+        error = pWriter->Scalar (pszKey, KeyLen, pszValue);
+    else
+        error = pWriter->String (pszKey, KeyLen, pszValue);
+
+    pCtx->Values++;
+
+    return error;
+}
+
+static int IsSchemaName (const char *pszName)
+{
+    /* Variables with an own schema entry are not matched by a prefix entry */
+
+    const OTS_SCHEMA_ENTRY *pEntry = NULL;
+
+    for (pEntry = g_OtsSchema; pEntry->pszPath; pEntry++)
+    {
+        if ( (pEntry->pszName) && (0 == STRICMP (pEntry->pszName, pszName)) )
+            return 1;
+    }
+
+    return 0;
+}
+
+static void ExpandDefault (AutoConfig *pAutoCfg, const char *pszDefault, char *retpszValue, int MaxValueSize)
+{
+    /* Replaces "{{ NAME }}" placeholders in a schema default. Variables without a value are replaced by an empty string */
+
+    int  len  = 0;
+    int  Pos  = 0;
+    const char *p    = pszDefault;
+    const char *pEnd = NULL;
+    const char *pszValue = NULL;
+
+    char szName[MAX_ENTRY_LEN+1] = {0};
+
+    while ( (*p) && (Pos < MaxValueSize-1) )
+    {
+        pEnd = ( ('{' == *p) && ('{' == *(p+1)) ) ? strstr (p+2, "}}") : NULL;
+
+        if (NULL == pEnd)
+        {
+            retpszValue[Pos++] = *p++;
+            continue;
+        }
+
+        GetPlaceholderName (p, pEnd, szName, sizeof (szName));
+        p = pEnd + 2;
+
+        pszValue = pAutoCfg->GetValue (szName);
+
+        if (IsNullStr (pszValue))
+            continue;
+
+        len = (int) strlen (pszValue);
+
+        if (len > MaxValueSize-1-Pos)
+            len = MaxValueSize-1-Pos;
+
+        memcpy (retpszValue + Pos, pszValue, len);
+        Pos += len;
+    }
+
+    retpszValue[Pos] = '\0';
+}
+
+static int EmitPrefix (AutoConfig *pAutoCfg, JsonWriter *pWriter, OTS_GEN_CONTEXT *pCtx, const OTS_SCHEMA_ENTRY *pEntry)
+{
+    /* Emits all variables matching the prefix, config file entries take precedence over the environment */
+
+    int  error  = 0;
+    int  i      = 0;
+    int  len    = 0;
+    int  PrefixLen = 0;
+    char **ppEnv = NULL;
+    const char *pEqual = NULL;
+    CFG_STRUCT *pCfg = NULL;
+
+    char szName[MAX_ENTRY_LEN+1] = {0};
+
+    PrefixLen = (int) strlen (pEntry->pszName) - 1;
+
+    for (i=0; (pCfg = pAutoCfg->GetEntry (i)); i++)
+    {
+        if (STRNICMP (pCfg->szName, pEntry->pszName, PrefixLen))
+            continue;
+
+        if ( ('\0' == pCfg->szName[PrefixLen]) || ('\0' == *pCfg->szValue) )
+            continue;
+
+        if (IsSchemaName (pCfg->szName))
+            continue;
+
+        error = EmitValue (pWriter, pCtx, pEntry, pCfg->szName + PrefixLen, pCfg->szValue);
+        if (error)
+            return error;
+    }
+
+    for (ppEnv = ENVIRON; ppEnv && *ppEnv; ppEnv++)
+    {
+        if (strncmp (*ppEnv, pEntry->pszName, PrefixLen))
+            continue;
+
+        pEqual = strchr (*ppEnv, '=');
+
+        if (NULL == pEqual)
+            continue;
+
+        len = (int) (pEqual - *ppEnv);
+
+        if ( (len <= PrefixLen) || (len > MAX_ENTRY_LEN) || ('\0' == *(pEqual+1)) )
+            continue;
+
+        memcpy (szName, *ppEnv, len);
+        szName[len] = '\0';
+
+        if ( (pAutoCfg->CheckCfgArray (szName)) || (IsSchemaName (szName)) )
+            continue;
+
+        error = EmitValue (pWriter, pCtx, pEntry, szName + PrefixLen, pEqual+1);
+        if (error)
+            return error;
+    }
+
+    return 0;
+}
+
+int GenerateOts (AutoConfig *pAutoCfg, FILE *fpOutput)
+{
+    int  error = 0;
+    int  len   = 0;
+    const char *pszValue = NULL;
+    const OTS_SCHEMA_ENTRY *pEntry = NULL;
+
+    char szName[MAX_ENTRY_LEN+1] = {0};
+    char szValue[MAX_BUFFER] = {0};
+
+    OTS_GEN_CONTEXT Ctx;
+    JsonWriter Writer (fpOutput);
+
+    memset (&Ctx, 0, sizeof (Ctx));
+
+    error = Writer.BeginObject (NULL, 0);
+    if (error)
+        goto Done;
+
+    for (pEntry = g_OtsSchema; pEntry->pszPath; pEntry++)
+    {
+        len = pEntry->pszName ? (int) strlen (pEntry->pszName) : 0;
+        pszValue = NULL;
+
+        if ( (len) && ('*' == pEntry->pszName[len-1]) )
+        {
+            error = EmitPrefix (pAutoCfg, &Writer, &Ctx, pEntry);
+        }
+        else
+        {
+            if (pEntry->pszName)
+            {
+                snprintf (szName, sizeof (szName), "%s", pEntry->pszName);
+                pszValue = pAutoCfg->GetValue (szName);
+            }
+
+            /* Entries with a default are always written, all others only with a value */
+            if ( (IsNullStr (pszValue)) && (pEntry->pszDefault) )
+            {
+                ExpandDefault (pAutoCfg, pEntry->pszDefault, szValue, sizeof (szValue));
+                pszValue = szValue;
+            }
+            else if (IsNullStr (pszValue))
+            {
+                if (OTS_TYPE_NULL != pEntry->Type)
+                    continue;
+
+                pszValue = NULL;
+            }
+
+            error = EmitValue (&Writer, &Ctx, pEntry, NULL, pszValue);
+        }
+
+        if (error)
+            goto Done;
+    }
+
+    error = CloseLevels (&Writer, &Ctx, 0);
+    if (error)
+        goto Done;
+
+    error = Writer.Finish();
+    if (error)
+        goto Done;
+
+    fprintf (stderr, "Info: %d values written\n", Ctx.Values);
+
+Done:
+
+    return error;
+}
+
+int FileGenerateOts (AutoConfig *pAutoCfg, const char *pszOutputFile)
+{
+    int   error      = 0;
+    FILE  *fpOut     = NULL;
+
+    fpOut = pAutoCfg->OpenOutput (pszOutputFile);
+
+    if (NULL == fpOut)
+    {
+        fprintf (stderr, "\nError: Cannot open output file: [%s]\n\n", pszOutputFile);
+        error = 2;
+        goto Done;
+    }
+
+    error = GenerateOts (pAutoCfg, fpOut);
+
+Done:
+
+    if (fpOut)
+    {
+        error = pAutoCfg->CloseOutput (pszOutputFile, fpOut, error);
+        fpOut = NULL;
+    }
+
+    return error;
+}
@@ -0,0 +1,53 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef OTSGEN_HPP
+    #define OTSGEN_HPP
+
+#include <stdio.h>
+
+#include "cfg.hpp"
+
+#define OTS_TYPE_STRING   1
+#define OTS_TYPE_NUMBER   2
+#define OTS_TYPE_BOOL     3
+#define OTS_TYPE_NULL     4  /* String, written as null without a value */
+#define OTS_TYPE_LIST     5  /* Comma separated list, written as array of strings */
+
+#define OTS_MAX_SEGMENTS  16
+
+typedef struct {
+    const char *pszName;     /* Variable name or NULL for a fixed value. A trailing '*' matches all variables with this prefix */
+    const char *pszPath;     /* JSON path separated by '/'. "[n]" marks object n of an array, "[]" is the first object. A leaf '*' is replaced by the variable suffix */
+    int  Type;
+    const char *pszDefault;  /* Written if the variable has no value, "{{ NAME }}" placeholders are replaced. NULL omits the value */
+} OTS_SCHEMA_ENTRY;
+
+typedef struct {
+    const char *pName;
+    int  len;
+    int  IsArray;
+    int  Index;
+} OTS_SEGMENT;
+
+int GenerateOts     (AutoConfig *pAutoCfg, FILE *fpOutput);
+int FileGenerateOts (AutoConfig *pAutoCfg, const char *pszOutputFile);
+
+#endif
@@ -0,0 +1,499 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <thread>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+#endif
+
+#include "parallel.hpp"
+#include "textin.hpp"
+
+typedef struct {
+    char   *pData;
+    size_t Size;
+    char   *pMap;
+    size_t MapSize;
+} RENDER_INPUT;
+
+
+static int ReadInputText (TextInput *pText, RENDER_INPUT *pInput)
+{
+    /* Reads converted UTF-8 text into a growing buffer */
+
+    size_t Read = 0;
+    size_t Max  = 0;
+    char   *pNewData = NULL;
+
+    while (1)
+    {
+        if (pInput->Size == Max)
+        {
+            Max = Max ? Max * 2 : PARALLEL_CHUNK_SIZE;
+            pNewData = (char *) realloc (pInput->pData, Max);
+
+            if (NULL == pNewData)
+            {
+                printf ("\nError: Cannot re-allocate input buffer (%lu)\n\n", (unsigned long) Max);
+                return 2;
+            }
+
+            pInput->pData = pNewData;
+        }
+
+        Read = pText->Read (pInput->pData + pInput->Size, Max - pInput->Size);
+
+        if (0 == Read)
+            break;
+
+        pInput->Size += Read;
+    }
+
+    return 0;
+}
+
+static int ReadInputFile (const char *pszInputFile, RENDER_INPUT *pInput)
+{
+    /* UTF-8 input files are mapped into memory on UNIX. UTF-16 input and input on Windows is read and converted into memory */
+
+    int    error = 0;
+    TextInput Text;
+
+#ifndef _WIN32
+
+    int    fd = -1;
+    size_t Bom = 0;
+    struct stat FileStat = {0};
+
+    fd = open (pszInputFile, O_RDONLY);
+
+    if (fd < 0)
+    {
+        error = 1;
+        goto Done;
+    }
+
+    if (fstat (fd, &FileStat))
+    {
+        error = 1;
+        goto Done;
+    }
+
+    if (0 == FileStat.st_size)
+        goto Done;
+
+    pInput->pMap = (char *) mmap (NULL, FileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (MAP_FAILED == pInput->pMap)
+    {
+        pInput->pMap = NULL;
+        error = 2;
+        goto Done;
+    }
+
+    pInput->MapSize = (size_t) FileStat.st_size;
+
+    switch (DetectTextEncoding ((const unsigned char *) pInput->pMap, pInput->MapSize, &Bom))
+    {
+        case TEXT_ENCODING_UTF8:
+        case TEXT_ENCODING_UTF8_BOM:
+
+            madvise (pInput->pMap, pInput->MapSize, MADV_SEQUENTIAL);
+            pInput->pData = pInput->pMap + Bom;
+            pInput->Size  = pInput->MapSize - Bom;
+            goto Done;
+
+        default:
+
+            munmap (pInput->pMap, pInput->MapSize);
+            pInput->pMap    = NULL;
+            pInput->MapSize = 0;
+            break;
+    }
+
+#endif
+
+    if (Text.Open (pszInputFile))
+    {
+        error = 1;
+        goto Done;
+    }
+
+    error = ReadInputText (&Text, pInput);
+
+Done:
+
+#ifndef _WIN32
+    if (fd >= 0)
+    {
+        close (fd);
+        fd = -1;
+    }
+#endif
+
+    if (error)
+        printf ("\nError: Cannot open input file: [%s]\n\n", pszInputFile);
+
+    return error;
+}
+
+static int ReadInputProgram (const char *pszProgram, RENDER_INPUT *pInput)
+{
+    /* Program output cannot be mapped and is read into a growing buffer */
+
+    int    error = 0;
+    FILE   *fp   = NULL;
+    TextInput Text;
+
+    fp = POPEN (pszProgram, "r");
+
+    if (NULL == fp)
+    {
+        printf ("\nError: Cannot open process: [%s]\n\n", pszProgram);
+        error = 2;
+        goto Done;
+    }
+
+    error = Text.Attach (fp);
+    if (error)
+        goto Done;
+
+    error = ReadInputText (&Text, pInput);
+
+Done:
+
+    Text.Close();
+
+    if (fp)
+    {
+        PCLOSE (fp);
+        fp = NULL;
+    }
+
+    return error;
+}
+
+static void FreeInput (RENDER_INPUT *pInput)
+{
+#ifndef _WIN32
+    if (pInput->pMap)
+    {
+        munmap (pInput->pMap, pInput->MapSize);
+        pInput->pMap  = NULL;
+        pInput->pData = NULL;
+    }
+#endif
+
+    if (pInput->pData)
+        free (pInput->pData);
+
+    pInput->pData = NULL;
+    pInput->Size  = 0;
+}
+
+static int FindMarker (const char *pData, size_t Size, const char *pszMarker)
+{
+    size_t len = strlen (pszMarker);
+    const char *p    = pData;
+    const char *pEnd = pData + Size;
+
+    while ((size_t) (pEnd - p) >= len)
+    {
+        p = (const char *) memchr (p, *pszMarker, pEnd - p - len + 1);
+
+        if (NULL == p)
+            return 0;
+
+        if (0 == memcmp (p, pszMarker, len))
+            return 1;
+
+        p++;
+    }
+
+    return 0;
+}
+
+
+ParallelRender::ParallelRender (AutoConfig *pAutoCfg, const char *pszTemplate, int Threads)
+{
+    m_pAutoCfg    = pAutoCfg;
+    m_pszTemplate = pszTemplate;
+    m_Threads     = Threads;
+
+    if (m_Threads < 1)
+        m_Threads = 1;
+
+    if (m_Threads > PARALLEL_MAX_THREADS)
+        m_Threads = PARALLEL_MAX_THREADS;
+
+    m_pChunks   = NULL;
+    m_Chunks    = 0;
+    m_NextChunk = 0;
+    m_Written   = 0;
+}
+
+ParallelRender::~ParallelRender()
+{
+    int i = 0;
+
+    if (m_pChunks)
+    {
+        for (i=0; i<m_Chunks; i++)
+        {
+            if (m_pChunks[i].pOutput)
+                free (m_pChunks[i].pOutput);
+        }
+
+        free (m_pChunks);
+        m_pChunks = NULL;
+    }
+}
+
+int ParallelRender::SplitChunks (const char *pData, size_t Size)
+{
+    /* Chunks end after a line break, so each chunk contains complete lines */
+
+    size_t Offset = 0;
+    size_t Next   = 0;
+    const char *pEol = NULL;
+
+    m_Chunks = (int) (Size / PARALLEL_CHUNK_SIZE) + 1;
+    m_pChunks = (RENDER_CHUNK *) calloc (m_Chunks, sizeof (RENDER_CHUNK));
+
+    if (NULL == m_pChunks)
+    {
+        printf ("\nError: Cannot allocate chunk array (%d)\n\n", m_Chunks);
+        return 2;
+    }
+
+    m_Chunks = 0;
+
+    while (Offset < Size)
+    {
+        Next = Offset + PARALLEL_CHUNK_SIZE;
+
+        if (Next >= Size)
+        {
+            Next = Size;
+        }
+        else
+        {
+            pEol = (const char *) memchr (pData + Next, '\n', Size - Next);
+            Next = pEol ? (size_t) (pEol - pData + 1) : Size;
+        }
+
+        m_pChunks[m_Chunks].pData = pData + Offset;
+        m_pChunks[m_Chunks].Size  = Next - Offset;
+        m_Chunks++;
+
+        Offset = Next;
+    }
+
+    return 0;
+}
+
+void ParallelRender::Worker()
+{
+    int    i     = 0;
+    int    count = 0;
+    size_t OutputSize = 0;
+    char   *pOutput   = NULL;
+
+    /* Each thread has its own config with the prepared config as read only base */
+    AutoConfig Local;
+
+    Local.SetBase (m_pAutoCfg);
+    Local.SetTemplatePath (m_pszTemplate);
+
+    while (1)
+    {
+        {
+            std::unique_lock<std::mutex> Lock (m_Mutex);
+
+            while ( (m_NextChunk < m_Chunks) && (m_NextChunk >= m_Written + m_Threads * PARALLEL_WINDOW) )
+                m_ChunkWritten.wait (Lock);
+
+            if (m_NextChunk >= m_Chunks)
+                break;
+
+            i = m_NextChunk++;
+        }
+
+        count   = Local.RenderBuffer (m_pChunks[i].pData, m_pChunks[i].Size, NULL);
+        pOutput = Local.DetachMemoryOutput (&OutputSize);
+
+        {
+            std::lock_guard<std::mutex> Lock (m_Mutex);
+
+            m_pChunks[i].pOutput    = pOutput;
+            m_pChunks[i].OutputSize = OutputSize;
+            m_pChunks[i].Count      = count;
+            m_pChunks[i].Error      = Local.GetRenderError();
+            m_pChunks[i].Done       = 1;
+        }
+
+        m_ChunkDone.notify_all();
+    }
+}
+
+void ParallelRender::WorkerThread (ParallelRender *pRender)
+{
+    pRender->Worker();
+}
+
+int ParallelRender::Render (const char *pData, size_t Size, FILE *fpOutput, int *retpCount)
+{
+    int  error   = 0;
+    int  i       = 0;
+    int  Threads = 0;
+    int  count   = 0;
+    std::thread *pThreads = NULL;
+
+    error = SplitChunks (pData, Size);
+    if (error)
+        goto Done;
+
+    Threads = (m_Chunks < m_Threads) ? m_Chunks : m_Threads;
+    pThreads = new std::thread[Threads];
+
+    for (i=0; i<Threads; i++)
+        pThreads[i] = std::thread (WorkerThread, this);
+
+    /* Write chunks in input order as soon as they are rendered */
+    for (i=0; i<m_Chunks; i++)
+    {
+        {
+            std::unique_lock<std::mutex> Lock (m_Mutex);
+
+            while (0 == m_pChunks[i].Done)
+                m_ChunkDone.wait (Lock);
+        }
+
+        m_pAutoCfg->WriteData (m_pChunks[i].pOutput, m_pChunks[i].OutputSize, fpOutput);
+
+        count += m_pChunks[i].Count;
+
+        if (m_pChunks[i].Error)
+            error = 6;
+
+        {
+            std::lock_guard<std::mutex> Lock (m_Mutex);
+
+            free (m_pChunks[i].pOutput);
+            m_pChunks[i].pOutput = NULL;
+            m_Written = i+1;
+        }
+
+        m_ChunkWritten.notify_all();
+    }
+
+    for (i=0; i<Threads; i++)
+        pThreads[i].join();
+
+    delete [] pThreads;
+    pThreads = NULL;
+
+Done:
+
+    if (retpCount)
+        *retpCount = count;
+
+    return error;
+}
+
+
+int FileUpdateParallel (AutoConfig *pAutoCfg, const char *pszInputFile, const char *pszProgram, const char *pszOutputFile, int Threads)
+{
+    int   error  = 0;
+    int   count  = 0;
+    FILE  *fpOut = NULL;
+
+    RENDER_INPUT Input = {0};
+
+    if (IsNullStr (pszProgram))
+    {
+        error = ReadInputFile (pszInputFile, &Input);
+        pAutoCfg->SetTemplatePath (pszInputFile);
+    }
+    else
+    {
+        error = ReadInputProgram (pszProgram, &Input);
+    }
+
+    if (error)
+        goto Done;
+
+    /* Prompts and resolver lookups are done once up front. Rendering chunks only reads the config */
+    error = pAutoCfg->PrefetchBuffer (Input.pData, Input.Size);
+    if (error)
+        goto Done;
+
+    /* Blocks can span chunk boundaries */
+    if (FindMarker (Input.pData, Input.Size, EACH_BEGIN_MARKER))
+    {
+        fprintf (stderr, "Info: Template contains {{#each}} blocks - rendering single threaded\n");
+        error = pAutoCfg->FileUpdateFromBuffer (Input.pData, Input.Size, pszOutputFile);
+        goto Done;
+    }
+
+    error = pAutoCfg->Prepare();
+    if (error)
+        goto Done;
+
+    fpOut = pAutoCfg->OpenOutput (pszOutputFile);
+
+    if (NULL == fpOut)
+    {
+        printf ("\nError: Cannot open output file: [%s]\n\n", pszOutputFile);
+        error = 2;
+        goto Done;
+    }
+
+    {
+        ParallelRender Render (pAutoCfg, pszInputFile, Threads);
+        error = Render.Render (Input.pData, Input.Size, fpOut, &count);
+    }
+
+    if (count)
+    {
+        if (!IsNullStr (pszOutputFile))
+            printf ("\nWarning: %d placeholders with empty values!\n\n", count);
+    }
+
+Done:
+
+    if (fpOut)
+    {
+        error = pAutoCfg->CloseOutput (pszOutputFile, fpOut, error);
+        fpOut = NULL;
+    }
+
+    FreeInput (&Input);
+
+    return error;
+}
@@ -0,0 +1,83 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef PARALLEL_HPP
+    #define PARALLEL_HPP
+
+#include <stddef.h>
+
+#include <mutex>
+#include <condition_variable>
+
+#include "cfg.hpp"
+
+#define PARALLEL_CHUNK_SIZE     (4*1024*1024)
+#define PARALLEL_MAX_THREADS    64
+#define PARALLEL_WINDOW         4   /* Chunks per thread rendered ahead of the writer */
+
+typedef struct {
+    const char *pData;
+    size_t Size;
+    char   *pOutput;
+    size_t OutputSize;
+    int    Count;
+    int    Error;
+    int    Done;
+} RENDER_CHUNK;
+
+
+/* Renders a template in memory split into chunks at line boundaries.
+   Worker threads render chunks into memory buffers, which are written in order by the calling thread.
+   Only the configured number of chunks ahead of the writer are rendered to limit memory usage */
+
+class ParallelRender
+{
+
+public:
+
+    ParallelRender (AutoConfig *pAutoCfg, const char *pszTemplate, int Threads);
+    ~ParallelRender();
+
+    int  Render (const char *pData, size_t Size, FILE *fpOutput, int *retpCount);
+
+private:
+
+    int  SplitChunks (const char *pData, size_t Size);
+    void Worker ();
+
+    static void WorkerThread (ParallelRender *pRender);
+
+    AutoConfig *m_pAutoCfg;
+    const char *m_pszTemplate;
+    int  m_Threads;
+
+    RENDER_CHUNK *m_pChunks;
+    int  m_Chunks;
+    int  m_NextChunk;
+    int  m_Written;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_ChunkDone;
+    std::condition_variable m_ChunkWritten;
+};
+
+int FileUpdateParallel (AutoConfig *pAutoCfg, const char *pszInputFile, const char *pszProgram, const char *pszOutputFile, int Threads);
+
+#endif
@@ -0,0 +1,619 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include <thread>
+#include <atomic>
+
+#ifndef _WIN32
+    #include <sys/wait.h>
+#endif
+
+#include "resolver.hpp"
+
+#ifdef _WIN32
+    #define UMASK _umask
+#else
+    #define UMASK umask
+#endif
+
+
+CfgResolver::CfgResolver()
+{
+    memset (m_Resolvers, 0, sizeof (m_Resolvers));
+
+    m_ResolverCount   = 0;
+    m_Parallel        = RESOLVER_DEFAULT_PARALLEL;
+    m_pCache          = NULL;
+    m_CacheEntries    = 0;
+    m_CacheEntriesMax = 0;
+    m_CacheUpdated    = 0;
+    m_lTTL            = RESOLVER_DEFAULT_TTL;
+    *m_szCacheFile    = '\0';
+    m_pMissing        = NULL;
+    m_MissingEntries  = 0;
+    m_MissingEntriesMax = 0;
+}
+
+CfgResolver::~CfgResolver()
+{
+    if (m_pCache)
+    {
+        free (m_pCache);
+        m_pCache = NULL;
+    }
+
+    m_CacheEntries    = 0;
+    m_CacheEntriesMax = 0;
+
+    if (m_pMissing)
+    {
+        free (m_pMissing);
+        m_pMissing = NULL;
+    }
+
+    m_MissingEntries    = 0;
+    m_MissingEntriesMax = 0;
+}
+
+int CfgResolver::AddResolver (const char *pszDefinition)
+{
+    /* Format: <prefix>=<command> */
+
+    int  len = 0;
+    const char *pEqual = NULL;
+    RESOLVER_STRUCT *pResolver = NULL;
+
+    if (IsNullStr (pszDefinition))
+        return 1;
+
+    pEqual = strstr (pszDefinition, "=");
+
+    if (NULL == pEqual)
+    {
+        fprintf (stderr, "\nError: Invalid resolver definition: [%s] (expected <prefix>=<command>)\n\n", pszDefinition);
+        return 1;
+    }
+
+    len = (int) (pEqual - pszDefinition);
+
+    if ( (0 == len) || (len > MAX_ENTRY_LEN) || IsNullStr (pEqual+1) )
+    {
+        fprintf (stderr, "\nError: Invalid resolver definition: [%s]\n\n", pszDefinition);
+        return 1;
+    }
+
+    if (m_ResolverCount >= MAX_RESOLVERS)
+    {
+        fprintf (stderr, "\nError: Too many resolvers (max: %d)\n\n", MAX_RESOLVERS);
+        return 1;
+    }
+
+    pResolver = &m_Resolvers[m_ResolverCount];
+
+    memcpy (pResolver->szPrefix, pszDefinition, len);
+    pResolver->szPrefix[len] = '\0';
+    strdncpy (pResolver->szCommand, pEqual+1, sizeof (pResolver->szCommand));
+
+    m_ResolverCount++;
+    return 0;
+}
+
+void CfgResolver::SetParallel (int Value)
+{
+    if (Value < 1)
+        Value = 1;
+
+    if (Value > RESOLVER_MAX_PARALLEL)
+        Value = RESOLVER_MAX_PARALLEL;
+
+    m_Parallel = Value;
+}
+
+int CfgResolver::SetCacheFile (const char *pszFileName, long lTTL)
+{
+    m_lTTL = lTTL;
+
+    if (IsNullStr (pszFileName))
+    {
+        *m_szCacheFile = '\0';
+        return 0;
+    }
+
+    strdncpy (m_szCacheFile, pszFileName, sizeof (m_szCacheFile));
+
+    return ReadCache();
+}
+
+int CfgResolver::HasResolvers()
+{
+    return (m_ResolverCount > 0);
+}
+
+const RESOLVER_STRUCT *CfgResolver::FindResolver (const char *pszName)
+{
+    int i = 0;
+    const char *p = NULL;
+    const RESOLVER_STRUCT *pBestMatch = NULL;
+
+    if (IsNullStr (pszName))
+        return NULL;
+
+    /* Only plain key names are passed to a shell */
+    for (p = pszName; *p; p++)
+    {
+        if ( ((*p >= 'a') && (*p <= 'z')) || ((*p >= 'A') && (*p <= 'Z')) || ((*p >= '0') && (*p <= '9')) )
+            continue;
+
+        if ( ('_' == *p) || ('-' == *p) || ('.' == *p) )
+            continue;
+
+        return NULL;
+    }
+
+    /* Longest prefix wins */
+    for (i=0; i<m_ResolverCount; i++)
+    {
+        if (strncmp (pszName, m_Resolvers[i].szPrefix, strlen (m_Resolvers[i].szPrefix)))
+            continue;
+
+        if ( (NULL == pBestMatch) || (strlen (m_Resolvers[i].szPrefix) > strlen (pBestMatch->szPrefix)) )
+            pBestMatch = &m_Resolvers[i];
+    }
+
+    return pBestMatch;
+}
+
+void CfgResolver::RunLookup (RESOLVER_LOOKUP *pLookup)
+{
+    FILE *fp   = NULL;
+    char *p    = NULL;
+    int  status = 0;
+    const char *pszKey = NULL;
+
+    char szCommand[MAX_BUFFER+MAX_ENTRY_LEN+10] = {0};
+    char szLine[MAX_BUFFER] = {0};
+
+    if ( (NULL == pLookup) || (NULL == pLookup->pResolver) )
+        return;
+
+    pLookup->Found = 0;
+    *pLookup->szValue = '\0';
+
+    pszKey = pLookup->szName + strlen (pLookup->pResolver->szPrefix);
+
+    if ('\0' == *pszKey)
+        pszKey = pLookup->szName;
+
+    snprintf (szCommand, sizeof (szCommand)-1, "%s %s", pLookup->pResolver->szCommand, pszKey);
+
+    fp = POPEN (szCommand, "r");
+
+    if (NULL == fp)
+    {
+        fprintf (stderr, "Error: Cannot run resolver for [%s]\n", pLookup->szName);
+        return;
+    }
+
+    if (fgets (szLine, sizeof (szLine)-1, fp))
+    {
+        /* Remove control chars end of line */
+        p = szLine;
+
+        while (*p)
+        {
+            if ((unsigned char) *p < 32)
+                *p = '\0';
+            p++;
+        }
+    }
+
+    /* Drain remaining output to let the process terminate normally */
+    while (fgets (szCommand, sizeof (szCommand)-1, fp))
+        ;
+
+    status = PCLOSE (fp);
+
+    if (status)
+    {
+#ifdef _WIN32
+        fprintf (stderr, "Warning: Resolver for [%s] returned status %d\n", pLookup->szName, status);
+#else
+        if ( (-1 != status) && (WIFSIGNALED (status)) )
+            fprintf (stderr, "Warning: Resolver for [%s] terminated by signal %d\n", pLookup->szName, WTERMSIG (status));
+        else if ( (-1 != status) && (WIFEXITED (status)) )
+            fprintf (stderr, "Warning: Resolver for [%s] returned status %d\n", pLookup->szName, WEXITSTATUS (status));
+        else
+            fprintf (stderr, "Warning: Resolver for [%s] failed\n", pLookup->szName);
+#endif
+        return;
+    }
+
+    if ('\0' == *szLine)
+        return;
+
+    strdncpy (pLookup->szValue, szLine, sizeof (pLookup->szValue));
+    pLookup->Found = 1;
+}
+
+static void LookupWorker (RESOLVER_LOOKUP *pLookups, int Count, std::atomic<int> *pNextLookup)
+{
+    int n = 0;
+
+    while ( (n = (*pNextLookup)++) < Count)
+    {
+        if ( (pLookups[n].pResolver) && (0 == pLookups[n].Found) )
+            CfgResolver::RunLookup (&pLookups[n]);
+    }
+}
+
+int CfgResolver::ResolveKeys (RESOLVER_LOOKUP *pLookups, int Count)
+{
+    /* Returns number of keys resolved */
+
+    int i       = 0;
+    int found   = 0;
+    int pending = 0;
+    int threads = 0;
+    time_t tNow = time (NULL);
+
+    std::atomic<int> NextLookup (0);
+    std::thread *pThreads = NULL;
+
+    if ( (NULL == pLookups) || (Count <= 0) )
+        return 0;
+
+    /* Cached values first, only the remaining keys are looked up */
+    for (i=0; i<Count; i++)
+    {
+        if (NULL == pLookups[i].pResolver)
+            pLookups[i].pResolver = FindResolver (pLookups[i].szName);
+
+        pLookups[i].Found = 0;
+
+        if (NULL == pLookups[i].pResolver)
+            continue;
+
+        if (CheckCache (pLookups[i].szName, pLookups[i].szValue, sizeof (pLookups[i].szValue)))
+        {
+            pLookups[i].Found = 2;
+            continue;
+        }
+
+        /* A key which could not be resolved before is not looked up again in this run */
+        if (IsMissing (pLookups[i].szName))
+        {
+            pLookups[i].pResolver = NULL;
+            continue;
+        }
+
+        pending++;
+    }
+
+    if (0 == pending)
+        goto Done;
+
+    threads = (pending < m_Parallel) ? pending : m_Parallel;
+
+    if (1 == threads)
+    {
+        LookupWorker (pLookups, Count, &NextLookup);
+    }
+    else
+    {
+        pThreads = new std::thread[threads];
+
+        for (i=0; i<threads; i++)
+            pThreads[i] = std::thread (LookupWorker, pLookups, Count, &NextLookup);
+
+        for (i=0; i<threads; i++)
+            pThreads[i].join();
+
+        delete [] pThreads;
+        pThreads = NULL;
+    }
+
+    for (i=0; i<Count; i++)
+    {
+        if (1 == pLookups[i].Found)
+            AddCacheEntry (pLookups[i].szName, pLookups[i].szValue, tNow + m_lTTL);
+        else if ( (pLookups[i].pResolver) && (0 == pLookups[i].Found) )
+            AddMissing (pLookups[i].szName);
+    }
+
+Done:
+
+    for (i=0; i<Count; i++)
+    {
+        if (pLookups[i].Found)
+            found++;
+    }
+
+    return found;
+}
+
+int CfgResolver::Resolve (const char *pszName, char *retpszValue, int MaxValueSize)
+{
+    /* Single synchronous lookup for keys not known in advance (e.g. template from stdin) */
+
+    RESOLVER_LOOKUP Lookup = {0};
+
+    if ( (NULL == retpszValue) || (MaxValueSize <= 0) )
+        return 0;
+
+    *retpszValue = '\0';
+
+    if (IsNullStr (pszName))
+        return 0;
+
+    strdncpy (Lookup.szName, pszName, sizeof (Lookup.szName));
+
+    if (0 == ResolveKeys (&Lookup, 1))
+        return 0;
+
+    strdncpy (retpszValue, Lookup.szValue, MaxValueSize);
+    return 1;
+}
+
+int CfgResolver::IsMissing (const char *pszName)
+{
+    int i = 0;
+
+    for (i=0; i<m_MissingEntries; i++)
+    {
+        if (0 == strcmp (pszName, m_pMissing[i].szName))
+            return 1;
+    }
+
+    return 0;
+}
+
+int CfgResolver::AddMissing (const char *pszName)
+{
+    /* Negative entries are only kept in memory. The next run looks up the key again */
+
+    RESOLVER_MISSING_STRUCT *pNewMissing = NULL;
+
+    if (IsMissing (pszName))
+        return 0;
+
+    if (m_MissingEntries >= m_MissingEntriesMax)
+    {
+        m_MissingEntriesMax += INCREASE_ARRAY_ELEMENTS;
+
+        pNewMissing = (RESOLVER_MISSING_STRUCT *) realloc (m_pMissing, m_MissingEntriesMax * sizeof (RESOLVER_MISSING_STRUCT));
+
+        if (NULL == pNewMissing)
+        {
+            fprintf (stderr, "\nError: Cannot re-allocate resolver negative cache (%d)\n\n", m_MissingEntriesMax);
+            return 2;
+        }
+
+        m_pMissing = pNewMissing;
+    }
+
+    strdncpy (m_pMissing[m_MissingEntries].szName, pszName, sizeof (m_pMissing[m_MissingEntries].szName));
+    m_MissingEntries++;
+
+    return 0;
+}
+
+int CfgResolver::CheckCache (const char *pszName, char *retpszValue, int MaxValueSize)
+{
+    int i = 0;
+    time_t tNow = 0;
+
+    if (0 == m_CacheEntries)
+        return 0;
+
+    tNow = time (NULL);
+
+    for (i=0; i<m_CacheEntries; i++)
+    {
+        if (strcmp (pszName, m_pCache[i].szName))
+            continue;
+
+        if (m_pCache[i].tExpire <= tNow)
+            return 0;
+
+        strdncpy (retpszValue, m_pCache[i].szValue, MaxValueSize);
+        return 1;
+    }
+
+    return 0;
+}
+
+int CfgResolver::AddCacheEntry (const char *pszName, const char *pszValue, time_t tExpire)
+{
+    int i = 0;
+    RESOLVER_CACHE_STRUCT *pNewCache = NULL;
+
+    if (m_lTTL <= 0)
+        return 0;
+
+    if ('\0' == *m_szCacheFile)
+        return 0;
+
+    /* Update existing entry */
+    for (i=0; i<m_CacheEntries; i++)
+    {
+        if (0 == strcmp (pszName, m_pCache[i].szName))
+            break;
+    }
+
+    if (i == m_CacheEntries)
+    {
+        if (m_CacheEntries >= m_CacheEntriesMax)
+        {
+            m_CacheEntriesMax += INCREASE_ARRAY_ELEMENTS;
+
+            pNewCache = (RESOLVER_CACHE_STRUCT *) realloc (m_pCache, m_CacheEntriesMax * sizeof (RESOLVER_CACHE_STRUCT));
+
+            if (NULL == pNewCache)
+            {
+                fprintf (stderr, "\nError: Cannot re-allocate resolver cache (%d)\n\n", m_CacheEntriesMax);
+                return 2;
+            }
+
+            m_pCache = pNewCache;
+        }
+
+        m_CacheEntries++;
+    }
+
+    strdncpy (m_pCache[i].szName,  pszName,  sizeof (m_pCache[i].szName));
+    strdncpy (m_pCache[i].szValue, pszValue, sizeof (m_pCache[i].szValue));
+    m_pCache[i].tExpire = tExpire;
+
+    m_CacheUpdated = 1;
+    return 0;
+}
+
+int CfgResolver::ReadCache()
+{
+    /* Format: <expiration epoch>|<name>=<value> */
+
+    FILE *fp     = NULL;
+    char *pSep   = NULL;
+    char *pEqual = NULL;
+    char *p      = NULL;
+    time_t tNow    = time (NULL);
+    time_t tExpire = 0;
+
+    char szBuffer[MAX_BUFFER] = {0};
+
+    if ('\0' == *m_szCacheFile)
+        return 0;
+
+    fp = fopen (m_szCacheFile, "r");
+
+    /* A missing cache file is created on first write */
+    if (NULL == fp)
+        return 0;
+
+    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    {
+        p = szBuffer;
+
+        while (*p)
+        {
+            if ((unsigned char) *p < 32)
+                *p = '\0';
+            p++;
+        }
+
+        pSep = strstr (szBuffer, "|");
+        if (NULL == pSep)
+            continue;
+
+        *pSep = '\0';
+
+        pEqual = strstr (pSep+1, "=");
+        if (NULL == pEqual)
+            continue;
+
+        *pEqual = '\0';
+
+        tExpire = (time_t) atoll (szBuffer);
+
+        if (tExpire <= tNow)
+            continue;
+
+        AddCacheEntry (pSep+1, pEqual+1, tExpire);
+    }
+
+    fclose (fp);
+    fp = NULL;
+
+    /* Nothing changed yet, only expired entries have been skipped */
+    m_CacheUpdated = 0;
+
+    return 0;
+}
+
+int CfgResolver::WriteCache()
+{
+    int  error  = 0;
+    int  i      = 0;
+    int  OldMask = 0;
+    FILE *fp    = NULL;
+    time_t tNow = time (NULL);
+
+    char szTempFile[MAX_BUFFER+10] = {0};
+
+    if ( (0 == m_CacheUpdated) || ('\0' == *m_szCacheFile) )
+        return 0;
+
+    snprintf (szTempFile, sizeof (szTempFile)-1, "%s.tmp", m_szCacheFile);
+
+    /* Cached values are secrets, only the owner should be able to read them */
+    OldMask = UMASK (077);
+    fp = fopen (szTempFile, "w");
+    UMASK (OldMask);
+
+    if (NULL == fp)
+    {
+        fprintf (stderr, "\nError: Cannot write resolver cache: [%s]\n\n", szTempFile);
+        error = 1;
+        goto Done;
+    }
+
+    for (i=0; i<m_CacheEntries; i++)
+    {
+        if (m_pCache[i].tExpire <= tNow)
+            continue;
+
+        fprintf (fp, "%lld|%s=%s\n", (long long) m_pCache[i].tExpire, m_pCache[i].szName, m_pCache[i].szValue);
+    }
+
+    if (fclose (fp))
+    {
+        fp = NULL;
+        fprintf (stderr, "\nError: Cannot write resolver cache: [%s]\n\n", szTempFile);
+        remove (szTempFile);
+        error = 1;
+        goto Done;
+    }
+
+    fp = NULL;
+
+#ifdef _WIN32
+    remove (m_szCacheFile);
+#endif
+
+    if (rename (szTempFile, m_szCacheFile))
+    {
+        fprintf (stderr, "\nError: Cannot replace resolver cache: [%s]\n\n", m_szCacheFile);
+        remove (szTempFile);
+        error = 1;
+        goto Done;
+    }
+
+    m_CacheUpdated = 0;
+
+Done:
+
+    return error;
+}
@@ -0,0 +1,106 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef RESOLVER_HPP
+    #define RESOLVER_HPP
+
+#include <time.h>
+
+#include "cfg.hpp"
+
+#define MAX_RESOLVERS             20
+#define RESOLVER_DEFAULT_PARALLEL 8
+#define RESOLVER_MAX_PARALLEL     64
+#define RESOLVER_DEFAULT_TTL      300
+
+typedef struct {
+    char szPrefix[MAX_ENTRY_LEN+1];
+    char szCommand[MAX_BUFFER+1];
+} RESOLVER_STRUCT;
+
+typedef struct _RESOLVER_LOOKUP {
+    char szName[MAX_ENTRY_LEN+1];
+    char szValue[MAX_ENTRY_LEN+1];
+    int  Found;
+    const RESOLVER_STRUCT *pResolver;
+} RESOLVER_LOOKUP;
+
+typedef struct {
+    char   szName[MAX_ENTRY_LEN+1];
+    char   szValue[MAX_ENTRY_LEN+1];
+    time_t tExpire;
+} RESOLVER_CACHE_STRUCT;
+
+typedef struct {
+    char   szName[MAX_ENTRY_LEN+1];
+} RESOLVER_MISSING_STRUCT;
+
+
+/* Resolves values via external programs (e.g. a vault CLI) per key name prefix.
+   The key without prefix is passed as last argument and the first line written to stdout is the value.
+   Lookups for multiple keys run concurrently and results are cached in a local file with a TTL.
+   Keys which could not be resolved are remembered for the rest of the run and not looked up again */
+
+class CfgResolver
+{
+
+public:
+
+    CfgResolver();
+    ~CfgResolver();
+
+    int  AddResolver   (const char *pszDefinition);
+    void SetParallel   (int Value);
+    int  SetCacheFile  (const char *pszFileName, long lTTL);
+    int  HasResolvers  ();
+    int  ResolveKeys   (RESOLVER_LOOKUP *pLookups, int Count);
+    int  Resolve       (const char *pszName, char *retpszValue, int MaxValueSize);
+    int  WriteCache    ();
+
+    const RESOLVER_STRUCT *FindResolver (const char *pszName);
+
+    static void RunLookup (RESOLVER_LOOKUP *pLookup);
+
+private:
+
+    int  ReadCache     ();
+    int  CheckCache    (const char *pszName, char *retpszValue, int MaxValueSize);
+    int  AddCacheEntry (const char *pszName, const char *pszValue, time_t tExpire);
+    int  IsMissing     (const char *pszName);
+    int  AddMissing    (const char *pszName);
+
+    RESOLVER_STRUCT m_Resolvers[MAX_RESOLVERS];
+    int  m_ResolverCount;
+    int  m_Parallel;
+
+    RESOLVER_CACHE_STRUCT *m_pCache;
+    int  m_CacheEntries;
+    int  m_CacheEntriesMax;
+    int  m_CacheUpdated;
+    long m_lTTL;
+    char m_szCacheFile[MAX_BUFFER+1];
+
+    /* Keys no resolver returned a value for in this run */
+    RESOLVER_MISSING_STRUCT *m_pMissing;
+    int  m_MissingEntries;
+    int  m_MissingEntriesMax;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#!/bin/bash
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool) - Tests                        #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+
+# Runs autocfg against small templates in a temporary directory and compares the results.
+# Returns the number of failed tests.
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+AUTOCFG="$SCRIPT_DIR/autocfg"
+TIMEOUT=10
+FAILED=0
+PASSED=0
+
+
+log()
+{
+  echo "$@" >&2
+}
+
+pass()
+{
+  PASSED=$((PASSED + 1))
+  log "PASS  $1"
+}
+
+fail()
+{
+  FAILED=$((FAILED + 1))
+  log "FAIL  $1: $2"
+}
+
+run_autocfg()
+{
+  # autocfg must never hang, a timeout is reported as failure
+  timeout "$TIMEOUT" "$AUTOCFG" "$@" > "$WORK_DIR/autocfg.log" 2>&1
+}
+
+test_empty_include()
+{
+  local name="Empty include fragment"
+  local dir="$WORK_DIR/empty_include"
+
+  mkdir -p "$dir/frag"
+  : > "$dir/frag/empty.json"
+  printf '{\n{{> frag/empty.json }}\n"a": "{{> frag/empty.json }}"\n}\n' > "$dir/template.json"
+  printf '{\n"a": ""\n}\n' > "$dir/expected.json"
+
+  run_autocfg -f="$dir/template.json" -o="$dir/out.json"
+  local ret=$?
+
+  if [ "$ret" -ne 0 ]; then
+    fail "$name" "autocfg returned $ret"
+  elif ! cmp -s "$dir/expected.json" "$dir/out.json"; then
+    fail "$name" "unexpected output"
+  else
+    pass "$name"
+  fi
+}
+
+test_empty_template()
+{
+  local name="Empty template"
+  local dir="$WORK_DIR/empty_template"
+
+  mkdir -p "$dir"
+  : > "$dir/template.json"
+
+  run_autocfg -f="$dir/template.json" -o="$dir/out.json"
+  local ret=$?
+
+  if [ "$ret" -ne 0 ]; then
+    fail "$name" "autocfg returned $ret"
+  elif [ -s "$dir/out.json" ]; then
+    fail "$name" "output is not empty"
+  else
+    pass "$name"
+  fi
+}
+
+test_generate_template()
+{
+  # -generate must create the same document as the example template
+  local name="Generated OTS matches example template"
+  local dir="$WORK_DIR/generate"
+
+  if [ -z "$(command -v python3)" ]; then
+    log "SKIP  $name: python3 not found"
+    return 0
+  fi
+
+  mkdir -p "$dir"
+
+  export SERVERSETUP_SERVER_NAME=DominoLabServerBingo
+  export SERVERSETUP_SERVER_DOMAINNAME=LabDomainBingo
+
+  run_autocfg -env="$SCRIPT_DIR/examples/env.txt" -f="$SCRIPT_DIR/examples/ots_template.json" -o="$dir/template.json"
+  local ret=$?
+
+  if [ "$ret" -eq 0 ]; then
+    run_autocfg -generate -env="$SCRIPT_DIR/examples/env.txt" -o="$dir/generated.json"
+    ret=$?
+  fi
+
+  unset SERVERSETUP_SERVER_NAME SERVERSETUP_SERVER_DOMAINNAME
+
+  if [ "$ret" -ne 0 ]; then
+    fail "$name" "autocfg returned $ret"
+    return 0
+  fi
+
+  # Compare the parsed documents including member order. Formatting differs
+  python3 -c 'import json, sys; sys.exit (json.dumps (json.load (open (sys.argv[1]))) != json.dumps (json.load (open (sys.argv[2]))))' "$dir/template.json" "$dir/generated.json"
+
+  if [ $? -ne 0 ]; then
+    fail "$name" "documents differ"
+  else
+    pass "$name"
+  fi
+}
+
+
+if [ -n "$1" ]; then
+  AUTOCFG="$1"
+fi
+
+if [ ! -x "$AUTOCFG" ]; then
+  log "autocfg binary not found: $AUTOCFG"
+  exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+test_empty_include
+test_empty_template
+test_generate_template
+
+log
+log "Tests: $((PASSED + FAILED)), passed: $PASSED, failed: $FAILED"
+
+exit "$FAILED"
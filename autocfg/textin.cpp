@@ -0,0 +1,410 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define TEXT_USE_SSE2
+#endif
+
+#include "cfg.hpp"
+#include "textin.hpp"
+
+size_t Utf16ToUtf8 (const unsigned char *pInput, size_t Units, int BigEndian, char *pOutput, size_t *retpUnitsUsed)
+{
+    /* Converts complete UTF-16 units to UTF-8. A high surrogate at the end is left for the next block.
+       Runs of ASCII characters are converted 8 units at a time with SSE2 */
+
+    size_t i    = 0;
+    size_t Out  = 0;
+    unsigned int c  = 0;
+    unsigned int c2 = 0;
+
+#ifdef TEXT_USE_SSE2
+    __m128i v;
+    const __m128i NonAscii = _mm_set1_epi16 ((short) 0xFF80);
+    const __m128i Zero     = _mm_setzero_si128();
+#endif
+
+    while (i < Units)
+    {
+
+#ifdef TEXT_USE_SSE2
+
+        while (i + 8 <= Units)
+        {
+            v = _mm_loadu_si128 ((const __m128i *) (pInput + i*2));
+
+            if (BigEndian)
+                v = _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+
+            /* Non ASCII units are converted by the scalar code below */
+            if (0xFFFF != _mm_movemask_epi8 (_mm_cmpeq_epi16 (_mm_and_si128 (v, NonAscii), Zero)))
+                break;
+
+            _mm_storel_epi64 ((__m128i *) (pOutput + Out), _mm_packus_epi16 (v, v));
+
+            i   += 8;
+            Out += 8;
+        }
+
+        if (i >= Units)
+            break;
+
+#endif
+
+        if (BigEndian)
+            c = (pInput[i*2] << 8) | pInput[i*2+1];
+        else
+            c = pInput[i*2] | (pInput[i*2+1] << 8);
+
+        if (c < 0x80)
+        {
+            pOutput[Out++] = (char) c;
+        }
+        else if (c < 0x800)
+        {
+            pOutput[Out++] = (char) (0xC0 | (c >> 6));
+            pOutput[Out++] = (char) (0x80 | (c & 0x3F));
+        }
+        else
+        {
+            if ( (c >= 0xD800) && (c <= 0xDBFF) )
+            {
+                /* High surrogate: Needs the next unit */
+                if (i + 1 >= Units)
+                    break;
+
+                if (BigEndian)
+                    c2 = (pInput[i*2+2] << 8) | pInput[i*2+3];
+                else
+                    c2 = pInput[i*2+2] | (pInput[i*2+3] << 8);
+
+                if ( (c2 >= 0xDC00) && (c2 <= 0xDFFF) )
+                {
+                    c = 0x10000 + ((c - 0xD800) << 10) + (c2 - 0xDC00);
+                    i += 2;
+
+                    pOutput[Out++] = (char) (0xF0 | (c >> 18));
+                    pOutput[Out++] = (char) (0x80 | ((c >> 12) & 0x3F));
+                    pOutput[Out++] = (char) (0x80 | ((c >> 6) & 0x3F));
+                    pOutput[Out++] = (char) (0x80 | (c & 0x3F));
+                    continue;
+                }
+
+                /* Unpaired surrogate */
+                c = 0xFFFD;
+            }
+            else if ( (c >= 0xDC00) && (c <= 0xDFFF) )
+            {
+                c = 0xFFFD;
+            }
+
+            pOutput[Out++] = (char) (0xE0 | (c >> 12));
+            pOutput[Out++] = (char) (0x80 | ((c >> 6) & 0x3F));
+            pOutput[Out++] = (char) (0x80 | (c & 0x3F));
+        }
+
+        i++;
+    }
+
+    if (retpUnitsUsed)
+        *retpUnitsUsed = i;
+
+    return Out;
+}
+
+
+int DetectTextEncoding (const unsigned char *pData, size_t Size, size_t *retpBomSize)
+{
+    /* Detects encoding by BOM. UTF-16 without BOM is detected if the text starts with two ASCII characters */
+
+    size_t Bom = 0;
+    int    Encoding = TEXT_ENCODING_UTF8;
+
+    if ( (Size >= 3) && (0xEF == pData[0]) && (0xBB == pData[1]) && (0xBF == pData[2]) )
+    {
+        Encoding = TEXT_ENCODING_UTF8_BOM;
+        Bom = 3;
+    }
+    else if ( (Size >= 2) && (0xFF == pData[0]) && (0xFE == pData[1]) )
+    {
+        Encoding = TEXT_ENCODING_UTF16LE;
+        Bom = 2;
+    }
+    else if ( (Size >= 2) && (0xFE == pData[0]) && (0xFF == pData[1]) )
+    {
+        Encoding = TEXT_ENCODING_UTF16BE;
+        Bom = 2;
+    }
+    else if ( (Size >= 4) && (pData[0]) && (0 == pData[1]) && (pData[2]) && (0 == pData[3]) )
+    {
+        Encoding = TEXT_ENCODING_UTF16LE;
+    }
+    else if ( (Size >= 4) && (0 == pData[0]) && (pData[1]) && (0 == pData[2]) && (pData[3]) )
+    {
+        Encoding = TEXT_ENCODING_UTF16BE;
+    }
+
+    if (retpBomSize)
+        *retpBomSize = Bom;
+
+    return Encoding;
+}
+
+
+TextInput::TextInput()
+{
+    m_fp       = NULL;
+    m_Owner    = 0;
+    m_Encoding = TEXT_ENCODING_UTF8;
+    m_Detected = 0;
+    m_Eof      = 0;
+    m_pRaw     = NULL;
+    m_RawLen   = 0;
+    m_pOut     = NULL;
+    m_OutPos   = 0;
+    m_OutLen   = 0;
+}
+
+TextInput::~TextInput()
+{
+    Close();
+
+    if (m_pRaw)
+    {
+        free (m_pRaw);
+        m_pRaw = NULL;
+    }
+
+    if (m_pOut)
+    {
+        free (m_pOut);
+        m_pOut = NULL;
+    }
+}
+
+int TextInput::Init()
+{
+    m_Encoding = TEXT_ENCODING_UTF8;
+    m_Detected = 0;
+    m_Eof      = 0;
+    m_RawLen   = 0;
+    m_OutPos   = 0;
+    m_OutLen   = 0;
+
+    if (NULL == m_pRaw)
+        m_pRaw = (unsigned char *) malloc (TEXT_RAW_BUFFER_SIZE);
+
+    if (NULL == m_pOut)
+        m_pOut = (char *) malloc (TEXT_OUT_BUFFER_SIZE);
+
+    if ( (NULL == m_pRaw) || (NULL == m_pOut) )
+    {
+        printf ("\nError: Cannot allocate input buffer\n\n");
+        return 2;
+    }
+
+    return 0;
+}
+
+int TextInput::Open (const char *pszFileName)
+{
+    Close();
+
+    /* Binary mode is required to detect and convert UTF-16 */
+    m_fp = fopen (pszFileName, "rb");
+
+    if (NULL == m_fp)
+        return 1;
+
+    m_Owner = 1;
+
+    return Init();
+}
+
+int TextInput::Attach (FILE *fp)
+{
+    Close();
+
+    if (NULL == fp)
+        return 1;
+
+    m_fp    = fp;
+    m_Owner = 0;
+
+    return Init();
+}
+
+void TextInput::Close()
+{
+    if ( (m_fp) && (m_Owner) )
+        fclose (m_fp);
+
+    m_fp    = NULL;
+    m_Owner = 0;
+}
+
+void TextInput::Detect()
+{
+    /* Called once with the first block of raw data */
+
+    size_t Skip = 0;
+
+    m_Detected = 1;
+    m_Encoding = DetectTextEncoding (m_pRaw, m_RawLen, &Skip);
+
+    if (Skip)
+    {
+        m_RawLen -= Skip;
+        memmove (m_pRaw, m_pRaw + Skip, m_RawLen);
+    }
+}
+
+int TextInput::Fill()
+{
+    /* Reads the next block and converts it into the output buffer. Returns 0 at end of input */
+
+    size_t Read  = 0;
+    size_t Units = 0;
+    size_t Used  = 0;
+
+    m_OutPos = 0;
+    m_OutLen = 0;
+
+    if (NULL == m_fp)
+        return 0;
+
+    while (0 == m_OutLen)
+    {
+        if (m_Eof)
+            return 0;
+
+        Read = fread (m_pRaw + m_RawLen, 1, TEXT_RAW_BUFFER_SIZE - m_RawLen, m_fp);
+
+        if (0 == Read)
+            m_Eof = 1;
+
+        m_RawLen += Read;
+
+        if (0 == m_Detected)
+            Detect();
+
+        if ( (TEXT_ENCODING_UTF8 == m_Encoding) || (TEXT_ENCODING_UTF8_BOM == m_Encoding) )
+        {
+            memcpy (m_pOut, m_pRaw, m_RawLen);
+            m_OutLen = m_RawLen;
+            m_RawLen = 0;
+            continue;
+        }
+
+        Units = m_RawLen / 2;
+        m_OutLen = Utf16ToUtf8 (m_pRaw, Units, TEXT_ENCODING_UTF16BE == m_Encoding, m_pOut, &Used);
+
+        /* Incomplete unit or surrogate pair at end of input cannot be completed */
+        if ( (m_Eof) && (0 == m_OutLen) )
+        {
+            m_RawLen = 0;
+            return 0;
+        }
+
+        /* Keep an incomplete unit or surrogate pair for the next block */
+        m_RawLen -= Used * 2;
+        memmove (m_pRaw, m_pRaw + Used * 2, m_RawLen);
+    }
+
+    return 1;
+}
+
+char *TextInput::GetLine (char *pszBuffer, int MaxSize)
+{
+    /* Same semantics as fgets() */
+
+    int  len = 0;
+    char *pEol = NULL;
+    size_t Avail = 0;
+
+    if (MaxSize < 2)
+        return NULL;
+
+    while (len < MaxSize-1)
+    {
+        if ( (m_OutPos >= m_OutLen) && (0 == Fill()) )
+            break;
+
+        Avail = m_OutLen - m_OutPos;
+
+        if (Avail > (size_t) (MaxSize - 1 - len))
+            Avail = MaxSize - 1 - len;
+
+        pEol = (char *) memchr (m_pOut + m_OutPos, '\n', Avail);
+
+        if (pEol)
+            Avail = pEol - (m_pOut + m_OutPos) + 1;
+
+        memcpy (pszBuffer + len, m_pOut + m_OutPos, Avail);
+        len      += (int) Avail;
+        m_OutPos += Avail;
+
+        if (pEol)
+            break;
+    }
+
+    if (0 == len)
+        return NULL;
+
+#ifdef _WIN32
+    /* Input is read in binary mode. Keep text mode line ends for output in text mode */
+    if ( (len >= 2) && ('\r' == pszBuffer[len-2]) && ('\n' == pszBuffer[len-1]) )
+    {
+        pszBuffer[len-2] = '\n';
+        len--;
+    }
+#endif
+
+    pszBuffer[len] = '\0';
+    return pszBuffer;
+}
+
+size_t TextInput::Read (char *pBuffer, size_t Size)
+{
+    size_t Total = 0;
+    size_t Avail = 0;
+
+    while (Total < Size)
+    {
+        if ( (m_OutPos >= m_OutLen) && (0 == Fill()) )
+            break;
+
+        Avail = m_OutLen - m_OutPos;
+
+        if (Avail > Size - Total)
+            Avail = Size - Total;
+
+        memcpy (pBuffer + Total, m_pOut + m_OutPos, Avail);
+        Total    += Avail;
+        m_OutPos += Avail;
+    }
+
+    return Total;
+}
@@ -0,0 +1,83 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef TEXTIN_HPP
+    #define TEXTIN_HPP
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define TEXT_ENCODING_UTF8      0
+#define TEXT_ENCODING_UTF8_BOM  1
+#define TEXT_ENCODING_UTF16LE   2
+#define TEXT_ENCODING_UTF16BE   3
+
+#define TEXT_RAW_BUFFER_SIZE    65536
+
+/* UTF-16 needs at most 3 UTF-8 bytes per 2 byte unit */
+#define TEXT_OUT_BUFFER_SIZE    (TEXT_RAW_BUFFER_SIZE / 2 * 3 + 16)
+
+
+/* Text input reader with encoding detection (UTF-8 BOM, UTF-16LE/BE with or without BOM).
+   UTF-16 input is converted to UTF-8 block by block while reading, memory use is fixed */
+
+class TextInput
+{
+
+public:
+
+    TextInput();
+    ~TextInput();
+
+    int    Open    (const char *pszFileName);
+    int    Attach  (FILE *fp);
+    void   Close   ();
+    char   *GetLine (char *pszBuffer, int MaxSize);
+    size_t Read    (char *pBuffer, size_t Size);
+
+    int GetEncoding()
+    {
+        return m_Encoding;
+    }
+
+private:
+
+    int  Init   ();
+    void Detect ();
+    int  Fill   ();
+
+    FILE   *m_fp;
+    int    m_Owner;
+    int    m_Encoding;
+    int    m_Detected;
+    int    m_Eof;
+
+    unsigned char *m_pRaw;
+    size_t m_RawLen;
+
+    char   *m_pOut;
+    size_t m_OutPos;
+    size_t m_OutLen;
+};
+
+int    DetectTextEncoding (const unsigned char *pData, size_t Size, size_t *retpBomSize);
+size_t Utf16ToUtf8 (const unsigned char *pInput, size_t Units, int BigEndian, char *pOutput, size_t *retpUnitsUsed);
+
+#endif
@@ -0,0 +1,438 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "tplcache.hpp"
+#include "textin.hpp"
+
+TemplateCache g_TemplateCache;
+
+TemplateCache::TemplateCache()
+{
+    m_pEntries = NULL;
+    m_lLoads   = 0;
+}
+
+TemplateCache::~TemplateCache()
+{
+    TEMPLATE_ENTRY *pEntry = m_pEntries;
+    TEMPLATE_ENTRY *pNext  = NULL;
+
+    while (pEntry)
+    {
+        pNext = pEntry->pNext;
+        FreeEntry (pEntry);
+        pEntry = pNext;
+    }
+
+    m_pEntries = NULL;
+}
+
+void TemplateCache::FreeEntry (TEMPLATE_ENTRY *pEntry)
+{
+    if (NULL == pEntry)
+        return;
+
+    if (pEntry->pData)
+        free (pEntry->pData);
+
+    if (pEntry->pNames)
+        free (pEntry->pNames);
+
+    if (pEntry->pLines)
+        free (pEntry->pLines);
+
+    if (pEntry->pParts)
+        free (pEntry->pParts);
+
+    free (pEntry);
+}
+
+void TemplateCache::Unlink (TEMPLATE_ENTRY *pEntry)
+{
+    TEMPLATE_ENTRY **ppEntry = &m_pEntries;
+
+    while (*ppEntry)
+    {
+        if (*ppEntry == pEntry)
+        {
+            *ppEntry = pEntry->pNext;
+            pEntry->pNext = NULL;
+            return;
+        }
+
+        ppEntry = &(*ppEntry)->pNext;
+    }
+}
+
+static const char *FindMarker (const char *p, const char *pEnd, const char *pszMarker)
+{
+    /* Finds a two character marker within a line, which is not null terminated */
+
+    while (p+1 < pEnd)
+    {
+        p = (const char *) memchr (p, pszMarker[0], pEnd - p - 1);
+
+        if (NULL == p)
+            return NULL;
+
+        if (pszMarker[1] == p[1])
+            return p;
+
+        p++;
+    }
+
+    return NULL;
+}
+
+static const char *CopyName (char **ppNext, const char *pName, size_t len)
+{
+    char *pszName = *ppNext;
+
+    memcpy (pszName, pName, len);
+    pszName[len] = '\0';
+    *ppNext += len + 1;
+
+    return pszName;
+}
+
+static int IsDirective (const char *p, const char *pEnd, const char *pszMarker)
+{
+    size_t len = strlen (pszMarker);
+
+    return ( ((size_t) (pEnd - p) >= len) && (0 == memcmp (p, pszMarker, len)) );
+}
+
+int TemplateCache::AddLine (TEMPLATE_ENTRY *pEntry, int Type, const char *pLine, size_t Len, const char *pszName)
+{
+    /* A text line owns the parts added since the previous line */
+
+    TEMPLATE_LINE *pNew  = NULL;
+    TEMPLATE_LINE *pLast = NULL;
+
+    if (pEntry->Lines >= pEntry->LinesMax)
+    {
+        pNew = (TEMPLATE_LINE *) realloc (pEntry->pLines, (pEntry->LinesMax + 1024) * sizeof (TEMPLATE_LINE));
+
+        if (NULL == pNew)
+            return 1;
+
+        pEntry->pLines    = pNew;
+        pEntry->LinesMax += 1024;
+    }
+
+    pLast = pEntry->Lines ? pEntry->pLines + pEntry->Lines - 1 : NULL;
+    pNew  = pEntry->pLines + pEntry->Lines;
+
+    pNew->Type      = Type;
+    pNew->pLine     = pLine;
+    pNew->Len       = Len;
+    pNew->FirstPart = pLast ? pLast->FirstPart + pLast->Parts : 0;
+    pNew->Parts     = pEntry->Parts - pNew->FirstPart;
+    pNew->pszName   = pszName;
+
+    pEntry->Lines++;
+
+    return 0;
+}
+
+int TemplateCache::AddPart (TEMPLATE_ENTRY *pEntry, const char *pText, size_t TextLen, const char *pszName)
+{
+    TEMPLATE_PART *pNew = NULL;
+
+    if (pEntry->Parts >= pEntry->PartsMax)
+    {
+        pNew = (TEMPLATE_PART *) realloc (pEntry->pParts, (pEntry->PartsMax + 1024) * sizeof (TEMPLATE_PART));
+
+        if (NULL == pNew)
+            return 1;
+
+        pEntry->pParts    = pNew;
+        pEntry->PartsMax += 1024;
+    }
+
+    pNew = pEntry->pParts + pEntry->Parts;
+
+    pNew->pText   = pText;
+    pNew->TextLen = TextLen;
+    pNew->pszName = pszName;
+
+    pEntry->Parts++;
+
+    return 0;
+}
+
+int TemplateCache::Compile (TEMPLATE_ENTRY *pEntry)
+{
+    /* Splits the data into lines like AutoConfig::RenderData() and the lines into text and placeholders like AutoConfig::CheckWriteBuffer().
+       Names are stored null terminated in pNames. Each name is shorter than its placeholder, so pNames is never larger than the data */
+
+    size_t len = 0;
+    const char *p        = pEntry->pData;
+    const char *pEnd     = pEntry->pData + pEntry->Size;
+    const char *pLine    = NULL;
+    const char *pLineEnd = NULL;
+    const char *pText    = NULL;
+    const char *pBegin   = NULL;
+    const char *pClose   = NULL;
+    const char *pName    = NULL;
+    const char *pNameEnd = NULL;
+    char *pNextName      = NULL;
+
+    char szName[MAX_BUFFER+1] = {0};
+
+    pEntry->pNames = (char *) malloc (pEntry->Size + 1);
+
+    if (NULL == pEntry->pNames)
+        return 1;
+
+    pNextName = pEntry->pNames;
+
+    while (p < pEnd)
+    {
+        pLine = p;
+        pLineEnd = (const char *) memchr (p, '\n', pEnd - p);
+        len = pLineEnd ? (size_t) (pLineEnd - p + 1) : (size_t) (pEnd - p);
+
+        if (len >= TEMPLATE_MAX_LINE)
+            len = TEMPLATE_MAX_LINE - 1;
+
+        p += len;
+
+        /* A line copied to a string for rendering ends at a null character */
+        pLineEnd = pLine;
+
+        while ( (pLineEnd < p) && (*pLineEnd) )
+            pLineEnd++;
+
+        pText = pLine;
+
+        while ( (pText < pLineEnd) && ( (' ' == *pText) || ('\t' == *pText) ) )
+            pText++;
+
+        if (IsDirective (pText, pLineEnd, INCLUDE_MARKER))
+        {
+            pClose = FindMarker (pText, pLineEnd, "}}");
+
+            if ( (pClose) && (GetPlaceholderName (pText + strlen (INCLUDE_MARKER) - 2, pClose, szName, sizeof (szName))) )
+            {
+                if (AddLine (pEntry, TEMPLATE_LINE_INCLUDE, pLine, len, CopyName (&pNextName, szName, strlen (szName))))
+                    return 1;
+
+                continue;
+            }
+        }
+
+        if (IsDirective (pText, pLineEnd, EACH_BEGIN_MARKER))
+        {
+            pClose = FindMarker (pText, pLineEnd, "}}");
+
+            if ( (pClose) && (GetPlaceholderName (pText + strlen (EACH_BEGIN_MARKER) - 2, pClose, szName, MAX_ENTRY_LEN+1)) )
+            {
+                if (AddLine (pEntry, TEMPLATE_LINE_EACH, pLine, len, CopyName (&pNextName, szName, strlen (szName))))
+                    return 1;
+
+                continue;
+            }
+        }
+
+        pText = pLine;
+
+        while (1)
+        {
+            pBegin = FindMarker (pText, pLineEnd, "{{");
+            pClose = pBegin ? FindMarker (pBegin+2, pLineEnd, "}}") : NULL;
+
+            if (NULL == pClose)
+            {
+                if (AddPart (pEntry, pText, pLineEnd - pText, NULL))
+                    return 1;
+
+                break;
+            }
+
+            pName = pBegin + 2;
+
+            while ( (pName < pClose) && (' ' == *pName) )
+                pName++;
+
+            pNameEnd = pClose;
+
+            while ( (pNameEnd > pName) && (' ' == *(pNameEnd-1)) )
+                pNameEnd--;
+
+            if (AddPart (pEntry, pText, pBegin - pText, CopyName (&pNextName, pName, pNameEnd - pName)))
+                return 1;
+
+            pText = pClose + 2;
+        }
+
+        if (AddLine (pEntry, TEMPLATE_LINE_TEXT, pLine, len, NULL))
+            return 1;
+    }
+
+    return 0;
+}
+
+TEMPLATE_ENTRY *TemplateCache::ReadTemplate (const char *pszPath, time_t tModified, long lFileSize)
+{
+    size_t Read = 0;
+    size_t Want = 0;
+    size_t Max  = 0;
+    char   *pNewData = NULL;
+    TEMPLATE_ENTRY *pEntry = NULL;
+    TextInput Input;
+
+    pEntry = (TEMPLATE_ENTRY *) calloc (1, sizeof (TEMPLATE_ENTRY));
+
+    if (NULL == pEntry)
+        goto Done;
+
+    strdncpy (pEntry->szPath, pszPath, sizeof (pEntry->szPath));
+    pEntry->tModified = tModified;
+    pEntry->lFileSize = lFileSize;
+
+    if (Input.Open (pszPath))
+    {
+        printf ("\nError: Cannot open input file: [%s]\n\n", pszPath);
+        goto Error;
+    }
+
+    /* Converted UTF-16 input can be larger than the file */
+    Max = lFileSize + 1;
+
+    while (1)
+    {
+        pNewData = (char *) realloc (pEntry->pData, Max);
+
+        if (NULL == pNewData)
+        {
+            printf ("\nError: Cannot allocate template buffer (%lu)\n\n", (unsigned long) Max);
+            goto Error;
+        }
+
+        pEntry->pData = pNewData;
+
+        Want = Max - 1 - pEntry->Size;
+        Read = Input.Read (pEntry->pData + pEntry->Size, Want);
+        pEntry->Size += Read;
+
+        /* End of input. An empty file reads nothing into the initial one byte buffer and grows it once */
+        if (Read < Want)
+            break;
+
+        Max = Max * 2 + TEXT_RAW_BUFFER_SIZE;
+    }
+
+    pEntry->pData[pEntry->Size] = '\0';
+
+    if (Compile (pEntry))
+    {
+        printf ("\nError: Cannot allocate template index: [%s]\n\n", pszPath);
+        goto Error;
+    }
+
+    goto Done;
+
+Error:
+
+    FreeEntry (pEntry);
+    pEntry = NULL;
+
+Done:
+
+    Input.Close();
+
+    return pEntry;
+}
+
+TEMPLATE_ENTRY *TemplateCache::Get (const char *pszPath)
+{
+    struct stat FileStat = {0};
+    TEMPLATE_ENTRY *pEntry = NULL;
+    TEMPLATE_ENTRY *pOld   = NULL;
+
+    if (IsNullStr (pszPath))
+        return NULL;
+
+    if (stat (pszPath, &FileStat))
+    {
+        printf ("\nError: Cannot open input file: [%s]\n\n", pszPath);
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> Lock (m_Mutex);
+
+    for (pEntry = m_pEntries; pEntry; pEntry = pEntry->pNext)
+    {
+        if (0 == strcmp (pEntry->szPath, pszPath))
+            break;
+    }
+
+    if ( (pEntry) && (pEntry->tModified == FileStat.st_mtime) && (pEntry->lFileSize == (long) FileStat.st_size) )
+    {
+        pEntry->Refs++;
+        return pEntry;
+    }
+
+    pOld = pEntry;
+
+    pEntry = ReadTemplate (pszPath, FileStat.st_mtime, (long) FileStat.st_size);
+
+    if (NULL == pEntry)
+        return NULL;
+
+    m_lLoads++;
+
+    /* Replace the outdated entry. It stays valid until released by all current users */
+    if (pOld)
+    {
+        Unlink (pOld);
+
+        if (pOld->Refs)
+            pOld->Stale = 1;
+        else
+            FreeEntry (pOld);
+    }
+
+    pEntry->Refs  = 1;
+    pEntry->pNext = m_pEntries;
+    m_pEntries    = pEntry;
+
+    return pEntry;
+}
+
+void TemplateCache::Release (TEMPLATE_ENTRY *pEntry)
+{
+    if (NULL == pEntry)
+        return;
+
+    std::lock_guard<std::mutex> Lock (m_Mutex);
+
+    if (pEntry->Refs > 0)
+        pEntry->Refs--;
+
+    if ( (pEntry->Stale) && (0 == pEntry->Refs) )
+        FreeEntry (pEntry);
+}
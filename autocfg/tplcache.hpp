@@ -0,0 +1,107 @@
+/*
+###########################################################################
+# Domino Auto Config (OneTouchConfig Tool)                                #
+# Version 0.3.0 19.10.2026                                                #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef TPLCACHE_HPP
+    #define TPLCACHE_HPP
+
+#include <stddef.h>
+#include <time.h>
+
+#include <mutex>
+
+#include "cfg.hpp"
+
+#define TEMPLATE_MAX_LINE      10240   /* Lines are split like rendered from a buffer */
+
+#define TEMPLATE_LINE_TEXT     0       /* Text and placeholders */
+#define TEMPLATE_LINE_INCLUDE  1       /* {{> <file> }} on a separate line */
+#define TEMPLATE_LINE_EACH     2       /* {{#each <family> }} on a separate line */
+
+typedef struct {
+    const char *pText;                 /* Text written before the placeholder */
+    size_t     TextLen;
+    const char *pszName;               /* Trimmed placeholder name, NULL for the text at the end of the line */
+} TEMPLATE_PART;
+
+typedef struct {
+    int    Type;
+    const char *pLine;                 /* Line in the template data including the line break */
+    size_t Len;
+    int    FirstPart;
+    int    Parts;
+    const char *pszName;               /* Include file or family of a separate line directive */
+} TEMPLATE_LINE;
+
+typedef struct _TEMPLATE_ENTRY {
+    char   szPath[MAX_BUFFER+1];
+    time_t tModified;
+    long   lFileSize;
+    char   *pData;
+    size_t Size;
+    char   *pNames;
+    TEMPLATE_LINE *pLines;
+    int    Lines;
+    int    LinesMax;
+    TEMPLATE_PART *pParts;
+    int    Parts;
+    int    PartsMax;
+    int    Refs;
+    int    Stale;
+    struct _TEMPLATE_ENTRY *pNext;
+} TEMPLATE_ENTRY;
+
+
+/* Process wide cache of template files kept in memory by path and modification time.
+   Each template is split into lines, placeholders and directives once when it is read. Rendering only looks up the names.
+   Entries are reference counted. A changed file is read again and the old entry is freed when the last user releases it */
+
+class TemplateCache
+{
+
+public:
+
+    TemplateCache();
+    ~TemplateCache();
+
+    TEMPLATE_ENTRY *Get (const char *pszPath);
+    void Release (TEMPLATE_ENTRY *pEntry);
+
+    long GetLoadCount()
+    {
+        return m_lLoads;
+    }
+
+private:
+
+    TEMPLATE_ENTRY *ReadTemplate (const char *pszPath, time_t tModified, long lFileSize);
+    int  Compile (TEMPLATE_ENTRY *pEntry);
+    int  AddLine (TEMPLATE_ENTRY *pEntry, int Type, const char *pLine, size_t Len, const char *pszName);
+    int  AddPart (TEMPLATE_ENTRY *pEntry, const char *pText, size_t TextLen, const char *pszName);
+    void Unlink (TEMPLATE_ENTRY *pEntry);
+    void FreeEntry (TEMPLATE_ENTRY *pEntry);
+
+    std::mutex m_Mutex;
+    TEMPLATE_ENTRY *m_pEntries;
+    long m_lLoads;
+};
+
+extern TemplateCache g_TemplateCache;
+
+#endif
@@ -0,0 +1,608 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <errno.h>
+
+#ifdef UNIX
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#else
+#include <io.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "dominoinstall.hpp"
+#include "tarinst.hpp"
+#include "batch.hpp"
+
+#ifdef UNIX
+extern char **environ;
+#endif
+
+#define BATCH_DEPENDENCY_READY    0
+#define BATCH_DEPENDENCY_WAIT     1
+#define BATCH_DEPENDENCY_BLOCKED  2
+
+
+static void GetSelfPath (char *retpszPath, size_t BufferSize, const char *pszArgv0)
+{
+    /* The packages are installed by the same binary. argv[0] is only used if the binary path cannot be determined */
+
+#ifdef __linux__
+    ssize_t len = readlink ("/proc/self/exe", retpszPath, BufferSize-1);
+
+    if (len > 0)
+    {
+        retpszPath[len] = '\0';
+        return;
+    }
+#elif !defined(UNIX)
+    if (GetModuleFileName (NULL, retpszPath, (DWORD) BufferSize))
+        return;
+#endif
+
+    strdncpy (retpszPath, pszArgv0, BufferSize);
+}
+
+static const char *GetStateName (int State)
+{
+    switch (State)
+    {
+        case BATCH_INSTALLED:
+            return "installed";
+
+        case BATCH_FAILED:
+            return "failed";
+
+        case BATCH_SKIPPED:
+            return "skipped";
+
+        default:
+            return "not installed";
+    } /* switch */
+}
+
+
+BatchInstaller::BatchInstaller()
+{
+    memset (m_Packages, 0, sizeof (m_Packages));
+
+    m_Count         = 0;
+    m_pszSelf       = NULL;
+    m_pszProgramDir = NULL;
+    m_pszDataDir    = NULL;
+    m_Threads       = 0;
+    m_bHardLinks    = FALSE;
+    m_bEventLog     = FALSE;
+    m_FanOutDataDirs = 0;
+
+    memset (m_pszFanOutDataDirs, 0, sizeof (m_pszFanOutDataDirs));
+}
+
+BatchInstaller::~BatchInstaller()
+{
+    int i = 0;
+
+    for (i=0; i<m_Count; i++)
+    {
+        if (m_Packages[i].fpOutput)
+        {
+            fclose (m_Packages[i].fpOutput);
+            m_Packages[i].fpOutput = NULL;
+        }
+    }
+}
+
+int BatchInstaller::AddPackage (const char *pszPackage)
+{
+    if (IsNullStr (pszPackage))
+        return 1;
+
+    if (m_Count >= BATCH_MAX_PACKAGES)
+    {
+        printf ("Too many packages, maximum is %d\n", BATCH_MAX_PACKAGES);
+        return 1;
+    }
+
+    strdncpy (m_Packages[m_Count].szPath, pszPackage, sizeof (m_Packages[m_Count].szPath));
+    m_Count++;
+
+    return 0;
+}
+
+int BatchInstaller::AddDataDirectory (const char *pszDataDir)
+{
+    /* Further data directories of a partitioned server are passed to each install */
+
+    if (m_FanOutDataDirs >= MAX_DATA_DIRS)
+        return 1;
+
+    m_pszFanOutDataDirs[m_FanOutDataDirs++] = pszDataDir;
+    return 0;
+}
+
+BATCH_PACKAGE *BatchInstaller::Find (const char *pszName, size_t len)
+{
+    int i = 0;
+
+    for (i=0; i<m_Count; i++)
+    {
+        if ((len == strlen (m_Packages[i].Info.szName)) && (0 == strncmp (m_Packages[i].Info.szName, pszName, len)))
+            return &m_Packages[i];
+    }
+
+    return NULL;
+}
+
+int BatchInstaller::ReadPackageInfo (BATCH_PACKAGE *pPackage)
+{
+    struct stat Stat = {0};
+    TarInstaller TarInstall;
+
+    char szInstallIni[1100] = {0};
+
+    if (stat (pPackage->szPath, &Stat))
+    {
+        snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "package not found");
+        return 1;
+    }
+
+    if (S_IFDIR == (Stat.st_mode & S_IFMT))
+    {
+        BuildPath (szInstallIni, sizeof (szInstallIni), pPackage->szPath, "install.ini");
+        GetSoftwareInfoFromFile (&pPackage->Info, szInstallIni);
+    }
+    else
+    {
+        /* install.ini is the first file of an archive */
+        pPackage->bArchive = TRUE;
+
+        if (TarInstall.Open (pPackage->szPath) || TarInstall.ReadInstallIni())
+        {
+            snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "cannot read install.ini from archive");
+            return 1;
+        }
+
+        GetSoftwareInfoFromBuffer (&pPackage->Info, TarInstall.GetInstallIni());
+    }
+
+    if (!*pPackage->Info.szName || !*pPackage->Info.szVersion)
+    {
+        snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "no software name or version found");
+        return 1;
+    }
+
+    return 0;
+}
+
+int BatchInstaller::CheckDependencies (BATCH_PACKAGE *pPackage, const char *pszInstallRegDir)
+{
+    /* Dependencies are other packages of the batch or software installed before */
+
+    int  ret = BATCH_DEPENDENCY_READY;
+    size_t len = 0;
+    const char *p = pPackage->Info.szDepends;
+    BATCH_PACKAGE *pDependency = NULL;
+    struct stat Stat = {0};
+
+    char szName[1024]         = {0};
+    char szInstallIni[2200]   = {0};
+
+    while (*p)
+    {
+        p  += strspn (p, ", ;\t");
+        len = strcspn (p, ", ;\t");
+
+        if (0 == len)
+            break;
+
+        pDependency = Find (p, len);
+
+        if (pDependency)
+        {
+            if ((BATCH_FAILED == pDependency->State) || (BATCH_SKIPPED == pDependency->State))
+            {
+                snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "dependency [%s] %s", pDependency->Info.szName, GetStateName (pDependency->State));
+                return BATCH_DEPENDENCY_BLOCKED;
+            }
+
+            if (BATCH_INSTALLED != pDependency->State)
+                ret = BATCH_DEPENDENCY_WAIT;
+        }
+        else
+        {
+            if (len >= sizeof (szName))
+                len = sizeof (szName) - 1;
+
+            memcpy (szName, p, len);
+            szName[len] = '\0';
+
+            snprintf (szInstallIni, sizeof (szInstallIni)-1, "%s%c%s%cinstall.ini", pszInstallRegDir, g_OsDirSep, szName, g_OsDirSep);
+
+            if (stat (szInstallIni, &Stat))
+            {
+                snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "dependency [%s] not installed", szName);
+                return BATCH_DEPENDENCY_BLOCKED;
+            }
+        }
+
+        p += len;
+    }
+
+    return ret;
+}
+
+int BatchInstaller::Start (BATCH_PACKAGE *pPackage)
+{
+    int  ret  = 0;
+    int  i    = 0;
+    int  Argc = 0;
+    const char *Args[10+MAX_DATA_DIRS] = {0};
+
+    char szSource[1100]  = {0};
+    char szBin[1100]     = {0};
+    char szData[1100]    = {0};
+    char szThreads[40]   = {0};
+    char szFanOutData[MAX_DATA_DIRS][1100] = {0};
+
+    snprintf (szSource, sizeof (szSource)-1, "%s%s", pPackage->bArchive ? "-tar=" : "-dir=", pPackage->szPath);
+    snprintf (szBin,    sizeof (szBin)-1,    "-bin=%s",  m_pszProgramDir);
+    snprintf (szData,   sizeof (szData)-1,   "-data=%s", m_pszDataDir);
+
+    Args[Argc++] = m_pszSelf;
+    Args[Argc++] = szSource;
+    Args[Argc++] = szBin;
+    Args[Argc++] = szData;
+
+    for (i=0; i<m_FanOutDataDirs; i++)
+    {
+        snprintf (szFanOutData[i], sizeof (szFanOutData[i])-1, "-data=%s", m_pszFanOutDataDirs[i]);
+        Args[Argc++] = szFanOutData[i];
+    }
+
+    if (m_Threads)
+    {
+        snprintf (szThreads, sizeof (szThreads)-1, "-threads=%d", m_Threads);
+        Args[Argc++] = szThreads;
+    }
+
+    if (m_bHardLinks)
+        Args[Argc++] = "-hardlink";
+
+    /* Each package writes its own install.jsonl to its registration directory */
+    if (m_bEventLog)
+        Args[Argc++] = "-eventlog";
+
+    Args[Argc] = NULL;
+
+    /* Output of concurrent installs is collected and printed when the package is finished */
+    pPackage->fpOutput = tmpfile();
+
+    if (NULL == pPackage->fpOutput)
+    {
+        snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "cannot create output file");
+        return 1;
+    }
+
+    fflush (stdout);
+    pPackage->StartTime = time (NULL);
+
+#ifdef UNIX
+
+    posix_spawn_file_actions_t Actions;
+
+    posix_spawn_file_actions_init (&Actions);
+    posix_spawn_file_actions_adddup2 (&Actions, fileno (pPackage->fpOutput), 1);
+    posix_spawn_file_actions_adddup2 (&Actions, fileno (pPackage->fpOutput), 2);
+
+    ret = posix_spawnp (&pPackage->Pid, m_pszSelf, &Actions, NULL, (char * const *) Args, environ);
+
+    posix_spawn_file_actions_destroy (&Actions);
+
+    if (ret)
+    {
+        snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "cannot start install: %s", strerror (ret));
+        return 1;
+    }
+
+#else
+
+    int  fdStdout = 0;
+    char szQuoted[10+MAX_DATA_DIRS][1200] = {0};
+
+    /* _spawnv() passes the arguments as one command line */
+    for (i=0; i<Argc; i++)
+    {
+        snprintf (szQuoted[i], sizeof (szQuoted[i])-1, "\"%s\"", Args[i]);
+        Args[i] = szQuoted[i];
+    }
+
+    /* The started process inherits stdout */
+    fdStdout = _dup (1);
+    _dup2 (_fileno (pPackage->fpOutput), 1);
+
+    pPackage->hProcess = _spawnv (_P_NOWAIT, m_pszSelf, Args);
+
+    _dup2 (fdStdout, 1);
+    _close (fdStdout);
+
+    if (-1 == pPackage->hProcess)
+    {
+        snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "cannot start install: %s", strerror (errno));
+        return 1;
+    }
+
+#endif
+
+    pPackage->State = BATCH_RUNNING;
+    return ret;
+}
+
+int BatchInstaller::WaitAny()
+{
+    /* Returns the finished package or -1 if no package is running */
+
+    int i = 0;
+
+#ifdef UNIX
+
+    int   Status = 0;
+    pid_t Pid    = 0;
+
+    while (1)
+    {
+        Pid = waitpid (-1, &Status, 0);
+
+        if (Pid < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            return -1;
+        }
+
+        for (i=0; i<m_Count; i++)
+        {
+            if ((BATCH_RUNNING == m_Packages[i].State) && (Pid == m_Packages[i].Pid))
+            {
+                m_Packages[i].ExitCode = WIFEXITED (Status) ? WEXITSTATUS (Status) : 128 + WTERMSIG (Status);
+                return i;
+            }
+        }
+    }
+
+#else
+
+    int    Count = 0;
+    DWORD  dwResult   = 0;
+    DWORD  dwExitCode = 0;
+    HANDLE Handles[BATCH_MAX_PACKAGES] = {0};
+    int    Index[BATCH_MAX_PACKAGES]   = {0};
+
+    for (i=0; i<m_Count; i++)
+    {
+        if (BATCH_RUNNING != m_Packages[i].State)
+            continue;
+
+        Handles[Count] = (HANDLE) m_Packages[i].hProcess;
+        Index[Count]   = i;
+        Count++;
+    }
+
+    if (0 == Count)
+        return -1;
+
+    dwResult = WaitForMultipleObjects (Count, Handles, FALSE, INFINITE);
+
+    if (dwResult >= WAIT_OBJECT_0 + Count)
+        return -1;
+
+    i = Index[dwResult - WAIT_OBJECT_0];
+
+    GetExitCodeProcess (Handles[dwResult - WAIT_OBJECT_0], &dwExitCode);
+    CloseHandle (Handles[dwResult - WAIT_OBJECT_0]);
+
+    m_Packages[i].ExitCode = (int) dwExitCode;
+    return i;
+
+#endif
+}
+
+void BatchInstaller::PrintOutput (BATCH_PACKAGE *pPackage)
+{
+    size_t len = 0;
+    char szBuffer[4096] = {0};
+
+    printf ("\n--- [%s] %s ---\n\n", pPackage->Info.szName, pPackage->szPath);
+
+    if (NULL == pPackage->fpOutput)
+        return;
+
+    rewind (pPackage->fpOutput);
+
+    while ((len = fread (szBuffer, 1, sizeof (szBuffer), pPackage->fpOutput)) > 0)
+        fwrite (szBuffer, 1, len, stdout);
+
+    fclose (pPackage->fpOutput);
+    pPackage->fpOutput = NULL;
+}
+
+int BatchInstaller::PrintSummary()
+{
+    int i = 0;
+    int Count[BATCH_SKIPPED+1] = {0};
+    BATCH_PACKAGE *pPackage = NULL;
+
+    printf ("\n--- Batch Install Summary ---\n\n");
+
+    for (i=0; i<m_Count; i++)
+    {
+        pPackage = &m_Packages[i];
+        Count[pPackage->State]++;
+
+        printf ("%-30s %-12s %-10s", *pPackage->Info.szName ? pPackage->Info.szName : pPackage->szPath, pPackage->Info.szVersion, GetStateName (pPackage->State));
+
+        if (pPackage->StartTime)
+            printf (" %4lds", (long) (pPackage->EndTime - pPackage->StartTime));
+
+        if (*pPackage->szReason)
+            printf (" (%s)", pPackage->szReason);
+
+        printf ("\n");
+    }
+
+    printf ("\nPackages: %d, installed: %d, failed: %d, skipped: %d\n\n", m_Count, Count[BATCH_INSTALLED], Count[BATCH_FAILED], Count[BATCH_SKIPPED]);
+
+    return Count[BATCH_FAILED] + Count[BATCH_SKIPPED];
+}
+
+int BatchInstaller::Run (const char *pszSelf, const char *pszDominoVersion, const char *pszProgramDir, const char *pszDataDir, const char *pszInstallRegDir, int Threads, int Parallel)
+{
+    int  i = 0;
+    int  Running  = 0;
+    int  bChanged = 0;
+    BATCH_PACKAGE *pPackage = NULL;
+    TYPE_SOFTWARE_INFO Installed;
+
+    char szSelf[1024]       = {0};
+    char szInstallIni[2200] = {0};
+
+    GetSelfPath (szSelf, sizeof (szSelf), pszSelf);
+
+    m_pszSelf       = szSelf;
+    m_pszProgramDir = pszProgramDir;
+    m_pszDataDir    = pszDataDir;
+    m_Threads       = Threads;
+
+    if (Parallel < 1)
+        Parallel = 1;
+
+    /* The install processes do not detect the Domino version again */
+#ifdef UNIX
+    setenv (ENV_DOMINO_VERSION, pszDominoVersion, 1);
+#else
+    _putenv_s (ENV_DOMINO_VERSION, pszDominoVersion);
+#endif
+
+    for (i=0; i<m_Count; i++)
+    {
+        pPackage = &m_Packages[i];
+
+        if (ReadPackageInfo (pPackage))
+        {
+            pPackage->State = BATCH_FAILED;
+            continue;
+        }
+
+        if (Find (pPackage->Info.szName, strlen (pPackage->Info.szName)) != pPackage)
+        {
+            pPackage->State = BATCH_SKIPPED;
+            snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "duplicate package");
+        }
+    }
+
+    printf ("Installing %d packages, up to %d at the same time\n", m_Count, Parallel);
+
+    while (1)
+    {
+        bChanged = 0;
+
+        for (i=0; (i<m_Count) && (Running < Parallel); i++)
+        {
+            pPackage = &m_Packages[i];
+
+            if (BATCH_PENDING != pPackage->State)
+                continue;
+
+            switch (CheckDependencies (pPackage, pszInstallRegDir))
+            {
+                case BATCH_DEPENDENCY_WAIT:
+                    continue;
+
+                case BATCH_DEPENDENCY_BLOCKED:
+                    pPackage->State = BATCH_SKIPPED;
+                    bChanged = 1;
+                    continue;
+            } /* switch */
+
+            if (Start (pPackage))
+            {
+                pPackage->State = BATCH_FAILED;
+                bChanged = 1;
+                continue;
+            }
+
+            printf ("Started [%s] %s\n", pPackage->Info.szName, pPackage->Info.szVersion);
+            Running++;
+        }
+
+        /* A skipped or failed package can block other pending packages */
+        if (bChanged)
+            continue;
+
+        if (0 == Running)
+            break;
+
+        i = WaitAny();
+
+        if (i < 0)
+            break;
+
+        Running--;
+        pPackage = &m_Packages[i];
+        pPackage->EndTime = time (NULL);
+
+        /* The install returns 0 in some error cases. The package is only installed, if it is registered with its version */
+        memset (&Installed, 0, sizeof (Installed));
+        snprintf (szInstallIni, sizeof (szInstallIni)-1, "%s%c%s%cinstall.ini", pszInstallRegDir, g_OsDirSep, pPackage->Info.szName, g_OsDirSep);
+
+        if ((0 == pPackage->ExitCode) && (0 == GetSoftwareInfoFromFile (&Installed, szInstallIni)) && (0 == strcmp (Installed.szVersion, pPackage->Info.szVersion)))
+        {
+            pPackage->State = BATCH_INSTALLED;
+        }
+        else
+        {
+            pPackage->State = BATCH_FAILED;
+
+            if (pPackage->ExitCode)
+                snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "exit code %d", pPackage->ExitCode);
+            else
+                snprintf (pPackage->szReason, sizeof (pPackage->szReason)-1, "not registered after install");
+        }
+
+        PrintOutput (pPackage);
+    }
+
+    /* Remaining packages wait for each other */
+    for (i=0; i<m_Count; i++)
+    {
+        if (BATCH_PENDING != m_Packages[i].State)
+            continue;
+
+        m_Packages[i].State = BATCH_SKIPPED;
+        snprintf (m_Packages[i].szReason, sizeof (m_Packages[i].szReason)-1, "circular dependency");
+    }
+
+    return PrintSummary() ? 1 : 0;
+}
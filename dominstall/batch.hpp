@@ -0,0 +1,115 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef BATCH_HPP
+    #define BATCH_HPP
+
+#ifdef UNIX
+#include <sys/types.h>
+#endif
+
+#include <time.h>
+
+#include "dominoinstall.hpp"
+
+#define BATCH_MAX_PACKAGES       64
+#define DEFAULT_BATCH_PARALLEL   4
+
+#define BATCH_PENDING    0
+#define BATCH_RUNNING    1
+#define BATCH_INSTALLED  2
+#define BATCH_FAILED     3
+#define BATCH_SKIPPED    4
+
+typedef struct {
+    char szPath[1024];
+    char szReason[256];
+    BOOL bArchive;
+    TYPE_SOFTWARE_INFO Info;
+    int  State;
+    int  ExitCode;
+    FILE *fpOutput;
+    time_t StartTime;
+    time_t EndTime;
+#ifdef UNIX
+    pid_t Pid;
+#else
+    intptr_t hProcess;
+#endif
+} BATCH_PACKAGE;
+
+
+/* Install of multiple packages in one run.
+   Domino version, program and data directory are determined once and passed to one install process per package.
+   Packages are started when the packages listed in "depends=" of their install.ini are installed.
+   Independent packages are installed concurrently. The output of each package is printed when it is finished */
+
+class BatchInstaller
+{
+
+public:
+
+    BatchInstaller();
+    ~BatchInstaller();
+
+    int  AddPackage (const char *pszPackage);
+    int  AddDataDirectory (const char *pszDataDir);
+    int  Run (const char *pszSelf, const char *pszDominoVersion, const char *pszProgramDir, const char *pszDataDir, const char *pszInstallRegDir, int Threads, int Parallel);
+
+    int  GetCount()
+    {
+        return m_Count;
+    }
+
+    void SetHardLinks (BOOL bHardLinks)
+    {
+        m_bHardLinks = bHardLinks;
+    }
+
+    void SetEventLog (BOOL bEventLog)
+    {
+        m_bEventLog = bEventLog;
+    }
+
+private:
+
+    int  ReadPackageInfo   (BATCH_PACKAGE *pPackage);
+    int  CheckDependencies (BATCH_PACKAGE *pPackage, const char *pszInstallRegDir);
+    int  Start             (BATCH_PACKAGE *pPackage);
+    int  WaitAny           ();
+    void PrintOutput       (BATCH_PACKAGE *pPackage);
+    int  PrintSummary      ();
+
+    BATCH_PACKAGE *Find (const char *pszName, size_t len);
+
+    BATCH_PACKAGE m_Packages[BATCH_MAX_PACKAGES];
+    int  m_Count;
+
+    const char *m_pszSelf;
+    const char *m_pszProgramDir;
+    const char *m_pszDataDir;
+    const char *m_pszFanOutDataDirs[MAX_DATA_DIRS];
+    int  m_FanOutDataDirs;
+    int  m_Threads;
+    BOOL m_bHardLinks;
+    BOOL m_bEventLog;
+};
+
+#endif
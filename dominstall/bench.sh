@@ -0,0 +1,369 @@
+#!/bin/bash
+###########################################################################
+# Domino Add-On Install - Benchmark                                       #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+
+# Generates a synthetic add-on package and times install, same version reinstall,
+# update and remove against a fake Domino program and data directory.
+# Each run is written as one JSON line to the result file.
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+DOMINSTALL="$SCRIPT_DIR/dominstall"
+FILES=2000
+DEPTH=3
+SIZES=mixed
+RELEASES=2
+CHANGE=10
+RUNS=3
+THREADS="1 0"
+MODES="dir tar"
+TARGETS=
+WORK_DIR=
+RESULT_FILE=bench-results.jsonl
+DROP_CACHES=no
+DOMINO_VERSION="Release 12.0.2"
+
+PACKAGE_NAME=dominstall-bench
+
+
+usage()
+{
+  echo
+  echo "Usage: $(basename "$0") [options]"
+  echo
+  echo "-files=<n>          Number of files in domino-data (default: $FILES)"
+  echo "-depth=<n>          Directory depth below domino-data (default: $DEPTH)"
+  echo "-sizes=<dist>       File size distribution: small, mixed, large (default: $SIZES)"
+  echo "-releases=<n>       Number of Release_ directories. One of them matches the fake Domino version (default: $RELEASES)"
+  echo "-change=<percent>   Percent of files changed by the update (default: $CHANGE)"
+  echo "-runs=<n>           Runs per scenario (default: $RUNS)"
+  echo "-threads=<list>     Copy threads to compare. 0 = default of dominstall (default: \"$THREADS\")"
+  echo "-modes=<list>       Install modes to compare: dir, tar (default: \"$MODES\")"
+  echo "-target=<dir>       Target directory for the fake Domino server. Can be specified multiple times"
+  echo "                    (default: /dev/shm if it is a tmpfs and /var/tmp)"
+  echo "-work=<dir>         Directory for the generated packages (default: temporary directory)"
+  echo "-out=<file>         Result file, one JSON line per run (default: $RESULT_FILE)"
+  echo "-bin=<file>         dominstall binary (default: $DOMINSTALL)"
+  echo "-dropcaches         Drop the page cache before each run (needs root)"
+  echo
+  exit 1
+}
+
+log()
+{
+  echo "$@" >&2
+}
+
+json_str()
+{
+  local s="$1"
+  s="${s//\\/\\\\}"
+  s="${s//\"/\\\"}"
+  printf '"%s"' "$s"
+}
+
+now_ns()
+{
+  date +%s%N
+}
+
+random_size()
+{
+  # Sizes in bytes for the selected distribution
+  local r=$((RANDOM % 100))
+
+  case "$SIZES" in
+    small)
+      echo $(( (RANDOM % 16 + 1) * 1024 ))
+      ;;
+
+    large)
+      echo $(( (RANDOM % 32 + 1) * 1024 * 1024 ))
+      ;;
+
+    *)
+      # Mostly small web resources, some medium files and a few large ones
+      if [ "$r" -lt 90 ]; then
+        echo $(( (RANDOM % 64 + 1) * 1024 ))
+      elif [ "$r" -lt 99 ]; then
+        echo $(( (RANDOM % 960 + 64) * 1024 ))
+      else
+        echo $(( (RANDOM % 16 + 1) * 1024 * 1024 ))
+      fi
+      ;;
+  esac
+}
+
+random_dir()
+{
+  # Directory path with up to DEPTH levels and 8 directories per level
+  local path=
+  local level=0
+  local levels=$((RANDOM % (DEPTH + 1)))
+
+  while [ "$level" -lt "$levels" ]; do
+    path="$path/d$level$((RANDOM % 8))"
+    level=$((level + 1))
+  done
+
+  echo "$path"
+}
+
+write_file()
+{
+  # Content is taken from a random seed at a random offset, so files differ without reading /dev/urandom for each file
+  local file="$1"
+  local size="$2"
+
+  mkdir -p "$(dirname "$file")"
+  tail -c +$(( (RANDOM * 32768 + RANDOM) % (32 * 1024 * 1024) + 1 )) "$SEED" | head -c "$size" > "$file"
+
+  if [ "$(stat -c %s "$file")" -lt "$size" ]; then
+    head -c "$size" "$SEED" > "$file"
+  fi
+}
+
+create_package()
+{
+  local pkg="$1"
+  local version="$2"
+  local i=0
+  local r=0
+  local release=
+
+  log "Generating package [$pkg] version $version with $FILES files ($SIZES)"
+
+  rm -rf "$pkg"
+  mkdir -p "$pkg/domino-bin" "$pkg/domino-data"
+
+  printf 'name=%s\nversion=%s\nvendor=NashCom\ndescription=Synthetic benchmark package\n' "$PACKAGE_NAME" "$version" > "$pkg/install.ini"
+
+  # A few binaries and a large number of data files like a web application
+  for i in $(seq 1 $((FILES / 100 + 1))); do
+    write_file "$pkg/domino-bin/libbench$i.so" "$(random_size)"
+  done
+
+  for i in $(seq 1 "$FILES"); do
+    write_file "$pkg/domino-data/domino/html/bench$(random_dir)/f$i.dat" "$(random_size)"
+  done
+
+  # Release_ directories replace 5% of the generic files. Only the best match for the fake Domino version is installed
+  for r in $(seq 1 "$RELEASES"); do
+    release=Release_11.0.$r
+
+    if [ "$r" -eq "$RELEASES" ]; then
+      release=Release_12.0.2
+    fi
+
+    for i in $(seq 1 $((FILES / 20 + 1))); do
+      write_file "$pkg/$release/domino-data/domino/html/bench/release/f$i.dat" "$(random_size)"
+    done
+  done
+}
+
+update_package()
+{
+  # New version with changed, removed and added files
+  local pkg="$1"
+  local version="$2"
+  local file=
+  local count=0
+  local changed=$((FILES * CHANGE / 100))
+
+  log "Generating update [$pkg] version $version, $CHANGE% changed"
+
+  sed -i "s/^version=.*/version=$version/" "$pkg/install.ini"
+
+  find "$pkg/domino-data" -type f | shuf -n "$changed" | while read -r file; do
+    count=$((count + 1))
+
+    if [ $((count % 10)) -eq 0 ]; then
+      rm -f "$file"
+    else
+      write_file "$file" "$(random_size)"
+    fi
+  done
+
+  for count in $(seq 1 $((changed / 10 + 1))); do
+    write_file "$pkg/domino-data/domino/html/bench/new/n$count.dat" "$(random_size)"
+  done
+}
+
+create_server()
+{
+  # Fake Domino server. The version is read from libnotes.so like on a real server
+  local server="$1"
+
+  rm -rf "$server"
+  mkdir -p "$server/bin" "$server/data"
+
+  printf '\0\0%s\0\0' "$DOMINO_VERSION" > "$server/bin/libnotes.so"
+  printf '[Notes]\nDirectory=%s\n' "$server/data" > "$server/data/notes.ini"
+}
+
+drop_caches()
+{
+  if [ "$DROP_CACHES" != "yes" ]; then
+    return 0
+  fi
+
+  sync
+  echo 3 > /proc/sys/vm/drop_caches 2> /dev/null
+}
+
+run_scenario()
+{
+  # Runs dominstall, appends the result line and the statistics of the install
+  local scenario="$1"
+  local target="$2"
+  local mode="$3"
+  local threads="$4"
+  local run="$5"
+  local source="$6"
+  shift 6
+
+  local server="$target/server"
+  local start=0
+  local end=0
+  local rc=0
+  local fstype=
+  local stats=null
+  local thread_param=
+  local source_param=
+  local stats_file="$server/bin/.install-reg/$PACKAGE_NAME/stats.json"
+
+  fstype=$(stat -f -c %T "$target")
+
+  if [ "$threads" != "0" ]; then
+    thread_param="-threads=$threads"
+  fi
+
+  if [ "$scenario" = "remove" ]; then
+    source_param="-remove -name=$PACKAGE_NAME"
+  elif [ "$mode" = "tar" ]; then
+    source_param="-tar=$source"
+  else
+    source_param="-dir=$source"
+  fi
+
+  rm -f "$stats_file"
+  drop_caches
+
+  start=$(now_ns)
+  "$DOMINSTALL" $source_param -bin="$server/bin" -data="$server/data" $thread_param "$@" >> "$WORK_DIR/dominstall.log" 2>&1
+  rc=$?
+  end=$(now_ns)
+
+  if [ -e "$stats_file" ]; then
+    stats=$(tr -d '\n' < "$stats_file")
+  fi
+
+  printf '{"scenario":"%s","target":%s,"fstype":"%s","mode":"%s","threads":%s,"run":%s,"files":%s,"depth":%s,"sizes":"%s","seconds":%s,"rc":%s,"stats":%s}\n' \
+    "$scenario" "$(json_str "$target")" "$fstype" "$mode" "$threads" "$run" "$FILES" "$DEPTH" "$SIZES" \
+    "$(awk "BEGIN { printf \"%.6f\", ($end - $start) / 1000000000 }")" "$rc" "$stats" >> "$RESULT_FILE"
+
+  log "$(printf '%-10s %-8s %-4s threads=%-3s run=%s  %8.3f sec  rc=%s' "$scenario" "$fstype" "$mode" "$threads" "$run" "$(awk "BEGIN { print ($end - $start) / 1000000000 }")" "$rc")"
+}
+
+
+for a in "$@"; do
+  case "$a" in
+    -files=*)    FILES="${a#*=}" ;;
+    -depth=*)    DEPTH="${a#*=}" ;;
+    -sizes=*)    SIZES="${a#*=}" ;;
+    -releases=*) RELEASES="${a#*=}" ;;
+    -change=*)   CHANGE="${a#*=}" ;;
+    -runs=*)     RUNS="${a#*=}" ;;
+    -threads=*)  THREADS="${a#*=}" ;;
+    -modes=*)    MODES="${a#*=}" ;;
+    -target=*)   TARGETS="$TARGETS ${a#*=}" ;;
+    -work=*)     WORK_DIR="${a#*=}" ;;
+    -out=*)      RESULT_FILE="${a#*=}" ;;
+    -bin=*)      DOMINSTALL="${a#*=}" ;;
+    -dropcaches) DROP_CACHES=yes ;;
+    *)           usage ;;
+  esac
+done
+
+if [ ! -x "$DOMINSTALL" ]; then
+  log "dominstall binary not found: $DOMINSTALL (run make first)"
+  exit 1
+fi
+
+if [ -z "$TARGETS" ]; then
+  if [ "$(stat -f -c %T /dev/shm 2> /dev/null)" = "tmpfs" ]; then
+    TARGETS="/dev/shm"
+  fi
+
+  TARGETS="$TARGETS /var/tmp"
+fi
+
+if [ -z "$WORK_DIR" ]; then
+  WORK_DIR=$(mktemp -d /var/tmp/dominstall-bench.XXXXXX)
+fi
+
+mkdir -p "$WORK_DIR"
+RESULT_FILE=$(realpath "$RESULT_FILE")
+SEED="$WORK_DIR/seed.bin"
+
+# The Domino version is detected from the fake libnotes.so
+unset autoinstall_DominoVersion
+
+head -c $((48 * 1024 * 1024)) /dev/urandom > "$SEED"
+
+create_package "$WORK_DIR/pkg-1.0" "1.0"
+cp -a "$WORK_DIR/pkg-1.0" "$WORK_DIR/pkg-1.1"
+update_package "$WORK_DIR/pkg-1.1" "1.1"
+
+# Archives are created in advance. Only the install is timed
+for version in 1.0 1.1; do
+  tar -C "$WORK_DIR/pkg-$version" -cf "$WORK_DIR/pkg-$version.tar" install.ini domino-bin domino-data $(cd "$WORK_DIR/pkg-$version" && ls -d Release_* 2> /dev/null)
+done
+
+log "Results: $RESULT_FILE"
+
+for target in $TARGETS; do
+  bench_dir="$target/dominstall-bench.$$"
+  mkdir -p "$bench_dir"
+
+  for mode in $MODES; do
+    for threads in $THREADS; do
+      for run in $(seq 1 "$RUNS"); do
+
+        if [ "$mode" = "tar" ]; then
+          source_1="$WORK_DIR/pkg-1.0.tar"
+          source_2="$WORK_DIR/pkg-1.1.tar"
+        else
+          source_1="$WORK_DIR/pkg-1.0"
+          source_2="$WORK_DIR/pkg-1.1"
+        fi
+
+        create_server "$bench_dir/server"
+
+        run_scenario install   "$bench_dir" "$mode" "$threads" "$run" "$source_1"
+        run_scenario reinstall "$bench_dir" "$mode" "$threads" "$run" "$source_1"
+        run_scenario update    "$bench_dir" "$mode" "$threads" "$run" "$source_2"
+        run_scenario remove    "$bench_dir" "$mode" "$threads" "$run" ""
+      done
+    done
+  done
+
+  rm -rf "$bench_dir"
+done
+
+log "dominstall output: $WORK_DIR/dominstall.log"
@@ -0,0 +1,778 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef UNIX
+#include <unistd.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <thread>
+
+#include "dominoinstall.hpp"
+#include "copysched.hpp"
+
+#ifdef UNIX
+    #define LSTAT lstat
+#else
+    #define LSTAT stat
+    #define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+    #define S_ISLNK(m) 0
+#endif
+
+typedef struct {
+    long long Size;
+    int  Job;
+} COPY_ORDER;
+
+
+static int CompareCopyOrder (const void *p1, const void *p2)
+{
+    const COPY_ORDER *pOrder1 = (const COPY_ORDER *) p1;
+    const COPY_ORDER *pOrder2 = (const COPY_ORDER *) p2;
+
+    /* Largest first. Keep discovery order for equal sizes */
+    if (pOrder1->Size != pOrder2->Size)
+        return (pOrder1->Size < pOrder2->Size) ? 1 : -1;
+
+    return pOrder1->Job - pOrder2->Job;
+}
+
+static int LinkFile (const char *pszSourcePath, const char *pszTargetPath)
+{
+    /* Fails across file systems. The caller copies the file instead */
+
+    remove (pszTargetPath);
+
+#ifdef UNIX
+    return link (pszSourcePath, pszTargetPath) ? 1 : 0;
+#else
+    return CreateHardLink (pszTargetPath, pszSourcePath, NULL) ? 0 : 1;
+#endif
+}
+
+static int IsBelow (const char *pszPath, const char *pszDirectory, size_t len)
+{
+    if (strncmp (pszPath, pszDirectory, len))
+        return 0;
+
+    return ('/' == pszPath[len]) || (g_OsDirSep == pszPath[len]);
+}
+
+static char *DupPath (const char *pszBase, const char *pszRelative)
+{
+    size_t len1 = strlen (pszBase);
+    size_t len2 = strlen (pszRelative);
+    char   *p   = (char *) malloc (len1 + len2 + 1);
+
+    if (NULL == p)
+        return NULL;
+
+    memcpy (p, pszBase, len1);
+    memcpy (p + len1, pszRelative, len2 + 1);
+
+    return p;
+}
+
+CopyScheduler::CopyScheduler()
+{
+    m_pJobs   = NULL;
+    m_Jobs    = 0;
+    m_JobsMax = 0;
+
+    m_pDirs   = NULL;
+    m_Dirs    = 0;
+    m_DirsMax = 0;
+
+    m_pTargetIndex    = NULL;
+    m_TargetIndexSize = 0;
+
+    m_pQueues = NULL;
+    m_Queues  = 0;
+
+    m_pManifest  = NULL;
+    m_pJournal   = NULL;
+    m_bHardLinks = FALSE;
+
+    m_pszSourceBase = NULL;
+    m_pszTargetBase = NULL;
+    m_SourceBaseLen = 0;
+    m_Error = 0;
+}
+
+CopyScheduler::~CopyScheduler()
+{
+    int i = 0;
+
+    for (i=0; i<m_Jobs; i++)
+    {
+        free (m_pJobs[i].pszSource);
+        free (m_pJobs[i].pszTarget);
+    }
+
+    for (i=0; i<m_Dirs; i++)
+    {
+        free (m_pDirs[i].pszSource);
+        free (m_pDirs[i].pszTarget);
+    }
+
+    if (m_pJobs)
+    {
+        free (m_pJobs);
+        m_pJobs = NULL;
+    }
+
+    if (m_pDirs)
+    {
+        free (m_pDirs);
+        m_pDirs = NULL;
+    }
+
+    if (m_pTargetIndex)
+    {
+        free (m_pTargetIndex);
+        m_pTargetIndex = NULL;
+    }
+}
+
+int CopyScheduler::AddDirectory (const char *pszSourceDir, const char *pszTargetDir, int levels)
+{
+    if ((NULL == pszSourceDir) || (NULL == pszTargetDir))
+        return 0;
+
+    m_pszSourceBase = pszSourceDir;
+    m_pszTargetBase = pszTargetDir;
+    m_SourceBaseLen = strlen (pszSourceDir);
+    m_Error = 0;
+
+    RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_FILE | RUN_COMMAND_ON_FIND_FLAG_DIRECTORY, pszSourceDir, "", AddEntry, this, levels);
+
+    m_pszSourceBase = NULL;
+    m_pszTargetBase = NULL;
+    m_SourceBaseLen = 0;
+
+    return m_Error;
+}
+
+int CopyScheduler::AddEntry (const char *pszFindPath, void *pCustomData)
+{
+    CopyScheduler *pScheduler = (CopyScheduler *) pCustomData;
+
+    if (NULL == pScheduler)
+        return 0;
+
+    return pScheduler->AddPath (pszFindPath);
+}
+
+int CopyScheduler::AddPath (const char *pszFindPath)
+{
+    int  ret = 0;
+    char *pszTarget = NULL;
+    struct stat Stat = {0};
+
+    if (strncmp (pszFindPath, m_pszSourceBase, m_SourceBaseLen))
+        return 0;
+
+    pszTarget = DupPath (m_pszTargetBase, pszFindPath + m_SourceBaseLen);
+
+    if (NULL == pszTarget)
+    {
+        m_Error++;
+        return 1;
+    }
+
+    /* The walker does not pass the type. Symbolic links are not followed like in the walker */
+    if (0 == LSTAT (pszFindPath, &Stat) && S_ISDIR (Stat.st_mode))
+        ret = AddDir (pszFindPath, pszTarget);
+    else
+        ret = AddFile (pszFindPath, pszTarget, Stat.st_size, Stat.st_mtime, S_ISLNK (Stat.st_mode));
+
+    free (pszTarget);
+
+    if (ret)
+        m_Error++;
+
+    return ret;
+}
+
+int CopyScheduler::AddDir (const char *pszSource, const char *pszTarget)
+{
+    COPY_DIR *pNew = NULL;
+
+    if (m_Dirs >= m_DirsMax)
+    {
+        pNew = (COPY_DIR *) realloc (m_pDirs, (m_DirsMax + 256) * sizeof (COPY_DIR));
+
+        if (NULL == pNew)
+            return 1;
+
+        m_pDirs    = pNew;
+        m_DirsMax += 256;
+    }
+
+    m_pDirs[m_Dirs].pszSource = strdup (pszSource);
+    m_pDirs[m_Dirs].pszTarget = strdup (pszTarget);
+
+    if ((NULL == m_pDirs[m_Dirs].pszSource) || (NULL == m_pDirs[m_Dirs].pszTarget))
+    {
+        free (m_pDirs[m_Dirs].pszSource);
+        free (m_pDirs[m_Dirs].pszTarget);
+        return 1;
+    }
+
+    m_pDirs[m_Dirs].Created = 0;
+    m_Dirs++;
+    return 0;
+}
+
+int CopyScheduler::AddResult (const char *pszSource, const char *pszTarget, long long Size, long long Mtime, unsigned long long Hash, int Link, int Result, long long Duration)
+{
+    int Job = 0;
+
+    if (AddFile (pszSource, pszTarget, Size, Mtime, Link))
+        return 1;
+
+    Job = FindTarget (pszTarget);
+
+    if (Job < 0)
+        return 1;
+
+    m_pJobs[Job].Hash   = Hash;
+    m_pJobs[Job].Result = Result;
+    m_pJobs[Job].Duration = Duration;
+    return 0;
+}
+
+int CopyScheduler::AddTargetDirectory (const char *pszTarget, int Created)
+{
+    /* No source directory to take the attributes from */
+
+    if (AddDir ("", pszTarget))
+        return 1;
+
+    m_pDirs[m_Dirs-1].Created = Created;
+    return 0;
+}
+
+int CopyScheduler::AddFile (const char *pszSource, const char *pszTarget, long long Size, long long Mtime, int Link)
+{
+    int  Job = 0;
+    char *pszNewSource = NULL;
+    COPY_JOB *pNew = NULL;
+
+    /* Same target added again: The later directory wins like when copying one after the other */
+    Job = FindTarget (pszTarget);
+
+    if (Job >= 0)
+    {
+        pszNewSource = strdup (pszSource);
+
+        if (NULL == pszNewSource)
+            return 1;
+
+        free (m_pJobs[Job].pszSource);
+        m_pJobs[Job].pszSource = pszNewSource;
+        m_pJobs[Job].Size  = Size;
+        m_pJobs[Job].Mtime = Mtime;
+        m_pJobs[Job].Link  = Link;
+        return 0;
+    }
+
+    if (m_Jobs >= m_JobsMax)
+    {
+        pNew = (COPY_JOB *) realloc (m_pJobs, (m_JobsMax + 1024) * sizeof (COPY_JOB));
+
+        if (NULL == pNew)
+            return 1;
+
+        m_pJobs    = pNew;
+        m_JobsMax += 1024;
+    }
+
+    m_pJobs[m_Jobs].pszSource = strdup (pszSource);
+    m_pJobs[m_Jobs].pszTarget = strdup (pszTarget);
+    m_pJobs[m_Jobs].Size   = Size;
+    m_pJobs[m_Jobs].Mtime  = Mtime;
+    m_pJobs[m_Jobs].Hash   = 0;
+    m_pJobs[m_Jobs].Link   = Link;
+    m_pJobs[m_Jobs].Result = COPY_JOB_PENDING;
+    m_pJobs[m_Jobs].Primary = -1;
+    m_pJobs[m_Jobs].Duration = 0;
+
+    if ((NULL == m_pJobs[m_Jobs].pszSource) || (NULL == m_pJobs[m_Jobs].pszTarget))
+    {
+        free (m_pJobs[m_Jobs].pszSource);
+        free (m_pJobs[m_Jobs].pszTarget);
+        return 1;
+    }
+
+    m_Jobs++;
+
+    return IndexTarget (m_Jobs-1);
+}
+
+int CopyScheduler::AddFanOut (const char *pszPrimaryDir, const char *pszTargetDir)
+{
+    /* Adds the files and directories below the primary directory again for another target directory.
+       Must be called after all directories of the package are added, so that the final source of each file is known */
+
+    int  i     = 0;
+    int  Job   = 0;
+    int  Jobs  = m_Jobs;
+    int  Dirs  = m_Dirs;
+    int  ret   = 0;
+    size_t len = 0;
+    char *pszTarget = NULL;
+
+    if (IsNullStr (pszPrimaryDir) || IsNullStr (pszTargetDir))
+        return 0;
+
+    len = strlen (pszPrimaryDir);
+
+    for (i=0; i<Dirs; i++)
+    {
+        if (!IsBelow (m_pDirs[i].pszTarget, pszPrimaryDir, len))
+            continue;
+
+        pszTarget = DupPath (pszTargetDir, m_pDirs[i].pszTarget + len);
+
+        if ((NULL == pszTarget) || AddDir (m_pDirs[i].pszSource, pszTarget))
+            ret = 1;
+
+        free (pszTarget);
+    }
+
+    for (i=0; i<Jobs; i++)
+    {
+        if ((m_pJobs[i].Primary >= 0) || !IsBelow (m_pJobs[i].pszTarget, pszPrimaryDir, len))
+            continue;
+
+        pszTarget = DupPath (pszTargetDir, m_pJobs[i].pszTarget + len);
+
+        if ((NULL == pszTarget) || AddFile (m_pJobs[i].pszSource, pszTarget, m_pJobs[i].Size, m_pJobs[i].Mtime, m_pJobs[i].Link))
+        {
+            free (pszTarget);
+            ret = 1;
+            continue;
+        }
+
+        Job = FindTarget (pszTarget);
+        free (pszTarget);
+
+        if (Job >= 0)
+            m_pJobs[Job].Primary = i;
+    }
+
+    return ret;
+}
+
+int CopyScheduler::FindTarget (const char *pszTarget)
+{
+    unsigned int pos = 0;
+
+    if (NULL == m_pTargetIndex)
+        return -1;
+
+    pos = HashPath (pszTarget) & (m_TargetIndexSize-1);
+
+    while (m_pTargetIndex[pos] >= 0)
+    {
+        if (0 == PATHCMP (m_pJobs[m_pTargetIndex[pos]].pszTarget, pszTarget))
+            return m_pTargetIndex[pos];
+
+        pos = (pos+1) & (m_TargetIndexSize-1);
+    }
+
+    return -1;
+}
+
+int CopyScheduler::IndexTarget (int Job)
+{
+    /* Open addressing hash table with job numbers. Rebuilt with double size when half full */
+
+    int  i    = 0;
+    int  Size = 0;
+    int  *pNewIndex = NULL;
+    unsigned int pos = 0;
+
+    if (2 * m_Jobs > m_TargetIndexSize)
+    {
+        Size = m_TargetIndexSize ? m_TargetIndexSize * 2 : 4096;
+
+        pNewIndex = (int *) malloc (Size * sizeof (int));
+
+        if (NULL == pNewIndex)
+            return 1;
+
+        if (m_pTargetIndex)
+            free (m_pTargetIndex);
+
+        m_pTargetIndex    = pNewIndex;
+        m_TargetIndexSize = Size;
+
+        for (pos=0; pos < (unsigned int) Size; pos++)
+            m_pTargetIndex[pos] = -1;
+
+        /* Re-add all jobs including the new one */
+        i = 0;
+    }
+    else
+    {
+        i = Job;
+    }
+
+    for (; i<=Job; i++)
+    {
+        pos = HashPath (m_pJobs[i].pszTarget) & (m_TargetIndexSize-1);
+
+        while (m_pTargetIndex[pos] >= 0)
+            pos = (pos+1) & (m_TargetIndexSize-1);
+
+        m_pTargetIndex[pos] = i;
+    }
+
+    return 0;
+}
+
+int CopyScheduler::NextJob (int Queue, int *retpJob)
+{
+    int i = 0;
+    COPY_QUEUE *pQueue = NULL;
+
+    /* Own queue from the front: Largest remaining file first */
+    pQueue = m_pQueues + Queue;
+
+    {
+        std::lock_guard<std::mutex> Lock (pQueue->Mutex);
+
+        if (pQueue->Head < pQueue->Tail)
+        {
+            *retpJob = pQueue->pJobs[pQueue->Head++];
+            return 1;
+        }
+    }
+
+    /* Steal from the back of other queues, which has the smallest files */
+    for (i=1; i<m_Queues; i++)
+    {
+        pQueue = m_pQueues + ((Queue + i) % m_Queues);
+
+        std::lock_guard<std::mutex> Lock (pQueue->Mutex);
+
+        if (pQueue->Head < pQueue->Tail)
+        {
+            *retpJob = pQueue->pJobs[--pQueue->Tail];
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int CopyScheduler::IsUnchanged (COPY_JOB *pJob)
+{
+    /* Same content as recorded and the installed file was not modified since */
+
+    const MANIFEST_ENTRY *pEntry = NULL;
+    struct stat Stat = {0};
+
+    if (NULL == m_pManifest)
+        return 0;
+
+    pEntry = m_pManifest->Find (pJob->pszTarget);
+
+    if (NULL == pEntry)
+        return 0;
+
+    if (MANIFEST_TYPE_FILE != pEntry->Type)
+        return 0;
+
+    if ((pEntry->Size != pJob->Size) || (pEntry->Hash != pJob->Hash))
+        return 0;
+
+    if (LSTAT (pJob->pszTarget, &Stat))
+        return 0;
+
+    if (S_ISDIR (Stat.st_mode) || (pEntry->Size != Stat.st_size) || (pEntry->Mtime != Stat.st_mtime))
+        return 0;
+
+    /* Installed file keeps its time stamp */
+    pJob->Mtime = pEntry->Mtime;
+    return 1;
+}
+
+int CopyScheduler::CopyJob (COPY_JOB *pJob, const char *pszTarget)
+{
+    const COPY_JOB *pPrimary = NULL;
+    const char *pszSource = pJob->pszSource;
+
+    char szPrimaryPath[2048] = {0};
+
+    if (pJob->Primary >= 0)
+        pPrimary = m_pJobs + pJob->Primary;
+
+    /* A fanned out file is copied from the primary copy. On the same file system this is a reflink where supported */
+    if (pPrimary && (COPY_JOB_COPIED == pPrimary->Result) && m_pJournal)
+    {
+        GetStagePath (szPrimaryPath, sizeof (szPrimaryPath), pPrimary->pszTarget);
+        pszSource = szPrimaryPath;
+    }
+    else if (pPrimary && ((COPY_JOB_COPIED == pPrimary->Result) || (COPY_JOB_SKIPPED == pPrimary->Result)))
+    {
+        pszSource = pPrimary->pszTarget;
+    }
+    else
+    {
+        return copy_file (pszSource, pszTarget, TRUE);
+    }
+
+    if (m_bHardLinks && (0 == pJob->Link) && (0 == LinkFile (pszSource, pszTarget)))
+        return 0;
+
+    return copy_file (pszSource, pszTarget, TRUE);
+}
+
+void CopyScheduler::Worker (int Queue)
+{
+    int ret   = 0;
+    int Job   = 0;
+    int Error = 0;
+    long long Start = 0;
+    COPY_JOB *pJob = NULL;
+
+    char szStagePath[2048] = {0};
+
+    while (NextJob (Queue, &Job))
+    {
+        pJob  = m_pJobs + Job;
+        Error = 0;
+        Start = GetMicroseconds();
+
+        /* The primary file has the same source and is already hashed. Links are always copied, the hash is only used for file content */
+        if ((pJob->Primary >= 0) && (COPY_JOB_ERROR != m_pJobs[pJob->Primary].Result))
+            pJob->Hash = m_pJobs[pJob->Primary].Hash;
+        else if (0 == pJob->Link)
+            pJob->Hash = HashFile (pJob->pszSource, 0, &Error);
+
+        if ((0 == Error) && IsUnchanged (pJob))
+        {
+            pJob->Result   = COPY_JOB_SKIPPED;
+            pJob->Duration = GetMicroseconds() - Start;
+            LogSkippedFile (pJob->pszTarget, pJob->Size, pJob->Duration);
+            continue;
+        }
+
+        if (m_pJournal)
+        {
+            GetStagePath (szStagePath, sizeof (szStagePath), pJob->pszTarget);
+            ret = CopyJob (pJob, szStagePath);
+        }
+        else
+        {
+            ret = CopyJob (pJob, pJob->pszTarget);
+        }
+
+        pJob->Result   = ret ? COPY_JOB_ERROR : COPY_JOB_COPIED;
+        pJob->Duration = GetMicroseconds() - Start;
+        LogCopyResult (ret, pJob->pszTarget, pJob->Size, pJob->Duration);
+    }
+}
+
+void CopyScheduler::WorkerThread (CopyScheduler *pScheduler, int Queue)
+{
+    pScheduler->Worker (Queue);
+}
+
+int CopyScheduler::GetUnfinishedCount()
+{
+    /* Jobs neither copied nor skipped: Failed or never run */
+
+    int Count = 0;
+    int i     = 0;
+
+    for (i=0; i<m_Jobs; i++)
+    {
+        if ((COPY_JOB_COPIED != m_pJobs[i].Result) && (COPY_JOB_SKIPPED != m_pJobs[i].Result))
+            Count++;
+    }
+
+    return Count;
+}
+
+void CopyScheduler::SetDirectoryAttributes()
+{
+#ifdef UNIX
+    int i = 0;
+
+    /* Set after all files are written, which updates the directory time stamps. Children first */
+    for (i=m_Dirs-1; i>=0; i--)
+    {
+        if (*m_pDirs[i].pszSource)
+            CopyDirectoryAttributes (m_pDirs[i].pszSource, m_pDirs[i].pszTarget);
+    }
+#endif
+}
+
+int CopyScheduler::RunQueues (int Threads, int FanOut)
+{
+    /* Copies all pending primary files or all pending fanned out files */
+
+    int  ret  = 0;
+    int  i    = 0;
+    int  Jobs = 0;
+    int  *pQueueJobs = NULL;
+    COPY_ORDER  *pOrder   = NULL;
+    std::thread *pThreads = NULL;
+
+    for (i=0; i<m_Jobs; i++)
+    {
+        if ((COPY_JOB_PENDING == m_pJobs[i].Result) && (FanOut == (m_pJobs[i].Primary >= 0)))
+            Jobs++;
+    }
+
+    if (Threads > Jobs)
+        Threads = Jobs;
+
+    if (0 == Jobs)
+        goto Done;
+
+    pOrder     = (COPY_ORDER *) malloc (Jobs * sizeof (COPY_ORDER));
+    pQueueJobs = (int *) malloc (Jobs * sizeof (int));
+    m_pQueues  = new COPY_QUEUE[Threads];
+
+    if ((NULL == pOrder) || (NULL == pQueueJobs) || (NULL == m_pQueues))
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    Jobs = 0;
+
+    for (i=0; i<m_Jobs; i++)
+    {
+        if ((COPY_JOB_PENDING != m_pJobs[i].Result) || (FanOut != (m_pJobs[i].Primary >= 0)))
+            continue;
+
+        pOrder[Jobs].Size = m_pJobs[i].Size;
+        pOrder[Jobs].Job  = i;
+        Jobs++;
+    }
+
+    qsort (pOrder, Jobs, sizeof (COPY_ORDER), CompareCopyOrder);
+
+    /* Deal sorted jobs round robin. Each queue is a contiguous slice of the job array, again sorted by size */
+    m_Queues = Threads;
+
+    for (i=0; i<m_Queues; i++)
+    {
+        m_pQueues[i].pJobs = pQueueJobs + i * (Jobs / m_Queues) + ((i < Jobs % m_Queues) ? i : Jobs % m_Queues);
+        m_pQueues[i].Head  = 0;
+        m_pQueues[i].Tail  = 0;
+    }
+
+    for (i=0; i<Jobs; i++)
+    {
+        COPY_QUEUE *pQueue = m_pQueues + (i % m_Queues);
+        pQueue->pJobs[pQueue->Tail++] = pOrder[i].Job;
+    }
+
+    pThreads = new std::thread[Threads];
+
+    for (i=0; i<Threads; i++)
+        pThreads[i] = std::thread (WorkerThread, this, i);
+
+    for (i=0; i<Threads; i++)
+        pThreads[i].join();
+
+Done:
+
+    if (pThreads)
+    {
+        delete [] pThreads;
+        pThreads = NULL;
+    }
+
+    if (m_pQueues)
+    {
+        delete [] m_pQueues;
+        m_pQueues = NULL;
+        m_Queues  = 0;
+    }
+
+    if (pQueueJobs)
+    {
+        free (pQueueJobs);
+        pQueueJobs = NULL;
+    }
+
+    if (pOrder)
+    {
+        free (pOrder);
+        pOrder = NULL;
+    }
+
+    return ret;
+}
+
+int CopyScheduler::Run (int Threads)
+{
+    /* Copies all pending files. Files already written by an archive install are only fanned out */
+
+    int  ret = 0;
+    int  i   = 0;
+
+    if (Threads < 1)
+        Threads = 1;
+
+    if (Threads > MAX_COPY_THREADS)
+        Threads = MAX_COPY_THREADS;
+
+    /* Directories are in walk order: Parents are created before their children */
+    for (i=0; i<m_Dirs; i++)
+    {
+        if (m_pDirs[i].Created)
+            continue;
+
+        if (create_directory (m_pDirs[i].pszTarget))
+            continue;
+
+        m_pDirs[i].Created = 1;
+
+        if (m_pJournal)
+            m_pJournal->AddEntry (JOURNAL_NEW_DIRECTORY, m_pDirs[i].pszTarget);
+    }
+
+    /* Journal entries must be on disk before the first stage file is written */
+    if (m_pJournal && m_pJournal->Sync())
+        return 1;
+
+    ret = RunQueues (Threads, 0);
+
+    if (0 == ret)
+        ret = RunQueues (Threads, 1);
+
+    /* Staged files change the directories again on commit */
+    if ((0 == ret) && (NULL == m_pJournal))
+        SetDirectoryAttributes();
+
+    return ret;
+}
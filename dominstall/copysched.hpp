@@ -0,0 +1,162 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef COPYSCHED_HPP
+    #define COPYSCHED_HPP
+
+#include <mutex>
+
+#include "dominoinstall.hpp"
+#include "manifest.hpp"
+#include "journal.hpp"
+
+#define COPY_JOB_PENDING  0
+#define COPY_JOB_COPIED   1
+#define COPY_JOB_SKIPPED  2
+#define COPY_JOB_ERROR    3
+
+typedef struct {
+    char *pszSource;
+    char *pszTarget;
+    long long Size;
+    long long Mtime;
+    unsigned long long Hash;
+    int  Link;
+    int  Result;
+    int  Primary;
+    long long Duration;
+} COPY_JOB;
+
+typedef struct {
+    char *pszSource;
+    char *pszTarget;
+    int  Created;
+} COPY_DIR;
+
+typedef struct {
+    std::mutex Mutex;
+    int  *pJobs;
+    int  Head;
+    int  Tail;
+} COPY_QUEUE;
+
+
+/* Parallel copy of install directories.
+   All files are discovered first and target directories are created before any file is copied.
+   Files are copied largest first by a pool of threads, each owning a queue. Idle threads steal from the end of other queues.
+   Each file is hashed for the manifest. With the manifest of the previous install unchanged files are not copied again.
+   With a journal files are copied to their stage path and created directories are recorded.
+   Files fanned out to additional target directories are copied after the primary file, from the primary copy */
+
+class CopyScheduler
+{
+
+public:
+
+    CopyScheduler();
+    ~CopyScheduler();
+
+    int  AddDirectory (const char *pszSourceDir, const char *pszTargetDir, int levels);
+    int  Run          (int Threads);
+    int  AddFanOut    (const char *pszPrimaryDir, const char *pszTargetDir);
+    int  FindTarget   (const char *pszTarget);
+    int  GetUnfinishedCount();
+    void SetDirectoryAttributes();
+
+    /* Files and directories written by an installer reading an archive instead of Run() */
+    int  AddResult          (const char *pszSource, const char *pszTarget, long long Size, long long Mtime, unsigned long long Hash, int Link, int Result, long long Duration);
+    int  AddTargetDirectory (const char *pszTarget, int Created);
+
+    void SetManifest (InstallManifest *pManifest)
+    {
+        m_pManifest = pManifest;
+    }
+
+    void SetJournal (InstallJournal *pJournal)
+    {
+        m_pJournal = pJournal;
+    }
+
+    void SetHardLinks (BOOL bHardLinks)
+    {
+        m_bHardLinks = bHardLinks;
+    }
+
+    const COPY_JOB *GetJob (int Job)
+    {
+        return ( (Job >= 0) && (Job < m_Jobs) ) ? &m_pJobs[Job] : NULL;
+    }
+
+    const COPY_DIR *GetDirectory (int Dir)
+    {
+        return ( (Dir >= 0) && (Dir < m_Dirs) ) ? &m_pDirs[Dir] : NULL;
+    }
+
+    int  GetFileCount()
+    {
+        return m_Jobs;
+    }
+
+    int  GetDirectoryCount()
+    {
+        return m_Dirs;
+    }
+
+private:
+
+    int  AddPath     (const char *pszFindPath);
+    int  AddFile     (const char *pszSource, const char *pszTarget, long long Size, long long Mtime, int Link);
+    int  AddDir      (const char *pszSource, const char *pszTarget);
+    int  IndexTarget (int Job);
+    int  IsUnchanged (COPY_JOB *pJob);
+    int  NextJob     (int Queue, int *retpJob);
+    int  RunQueues   (int Threads, int FanOut);
+    int  CopyJob     (COPY_JOB *pJob, const char *pszTarget);
+    void Worker      (int Queue);
+
+    static int  AddEntry     (const char *pszFindPath, void *pCustomData);
+    static void WorkerThread (CopyScheduler *pScheduler, int Queue);
+
+    COPY_JOB *m_pJobs;
+    int  m_Jobs;
+    int  m_JobsMax;
+
+    COPY_DIR *m_pDirs;
+    int  m_Dirs;
+    int  m_DirsMax;
+
+    /* Hash index of target paths: Files from a Release_ directory replace the generic file */
+    int  *m_pTargetIndex;
+    int  m_TargetIndexSize;
+
+    COPY_QUEUE *m_pQueues;
+    int  m_Queues;
+
+    InstallManifest *m_pManifest;
+    InstallJournal  *m_pJournal;
+    BOOL m_bHardLinks;
+
+    const char *m_pszSourceBase;
+    const char *m_pszTargetBase;
+    size_t m_SourceBaseLen;
+    int  m_Error;
+};
+
+#endif
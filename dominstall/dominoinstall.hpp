@@ -1,7 +1,7 @@
 /*
 ###########################################################################
 # Domino Add-On Install                                                   #
-# Version 0.1 02.02.2023                                                  #
+# Version 0.2 19.10.2026                                                  #
 # (C) Copyright Daniel Nashed/NashCom 2023                                #
 #                                                                         #
 # Licensed under the Apache License, Version 2.0 (the "License");         #
@@ -18,9 +18,111 @@
 ###########################################################################
 */
 
+#ifndef DOMINOINSTALL_HPP
+    #define DOMINOINSTALL_HPP
+
+#include <stdio.h>
+
+#ifndef UNIX
+#include <windows.h>
+#include <process.h>
+#endif
+
 #define ENV_DOMINO_BIN     "autoinstall_DominoBin"
 #define ENV_DOMINO_DATA    "autoinstall_DominoData"
 #define ENV_DOMINO_INI     "autoinstall_DominoNotesIni"
 #define ENV_DOMINO_SERVICE "autoinstall_DominoService"
 #define ENV_DOMINO_VERSION "autoinstall_DominoVersion"
 #define ENV_DOMINO_BUILD   "autoinstall_DominoBuild"
+
+#ifdef UNIX
+    #define STRICMP  strcasecmp
+    #define PATHCMP  strcmp
+    #define POPEN    popen
+    #define PCLOSE   pclose
+    #define GETCWD   getcwd
+    #define CHDIR    chdir
+    #define GETPID   getpid
+
+    typedef int BOOL;
+
+    #ifndef TRUE
+        #define TRUE  1
+        #define FALSE 0
+    #endif
+
+#else
+    #define STRICMP _stricmp
+    #define PATHCMP _stricmp
+    #define POPEN   _popen
+    #define PCLOSE  _pclose
+    #define GETCWD  _getcwd
+    #define CHDIR   _chdir
+    #define GETPID  _getpid
+
+#endif
+
+#define RUN_COMMAND_ON_FIND_FLAG_FILE      1
+#define RUN_COMMAND_ON_FIND_FLAG_DIRECTORY 2
+
+#define MAX_COPY_THREADS      64
+#define DEFAULT_COPY_THREADS  8
+
+/* Install logs are written with a large buffer and flushed at phase boundaries and on errors */
+#define LOG_BUFFER_SIZE       (256*1024)
+
+/* Partitioned servers: Additional data directories sharing the program directory */
+#define MAX_DATA_DIRS         32
+
+#define OUTPUT_FORMAT_TEXT  0
+#define OUTPUT_FORMAT_JSON  1
+#define OUTPUT_FORMAT_CSV   2
+
+
+typedef struct
+{
+    char szName[1024];
+    char szVersion[100];
+    char szDescription[1024];
+    char szVendor[1024];
+    char szDepends[1024];
+} TYPE_SOFTWARE_INFO;
+
+typedef int (TYPE_CMD_FUNCTION_CALLBACK) (const char *pszFindPath, void *pCustomData);
+
+
+/* Globals */
+extern FILE *g_fpLog;
+extern FILE *g_fpFileInstallLog;
+extern FILE *g_fpEventLog;
+
+extern int  g_CopiedFiles;
+extern int  g_CopyErrors;
+extern char g_OsDirSep;
+
+
+/* Shared helpers */
+int  IsNullStr (const char *pszStr);
+void strdncpy (char *s, const char *ct, size_t n);
+unsigned int HashPath (const char *pszPath);
+int  replace_file (const char *pszSourcePath, const char *pszTargetPath);
+int  delete_file (const char *pszFileName);
+int  BuildPath (char *retpszCombinedPath, size_t BufferSize, const char *pszDir, const char *pszFile);
+int  create_directory (const char *pszDirectory);
+int  copy_file (const char *pszSourcePath, const char *pszTargetPath, BOOL bOverwrite);
+void LogCopyResult (int CopyResult, const char *pszTargetPath, long long Size, long long Duration);
+void LogSkippedFile (const char *pszTargetPath, long long Size, long long Duration);
+void LogPhase (const char *pszPhase);
+void FlushLogs();
+long long GetMicroseconds();
+void PrintJsonString (FILE *fp, const char *pszString);
+int  GetSoftwareInfoFromFile (TYPE_SOFTWARE_INFO *pInstSoft, const char *pszFilePath);
+int  GetSoftwareInfoFromBuffer (TYPE_SOFTWARE_INFO *pInstSoft, const char *pszBuffer);
+long DominoBuildNumFromVersion (const char *pszRelease, int *retpHotfix);
+int  RunCommandOnFileFind (long lFlags, const char *pszDirectory, const char *pszMatchFileName, TYPE_CMD_FUNCTION_CALLBACK *pCommandCallbackFunction, void *pCustomData, int levels);
+
+#ifdef UNIX
+void CopyDirectoryAttributes (const char *pszSourceDir, const char *pszTargetDir);
+#endif
+
+#endif
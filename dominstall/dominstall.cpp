@@ -1,7 +1,7 @@
 /*
 ###########################################################################
 # Domino Add-On Install                                                   #
-# Version 0.1 02.02.2023                                                  #
+# Version 0.2 19.10.2026                                                  #
 # (C) Copyright Daniel Nashed/NashCom 2023                                #
 #                                                                         #
 # Licensed under the Apache License, Version 2.0 (the "License");         #
@@ -15,14 +15,45 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
 # See the License for the specific language governing permissions and     #
 # limitations under the License.                                          #
+#                                                                         #
+#  Changes                                                                #
+#  -------                                                                #
+#                                                                         #
+#  V0.2 19.10.2026                                                        #
+#                                                                         #
+#   - Linux copy engine with reflink, copy_file_range and fallocate       #
+#   - Parallel work-stealing copy, largest files first (-threads=)        #
+#   - Manifest with XXH64 hashes, updates only copy changed files         #
+#   - Staged install with rename commit, journal and rollback             #
+#   - Parallel verify of installed files against the manifest (-verify)   #
+#   - Inventory index for -list with filters and JSON/CSV output          #
+#   - Iterative directory walker with getdents64 and unlimited path size  #
+#   - Install directly from a tar archive or stream (-tar=)               #
+#   - Parallel uninstall per directory, removes emptied directories       #
+#   - Install plan with disk space check before copying (-dry-run)        #
+#   - Batch install of multiple packages with dependencies (-pkg=)        #
+#   - Fan-out of data files to partitioned server data dirs               #
+#   - Buffered install logs, JSON lines file events (-eventlog)           #
+#   - Phase timing, throughput and copy latency histogram (stats.json)    #
+#   - Linux makefile and synthetic package benchmark (bench.sh)           #
+#                                                                         #
+#                                                                         #
 ###########################################################################
 */
 
 #ifdef UNIX
 
-#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/statvfs.h>
 
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
 #else
 
 #include <windows.h>
@@ -31,41 +62,49 @@
 #include <Softpub.h>
 #include <wintrust.h>
 #include <imagehlp.h>
+#include <malloc.h>
 
 #endif
 
 #include <sys/stat.h>
-#include <malloc.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-#include "dominoinstall.hpp"
+#include <chrono>
+#include <mutex>
+#include <thread>
 
+#include "dominoinstall.hpp"
+#include "copysched.hpp"
+#include "manifest.hpp"
+#include "journal.hpp"
+#include "verify.hpp"
+#include "tarinst.hpp"
+#include "uninstall.hpp"
+#include "plan.hpp"
+#include "batch.hpp"
+#include "stats.hpp"
 
-#ifdef UNIX
-    #define STRICMP strcasecmp
-    #define POPEN    popen
-    #define PCLOSE   pclose
-    #define GETCWD   getcwd
-    #define CHDIR    chdir
 
-#else
-    #define STRICMP _stricmp
-    #define POPEN   _popen
-    #define PCLOSE  _pclose
-    #define GETCWD  _getcwd
-    #define CHDIR   _chdir
 
-#endif
+typedef struct
+{
+    int  Threads;
+    BOOL bDeep;
+    int  Failed;
+} TYPE_VERIFY_INFO;
 
 
 typedef struct
 {
-    char szName[1024];
-    char szVersion[100];
-    char szDescription[1024];
-    char szVendor[1024];
-} TYPE_SOFTWARE_INFO;
+    const char *pszName;
+    const char *pszVendor;
+    const char *pszMinVersion;
+    const char *pszMaxVersion;
+    int  Format;
+    int  Count;
+} TYPE_LIST_FILTER;
 
 
 typedef struct
@@ -76,19 +115,33 @@ typedef struct
 } TYPE_VERSION_CHECK;
 
 
-typedef int (TYPE_CMD_FUNCTION_CALLBACK) (const char *pszFindPath, void *pCustomData);
-
 /* Globals */
 FILE *g_fpLog = NULL;
 FILE *g_fpFileInstallLog = NULL;
+FILE *g_fpEventLog = NULL;
 
 int  g_Debug  = 0;
 int  g_CopiedFiles = 0;
 int  g_CopyErrors = 0;
+int  g_CopyThreads = 0;
+int  g_SkippedFiles = 0;
+int  g_RemovedFiles = 0;
+
+std::mutex g_LogMutex;
 
 char g_InstallRegDirName[]  = ".install-reg";
 char g_InstallLogName[]     = "install.log";
 char g_InstallFileLogName[] = "file.log";
+char g_InstallManifestName[] = "manifest.txt";
+char g_InstallJournalName[]  = "journal.txt";
+char g_InstallEventLogName[] = "install.jsonl";
+char g_InstallStatsName[]    = "stats.json";
+char g_InstallDataDirsName[] = "datadirs.txt";
+
+char g_szLogBuffer[LOG_BUFFER_SIZE];
+char g_szFileLogBuffer[LOG_BUFFER_SIZE];
+char g_szEventLogBuffer[LOG_BUFFER_SIZE];
+char g_InventoryIndexName[]  = "inventory.txt";
 char g_InstallIniName[]     = "install.ini";
 char g_ReleaseStr[]         = "Release ";
 char g_ReleaseInstallStr[]  = "Release_";
@@ -148,6 +201,46 @@ const char * GetStringPtrAfterPrefix (const char *pszString, const char *pszPref
     return s;
 }
 
+unsigned int HashPath (const char *pszPath)
+{
+    /* FNV-1a hash for path lookups. Paths are case insensitive on Windows */
+
+    unsigned int hash = 2166136261u;
+    unsigned char c = 0;
+
+    while (*pszPath)
+    {
+        c = (unsigned char) *pszPath++;
+
+#ifndef UNIX
+        if ( (c >= 'A') && (c <= 'Z') )
+            c += 'a' - 'A';
+#endif
+
+        hash = (hash ^ c) * 16777619u;
+    }
+
+    return hash;
+}
+
+int replace_file (const char *pszSourcePath, const char *pszTargetPath)
+{
+    /* Rename replacing an existing target. Returns 0 on success */
+
+    int ret = 0;
+
+#ifdef UNIX
+    ret = rename (pszSourcePath, pszTargetPath);
+#else
+    ret = MoveFileEx (pszSourcePath, pszTargetPath, MOVEFILE_REPLACE_EXISTING) ? 0 : 1;
+#endif
+
+    if (ret && g_fpLog)
+        fprintf (g_fpLog, "Cannot rename [%s] -> [%s]\n", pszSourcePath, pszTargetPath);
+
+    return ret;
+}
+
 int delete_file (const char *pszFileName)
 {
     int ret = 0;
@@ -156,6 +249,14 @@ int delete_file (const char *pszFileName)
         goto Done;
 
 #ifdef UNIX
+    ret = (0 == unlink (pszFileName));
+
+    if (g_fpLog)
+    {
+        if (0 == ret)
+            fprintf (g_fpLog, "Cannot delete file: %s (%s)\n", pszFileName, strerror (errno));
+    }
+
 #else
     ret = DeleteFile (pszFileName);
 
@@ -269,6 +370,23 @@ Done:
 
 
 #ifdef UNIX
+
+/* Authenticode signatures only exist on Windows */
+
+int GetEmbeddedSignature (const char *pszFileName, int MaxRetBufferSize, char *retpszRetBuffer)
+{
+    if ((NULL == retpszRetBuffer) || (0 == MaxRetBufferSize))
+        return 2;
+
+    snprintf (retpszRetBuffer, MaxRetBufferSize-1, "Signature check not supported on this platform");
+    return 2;
+}
+
+int VerifyEmbeddedSignature (const char *pszFileName, int MaxRetBufferSize, char *retpszRetBuffer)
+{
+    return GetEmbeddedSignature (pszFileName, MaxRetBufferSize, retpszRetBuffer);
+}
+
 #else
 
 void GetWindowsErrorString (const char *pszErrorMessage, int MaxRetBufferSize, char *retpszRetBuffer)
@@ -615,6 +733,90 @@ int BuildPath (char *retpszCombinedPath, size_t BufferSize, const char *pszDir,
     return snprintf (retpszCombinedPath, BufferSize-1, "%s%c%s", pszDir, g_OsDirSep, pszFile);
 }
 
+#ifdef UNIX
+
+int GetDominoVersion (const char *pszBinaryDir, char *retpszVersion, int MaxVersionBuffer)
+{
+    /* There are no string resources to load on UNIX. The release string is embedded in libnotes */
+
+    int   len   = 0;
+    int   fd    = -1;
+    char  *pMap = NULL;
+    const char *p    = NULL;
+    const char *pEnd = NULL;
+    struct stat Stat = {0};
+
+    char szNotesLib[1024] = {0};
+
+    if ((NULL == retpszVersion) || (0 == MaxVersionBuffer))
+        goto Done;
+
+    *retpszVersion = '\0';
+
+    snprintf (szNotesLib, sizeof (szNotesLib)-1, "%s%c%s", pszBinaryDir, g_OsDirSep, "libnotes.so");
+
+    fd = open (szNotesLib, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        printf ("Cannot open [%s]: %s\n", szNotesLib, strerror (errno));
+        goto Done;
+    }
+
+    if (fstat (fd, &Stat) || (0 == Stat.st_size))
+        goto Done;
+
+    pMap = (char *) mmap (NULL, Stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (MAP_FAILED == pMap)
+    {
+        pMap = NULL;
+        printf ("Cannot map [%s]: %s\n", szNotesLib, strerror (errno));
+        goto Done;
+    }
+
+    p    = pMap;
+    pEnd = pMap + Stat.st_size;
+
+    /* First "Release " followed by a digit is the Domino release string */
+    while (NULL != (p = (const char *) memmem (p, pEnd - p, g_ReleaseStr, strlen (g_ReleaseStr))))
+    {
+        p += strlen (g_ReleaseStr);
+
+        if ((p < pEnd) && (*p >= '0') && (*p <= '9'))
+        {
+            p -= strlen (g_ReleaseStr);
+
+            while ((p < pEnd) && ((unsigned char) *p >= 32) && (len < MaxVersionBuffer-1))
+                retpszVersion[len++] = *p++;
+
+            retpszVersion[len] = '\0';
+            break;
+        }
+    }
+
+    if (0 == len)
+        printf ("No release string found in [%s]\n", szNotesLib);
+
+Done:
+
+    if (pMap)
+    {
+        munmap (pMap, Stat.st_size);
+        pMap = NULL;
+    }
+
+    if (fd >= 0)
+    {
+        close (fd);
+        fd = -1;
+    }
+
+    return len;
+}
+
+#else
+
 int GetDominoVersion (const char *pszBinaryDir, char *retpszVersion, int MaxVersionBuffer)
 {
     int len = 0;
@@ -659,231 +861,832 @@ Done:
     return len;
 }
 
-#ifdef UNIX
-
-int CopyFilesFromDirectory (const char *pszDirectory, const char *pszTargetDir, int levels)
-{
-    int ret = 0;
-    BOOL bFileCopied = FALSE;
-    DIR *pDir        = NULL;
-    struct dirent *pEntry = NULL;
-
-    pDir = opendir (pszDirectory);
-    if (NULL == pDir)
-        goto Done;
-
-    while (NULL != (pEntry = readdir (pDir)) )
-    {
-        fprintf (g_fpLog, "%s\n", pEntry->d_name);
-    }
-
-Done:
-
-    if (pDir)
-    {
-        closedir (pDir);
-        pDir = NULL;
-    }
+#endif
 
-    return ret;
-}
+#ifdef UNIX
 
-#else
+#define COPY_BUFFER_SIZE (1024*1024)
 
 int create_directory (const char *pszDirectory)
 {
+    /* Returns 0 if the directory was created */
+
     int ret = 0;
 
-    CreateDirectory (pszDirectory, NULL);
+    ret = mkdir (pszDirectory, 0755);
 
     return ret;
 }
 
-int copy_file (const char *pszSourcePath, const char *pszTargetPath, BOOL bOverwrite)
+int CopyFileData (int fdSource, int fdTarget, off_t Size, off_t *retpCopied)
 {
-    int ret = 0;
+    /* Copy file content preferring kernel side copy. Falls back to large read/write blocks */
 
-    BOOL bFileCopied = FALSE;
-    bFileCopied = CopyFile (pszSourcePath, pszTargetPath, bOverwrite ? FALSE : TRUE);
+    int     ret     = 0;
+    ssize_t len     = 0;
+    ssize_t written = 0;
+    off_t   offset  = 0;
+    char    *pBuffer = NULL;
 
-    if (!bFileCopied)
+#ifdef __linux__
+
+    /* Reflink shares the data blocks on CoW file systems (btrfs, XFS) and completes without copying */
+    if (0 == ioctl (fdTarget, FICLONE, fdSource))
     {
-        printf ("Error copying file [%s] -> [%s]\n", pszSourcePath, pszTargetPath);
-        fprintf (g_fpLog, "Error copying file [%s] -> [%s]\n", pszSourcePath, pszTargetPath);
+        offset = Size;
+        goto Done;
     }
 
-    return ret;
-}
-
-int CopyFileToTargetDir (const char *pszFileName, const char *pszSourceDir, const char *pszTargetDir)
-{
-    int ret = 0;
+    /* Preallocate target to avoid fragmentation and to fail early on a full disk */
+    if (Size > 0)
+    {
+        if (fallocate (fdTarget, 0, 0, Size))
+        {
+            if (ENOSPC == errno)
+            {
+                ret = ENOSPC;
+                goto Done;
+            }
+        }
+    }
 
-    char szSourcePath[1024] = {0};
-    char szTargetPath[1024] = {0};
+    while (offset < Size)
+    {
+        len = copy_file_range (fdSource, &offset, fdTarget, NULL, Size - offset, 0);
 
-    BuildPath (szSourcePath, sizeof (szSourcePath), pszSourceDir, pszFileName);
-    BuildPath (szTargetPath, sizeof (szTargetPath), pszTargetDir, pszFileName);
+        if (len > 0)
+            continue;
 
-    ret = copy_file (szSourcePath, szTargetPath, TRUE);
+        if (0 == len)
+            break;
 
-    if (0 == ret)
-    {
-        g_CopiedFiles++;
+        if (EINTR == errno)
+            continue;
 
-        if (g_fpFileInstallLog)
-            fprintf (g_fpFileInstallLog, "%s\n", szTargetPath);
-    }
-    else
-    {
-        g_CopyErrors++;
+        /* Not supported for this file system combination: Continue at the current offset with read/write */
+        if ((EXDEV == errno) || (ENOSYS == errno) || (EINVAL == errno) || (EOPNOTSUPP == errno))
+            break;
 
-        if (g_fpFileInstallLog)
-            fprintf (g_fpFileInstallLog, "ERROR:%s\n", szTargetPath);
+        ret = errno;
+        goto Done;
     }
 
-Done:
-    return ret;
-}
-
-int CopyFilesFromDirectory (const char *pszDirectory, const char *pszTargetDir, int levels)
-{
-    int ret = 0;
-    char szFindPath[1024]       = {0};
-    char szNextTargetDir[1024]  = {0};
-
-    if (levels <= 0)
+    if (offset >= Size)
         goto Done;
 
-    WIN32_FIND_DATA file;
-    HANDLE hSearch = NULL;
+    if (offset != lseek (fdTarget, offset, SEEK_SET))
+    {
+        ret = errno;
+        goto Done;
+    }
 
-    BuildPath (szFindPath, sizeof (szFindPath), pszDirectory, "*");
+    posix_fadvise (fdSource, offset, 0, POSIX_FADV_SEQUENTIAL);
 
-    hSearch = FindFirstFile (szFindPath, &file);
+#endif
 
-    if (NULL == hSearch)
-        goto Done;
+    pBuffer = (char *) malloc (COPY_BUFFER_SIZE);
 
-    if (INVALID_HANDLE_VALUE == hSearch)
+    if (NULL == pBuffer)
+    {
+        ret = ENOMEM;
         goto Done;
+    }
 
-    do
+    while (1)
     {
-        if (0 == strcmp (file.cFileName, "."))
-            continue;
+        len = pread (fdSource, pBuffer, COPY_BUFFER_SIZE, offset);
 
-        if (0 == strcmp (file.cFileName, ".."))
-            continue;
+        if (0 == len)
+            break;
 
-        if (FILE_ATTRIBUTE_DIRECTORY & file.dwFileAttributes)
+        if (len < 0)
         {
-            BuildPath (szNextTargetDir, sizeof (szNextTargetDir), pszTargetDir, file.cFileName);
-            create_directory (szNextTargetDir);
+            if (EINTR == errno)
+                continue;
 
-            BuildPath (szFindPath, sizeof (szFindPath), pszDirectory, file.cFileName);
-            CopyFilesFromDirectory (szFindPath, szNextTargetDir, levels-1);
+            ret = errno;
+            goto Done;
         }
-        else
+
+        written = 0;
+
+        while (written < len)
         {
-            CopyFileToTargetDir (file.cFileName, pszDirectory, pszTargetDir);
+            ssize_t w = write (fdTarget, pBuffer + written, len - written);
+
+            if (w < 0)
+            {
+                if (EINTR == errno)
+                    continue;
+
+                ret = errno;
+                goto Done;
+            }
+
+            written += w;
         }
 
-    } while (FindNextFile (hSearch, &file) );
+        offset += len;
+    }
 
 Done:
 
-    if (hSearch)
+    if (pBuffer)
     {
-        CloseHandle (hSearch);
-        hSearch = NULL;
+        free (pBuffer);
+        pBuffer = NULL;
     }
 
+    if (retpCopied)
+        *retpCopied = offset;
+
     return ret;
 }
 
-int GetSoftwareInfoFromFile (TYPE_SOFTWARE_INFO *pInstSoft, const char *pszFilePath)
+int CopySymbolicLink (const char *pszSourcePath, const char *pszTargetPath, BOOL bOverwrite)
 {
-    int ret  = 0;
-    FILE *fp = NULL;
+    ssize_t len = 0;
+    char szLink[4096] = {0};
 
-    char szBuffer[1024] = {0};
-    char *pEqual = NULL;
-    char *pValue = NULL;
-    char *p      = NULL;
+    len = readlink (pszSourcePath, szLink, sizeof (szLink)-1);
 
-    fp = fopen (pszFilePath, "r");
+    if (len < 0)
+        return errno;
 
-    if (NULL == fp)
-    {
-        printf ("Cannot open: [%s]\n", pszFilePath);
-        ret = 1;
-        goto Done;
-    }
+    szLink[len] = '\0';
 
-    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
-    {
-        pEqual = strstr (szBuffer, "=");
+    if (0 == symlink (szLink, pszTargetPath))
+        return 0;
 
-        if (pEqual)
-        {
-            *pEqual = '\0';
-            pValue=pEqual+1;
+    if ((EEXIST != errno) || (FALSE == bOverwrite))
+        return errno;
 
-            /* Remove control chars end of line */
-            p=pValue;
+    unlink (pszTargetPath);
 
-            while (*p)
-            {
-                if (*p < 32)
-                {
-                    *p = '\0';
-                    break;
-                }
-                p++;
-            }
+    if (symlink (szLink, pszTargetPath))
+        return errno;
 
-            if (0 == strcmp (szBuffer, "name"))
-                strdncpy (pInstSoft->szName, pValue, sizeof (pInstSoft->szName));
+    return 0;
+}
 
-            else if (0 == strcmp (szBuffer, "version"))
-                strdncpy (pInstSoft->szVersion, pValue, sizeof (pInstSoft->szVersion));
+void CopyAttributes (int fdTarget, const struct stat *pStat)
+{
+    /* Preserve mode and timestamps. Ownership stays with the installing user */
 
-            else if (0 == strcmp (szBuffer, "description"))
-                strdncpy (pInstSoft->szDescription, pValue, sizeof (pInstSoft->szDescription));
+    struct timespec Times[2];
 
-            else if (0 == strcmp (szBuffer, "vendor"))
-                strdncpy (pInstSoft->szVendor, pValue, sizeof (pInstSoft->szVendor));
-        }
-    } /* while */
+    Times[0] = pStat->st_atim;
+    Times[1] = pStat->st_mtim;
 
-Done:
+    fchmod (fdTarget, pStat->st_mode & 07777);
+    futimens (fdTarget, Times);
+}
 
-    if (fp)
+int copy_file (const char *pszSourcePath, const char *pszTargetPath, BOOL bOverwrite)
+{
+    int   ret      = 0;
+    int   fdSource = -1;
+    int   fdTarget = -1;
+    int   Flags    = O_WRONLY | O_CREAT | O_CLOEXEC | (bOverwrite ? O_TRUNC : O_EXCL);
+    off_t Copied   = 0;
+    struct stat Stat = {0};
+
+    if (0 == lstat (pszSourcePath, &Stat) && S_ISLNK (Stat.st_mode))
     {
-        fclose (fp);
-        fp = NULL;
+        ret = CopySymbolicLink (pszSourcePath, pszTargetPath, bOverwrite);
+        goto Done;
     }
 
-    return ret;
-}
+    fdSource = open (pszSourcePath, O_RDONLY | O_CLOEXEC);
 
-int PrintSoftwareInfo (const char *pszFindPath, void *pCustomData)
-{
-    int ret = 0;
-    TYPE_SOFTWARE_INFO SoftInfo = {0};
+    if (fdSource < 0)
+    {
+        ret = errno;
+        goto Done;
+    }
 
-    ret = GetSoftwareInfoFromFile (&SoftInfo, pszFindPath);
-    if (ret)
+    if (fstat (fdSource, &Stat))
+    {
+        ret = errno;
         goto Done;
+    }
 
-    printf ("%s|%s|%s\n", SoftInfo.szName, SoftInfo.szVersion, SoftInfo.szDescription);
+    fdTarget = open (pszTargetPath, Flags, S_IRUSR | S_IWUSR);
 
-Done:
-    return ret;
-}
+    /* A running binary cannot be truncated. Unlink it and write a new file. The running process keeps the old inode */
+    if ((fdTarget < 0) && (ETXTBSY == errno) && bOverwrite)
+    {
+        unlink (pszTargetPath);
+        fdTarget = open (pszTargetPath, Flags, S_IRUSR | S_IWUSR);
+    }
 
-int IsExecutable (const char *pszFindPath)
+    if (fdTarget < 0)
+    {
+        ret = errno;
+        goto Done;
+    }
+
+    ret = CopyFileData (fdSource, fdTarget, Stat.st_size, &Copied);
+
+    if (ret)
+        goto Done;
+
+    /* Source shrunk while copying */
+    if (Copied < Stat.st_size)
+        ftruncate (fdTarget, Copied);
+
+    CopyAttributes (fdTarget, &Stat);
+
+Done:
+
+    if (fdSource >= 0)
+    {
+        close (fdSource);
+        fdSource = -1;
+    }
+
+    if (fdTarget >= 0)
+    {
+        if (close (fdTarget) && (0 == ret))
+            ret = errno;
+
+        fdTarget = -1;
+
+        /* Don't leave partial files behind */
+        if (ret)
+            unlink (pszTargetPath);
+    }
+
+    if (ret)
+    {
+        printf ("Error copying file [%s] -> [%s]: %s\n", pszSourcePath, pszTargetPath, strerror (ret));
+
+        if (g_fpLog)
+            fprintf (g_fpLog, "Error copying file [%s] -> [%s]: %s\n", pszSourcePath, pszTargetPath, strerror (ret));
+    }
+
+    return ret;
+}
+
+#else
+
+int create_directory (const char *pszDirectory)
+{
+    /* Returns 0 if the directory was created */
+
+    int ret = 0;
+
+    ret = CreateDirectory (pszDirectory, NULL) ? 0 : 1;
+
+    return ret;
+}
+
+int copy_file (const char *pszSourcePath, const char *pszTargetPath, BOOL bOverwrite)
+{
+    int ret = 0;
+
+    BOOL bFileCopied = FALSE;
+    bFileCopied = CopyFile (pszSourcePath, pszTargetPath, bOverwrite ? FALSE : TRUE);
+
+    if (!bFileCopied)
+    {
+        ret = 1;
+        printf ("Error copying file [%s] -> [%s]\n", pszSourcePath, pszTargetPath);
+        fprintf (g_fpLog, "Error copying file [%s] -> [%s]\n", pszSourcePath, pszTargetPath);
+    }
+
+    return ret;
+}
+
+#endif
+
+long long GetMicroseconds()
+{
+    /* Monotonic time for durations */
+
+    return (long long) std::chrono::duration_cast<std::chrono::microseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FILE *OpenLogFile (const char *pszFileName, char *pBuffer)
+{
+    /* Log lines are collected in a large buffer instead of one write per line */
+
+    FILE *fp = fopen (pszFileName, "w");
+
+    if (fp)
+        setvbuf (fp, pBuffer, _IOFBF, LOG_BUFFER_SIZE);
+
+    return fp;
+}
+
+void FlushLogs()
+{
+    /* Called at phase boundaries and on errors, so the logs are complete up to the last phase after a crash */
+
+    std::lock_guard<std::mutex> Lock (g_LogMutex);
+
+    if (g_fpLog)
+        fflush (g_fpLog);
+
+    if (g_fpFileInstallLog)
+        fflush (g_fpFileInstallLog);
+
+    if (g_fpEventLog)
+        fflush (g_fpEventLog);
+}
+
+void LogPhase (const char *pszPhase)
+{
+    if (g_fpLog)
+        fprintf (g_fpLog, "Phase=%s\n", pszPhase);
+
+    if (g_fpEventLog)
+        fprintf (g_fpEventLog, "{\"event\":\"phase\",\"phase\":\"%s\"}\n", pszPhase);
+
+    FlushLogs();
+}
+
+void LogFileEvent (const char *pszTargetPath, long long Size, long long Duration, const char *pszResult)
+{
+    /* JSON lines event per file. Called with the log mutex locked */
+
+    if (NULL == g_fpEventLog)
+        return;
+
+    fprintf (g_fpEventLog, "{\"event\":\"file\",\"file\":");
+    PrintJsonString (g_fpEventLog, pszTargetPath);
+    fprintf (g_fpEventLog, ",\"bytes\":%lld,\"duration_us\":%lld,\"result\":\"%s\"}\n", Size, Duration, pszResult);
+}
+
+void LogCopyResult (int CopyResult, const char *pszTargetPath, long long Size, long long Duration)
+{
+    /* Called from parallel copy threads. Counters and file log lines must not interleave */
+
+    std::lock_guard<std::mutex> Lock (g_LogMutex);
+
+    if (0 == CopyResult)
+    {
+        g_CopiedFiles++;
+
+        if (g_fpFileInstallLog)
+            fprintf (g_fpFileInstallLog, "%s\n", pszTargetPath);
+
+        LogFileEvent (pszTargetPath, Size, Duration, "copied");
+    }
+    else
+    {
+        g_CopyErrors++;
+
+        if (g_fpFileInstallLog)
+            fprintf (g_fpFileInstallLog, "ERROR:%s\n", pszTargetPath);
+
+        LogFileEvent (pszTargetPath, Size, Duration, "error");
+    }
+}
+
+void LogSkippedFile (const char *pszTargetPath, long long Size, long long Duration)
+{
+    /* Unchanged file is still part of the installation and listed in the file log */
+
+    std::lock_guard<std::mutex> Lock (g_LogMutex);
+
+    g_SkippedFiles++;
+
+    if (g_fpFileInstallLog)
+        fprintf (g_fpFileInstallLog, "%s\n", pszTargetPath);
+
+    LogFileEvent (pszTargetPath, Size, Duration, "unchanged");
+}
+
+#ifdef UNIX
+
+void CopyDirectoryAttributes (const char *pszSourceDir, const char *pszTargetDir)
+{
+    struct stat Stat = {0};
+    struct timespec Times[2];
+
+    if (stat (pszSourceDir, &Stat))
+        return;
+
+    Times[0] = Stat.st_atim;
+    Times[1] = Stat.st_mtim;
+
+    chmod (pszTargetDir, Stat.st_mode & 07777);
+    utimensat (AT_FDCWD, pszTargetDir, Times, 0);
+}
+
+#endif
+
+void ParseSoftwareInfoLine (TYPE_SOFTWARE_INFO *pInstSoft, char *pszLine)
+{
+    char *pEqual = NULL;
+    char *pValue = NULL;
+    char *p      = NULL;
+
+    pEqual = strstr (pszLine, "=");
+
+    if (NULL == pEqual)
+        return;
+
+    *pEqual = '\0';
+    pValue=pEqual+1;
+
+    /* Remove control chars end of line */
+    p=pValue;
+
+    while (*p)
+    {
+        if (*p < 32)
+        {
+            *p = '\0';
+            break;
+        }
+        p++;
+    }
+
+    if (0 == strcmp (pszLine, "name"))
+        strdncpy (pInstSoft->szName, pValue, sizeof (pInstSoft->szName));
+
+    else if (0 == strcmp (pszLine, "version"))
+        strdncpy (pInstSoft->szVersion, pValue, sizeof (pInstSoft->szVersion));
+
+    else if (0 == strcmp (pszLine, "description"))
+        strdncpy (pInstSoft->szDescription, pValue, sizeof (pInstSoft->szDescription));
+
+    else if (0 == strcmp (pszLine, "vendor"))
+        strdncpy (pInstSoft->szVendor, pValue, sizeof (pInstSoft->szVendor));
+
+    else if (0 == strcmp (pszLine, "depends"))
+        strdncpy (pInstSoft->szDepends, pValue, sizeof (pInstSoft->szDepends));
+}
+
+int GetSoftwareInfoFromBuffer (TYPE_SOFTWARE_INFO *pInstSoft, const char *pszBuffer)
+{
+    /* install.ini read into memory, e.g. from an archive */
+
+    size_t len = 0;
+    const char *p = pszBuffer;
+
+    char szBuffer[1024] = {0};
+
+    if (NULL == p)
+        return 1;
+
+    while (*p)
+    {
+        len = strcspn (p, "\n");
+
+        if (len >= sizeof (szBuffer))
+            len = sizeof (szBuffer)-1;
+
+        memcpy (szBuffer, p, len);
+        szBuffer[len] = '\0';
+
+        ParseSoftwareInfoLine (pInstSoft, szBuffer);
+
+        p += strcspn (p, "\n");
+
+        if ('\n' == *p)
+            p++;
+    }
+
+    return 0;
+}
+
+int GetSoftwareInfoFromFile (TYPE_SOFTWARE_INFO *pInstSoft, const char *pszFilePath)
+{
+    int ret  = 0;
+    FILE *fp = NULL;
+
+    char szBuffer[1024] = {0};
+
+    fp = fopen (pszFilePath, "r");
+
+    if (NULL == fp)
+    {
+        printf ("Cannot open: [%s]\n", pszFilePath);
+        ret = 1;
+        goto Done;
+    }
+
+    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    {
+        ParseSoftwareInfoLine (pInstSoft, szBuffer);
+    } /* while */
+
+Done:
+
+    if (fp)
+    {
+        fclose (fp);
+        fp = NULL;
+    }
+
+    return ret;
+}
+
+int CompareVersion (const char *pszVersion1, const char *pszVersion2)
+{
+    /* Compares the numbers of a version one by one: 1.10 > 1.9 and 2.0 == 2. Other characters only separate numbers */
+
+    long Num1 = 0;
+    long Num2 = 0;
+    const char *p1 = pszVersion1;
+    const char *p2 = pszVersion2;
+
+    while (*p1 || *p2)
+    {
+        while (*p1 && ((*p1 < '0') || (*p1 > '9')))
+            p1++;
+
+        while (*p2 && ((*p2 < '0') || (*p2 > '9')))
+            p2++;
+
+        Num1 = 0;
+        Num2 = 0;
+
+        while ((*p1 >= '0') && (*p1 <= '9'))
+            Num1 = Num1 * 10 + (*p1++ - '0');
+
+        while ((*p2 >= '0') && (*p2 <= '9'))
+            Num2 = Num2 * 10 + (*p2++ - '0');
+
+        if (Num1 != Num2)
+            return (Num1 < Num2) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+void PrintJsonString (FILE *fp, const char *pszString)
+{
+    const unsigned char *p = (const unsigned char *) pszString;
+
+    fputc ('"', fp);
+
+    while (*p)
+    {
+        if (('"' == *p) || ('\\' == *p))
+            fprintf (fp, "\\%c", *p);
+        else if (*p < 32)
+            fprintf (fp, "\\u%04x", *p);
+        else
+            fputc (*p, fp);
+        p++;
+    }
+
+    fputc ('"', fp);
+}
+
+void PrintCsvString (FILE *fp, const char *pszString)
+{
+    const char *p = pszString;
+
+    fputc ('"', fp);
+
+    while (*p)
+    {
+        if ('"' == *p)
+            fputc ('"', fp);
+
+        fputc (*p, fp);
+        p++;
+    }
+
+    fputc ('"', fp);
+}
+
+int PrintSoftwareInfo (const TYPE_SOFTWARE_INFO *pSoftInfo, TYPE_LIST_FILTER *pFilter)
+{
+    if (!IsNullStr (pFilter->pszName) && STRICMP (pFilter->pszName, pSoftInfo->szName))
+        return 0;
+
+    if (!IsNullStr (pFilter->pszVendor) && STRICMP (pFilter->pszVendor, pSoftInfo->szVendor))
+        return 0;
+
+    if (!IsNullStr (pFilter->pszMinVersion) && (CompareVersion (pSoftInfo->szVersion, pFilter->pszMinVersion) < 0))
+        return 0;
+
+    if (!IsNullStr (pFilter->pszMaxVersion) && (CompareVersion (pSoftInfo->szVersion, pFilter->pszMaxVersion) > 0))
+        return 0;
+
+    switch (pFilter->Format)
+    {
+        case OUTPUT_FORMAT_JSON:
+
+            printf ("%s\n  {\"name\": ", pFilter->Count ? "," : "");
+            PrintJsonString (stdout, pSoftInfo->szName);
+            printf (", \"version\": ");
+            PrintJsonString (stdout, pSoftInfo->szVersion);
+            printf (", \"vendor\": ");
+            PrintJsonString (stdout, pSoftInfo->szVendor);
+            printf (", \"description\": ");
+            PrintJsonString (stdout, pSoftInfo->szDescription);
+            printf ("}");
+            break;
+
+        case OUTPUT_FORMAT_CSV:
+
+            PrintCsvString (stdout, pSoftInfo->szName);
+            printf (",");
+            PrintCsvString (stdout, pSoftInfo->szVersion);
+            printf (",");
+            PrintCsvString (stdout, pSoftInfo->szVendor);
+            printf (",");
+            PrintCsvString (stdout, pSoftInfo->szDescription);
+            printf ("\n");
+            break;
+
+        default:
+            printf ("%s|%s|%s\n", pSoftInfo->szName, pSoftInfo->szVersion, pSoftInfo->szDescription);
+            break;
+    } /* switch */
+
+    pFilter->Count++;
+    return 1;
+}
+
+int PrintSoftwareInfoFromFile (const char *pszFindPath, void *pCustomData)
+{
+    int ret = 0;
+    TYPE_SOFTWARE_INFO SoftInfo = {0};
+
+    ret = GetSoftwareInfoFromFile (&SoftInfo, pszFindPath);
+    if (ret)
+        goto Done;
+
+    PrintSoftwareInfo (&SoftInfo, (TYPE_LIST_FILTER *) pCustomData);
+
+Done:
+    return ret;
+}
+
+void WriteInventoryField (FILE *fp, const char *pszValue)
+{
+    /* Separator and backslash are escaped with a backslash */
+
+    const char *p = pszValue;
+
+    while (*p)
+    {
+        if (('|' == *p) || ('\\' == *p))
+            fputc ('\\', fp);
+
+        fputc (*p, fp);
+        p++;
+    }
+}
+
+int WriteInventoryEntry (const char *pszFindPath, void *pCustomData)
+{
+    int ret = 0;
+    FILE *fp = (FILE *) pCustomData;
+    TYPE_SOFTWARE_INFO SoftInfo = {0};
+
+    ret = GetSoftwareInfoFromFile (&SoftInfo, pszFindPath);
+    if (ret)
+        goto Done;
+
+    if (!*SoftInfo.szName)
+        goto Done;
+
+    WriteInventoryField (fp, SoftInfo.szName);
+    fputc ('|', fp);
+    WriteInventoryField (fp, SoftInfo.szVersion);
+    fputc ('|', fp);
+    WriteInventoryField (fp, SoftInfo.szVendor);
+    fputc ('|', fp);
+    WriteInventoryField (fp, SoftInfo.szDescription);
+    fputc ('\n', fp);
+
+Done:
+    return ret;
+}
+
+int UpdateInventoryIndex (const char *pszInstallRegDir)
+{
+    /* Rebuilt from all install.ini files after each install and remove.
+       Written to a temporary file and renamed, readers always see a complete index */
+
+    int  ret = 0;
+    FILE *fp = NULL;
+
+    char szIndexFile[1024] = {0};
+    char szTempFile[1024]  = {0};
+
+    BuildPath (szIndexFile, sizeof (szIndexFile), pszInstallRegDir, g_InventoryIndexName);
+    /* Packages of a batch install update the index concurrently */
+    snprintf (szTempFile, sizeof (szTempFile)-1, "%s.%d.tmp", szIndexFile, (int) GETPID());
+
+    fp = fopen (szTempFile, "w");
+
+    if (NULL == fp)
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_FILE, pszInstallRegDir, g_InstallIniName, WriteInventoryEntry, fp, 2);
+
+    if (fflush (fp) || ferror (fp))
+        ret = 1;
+
+    if (fclose (fp))
+        ret = 1;
+
+    fp = NULL;
+
+    if (ret)
+    {
+        remove (szTempFile);
+        goto Done;
+    }
+
+    ret = replace_file (szTempFile, szIndexFile);
+
+Done:
+
+    if (ret && g_fpLog)
+        fprintf (g_fpLog, "Cannot update inventory index: [%s]\n", szIndexFile);
+
+    return ret;
+}
+
+int ReadInventoryIndex (const char *pszInstallRegDir, TYPE_LIST_FILTER *pFilter)
+{
+    int  ret = 0;
+    FILE *fp = NULL;
+    char *p  = NULL;
+    int  Field = 0;
+    size_t Pos = 0;
+    TYPE_SOFTWARE_INFO SoftInfo = {0};
+
+    /* name|version|vendor|description */
+    char   *pField[4]    = { SoftInfo.szName, SoftInfo.szVersion, SoftInfo.szVendor, SoftInfo.szDescription };
+    size_t FieldSize[4]  = { sizeof (SoftInfo.szName), sizeof (SoftInfo.szVersion), sizeof (SoftInfo.szVendor), sizeof (SoftInfo.szDescription) };
+
+    char szIndexFile[1024] = {0};
+    char szBuffer[4096]    = {0};
+
+    BuildPath (szIndexFile, sizeof (szIndexFile), pszInstallRegDir, g_InventoryIndexName);
+
+    fp = fopen (szIndexFile, "r");
+
+    if (NULL == fp)
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    {
+        /* Fields are unescaped and copied up to the size of the target field.
+           An unescaped separator in the description of an older index is kept */
+        p = szBuffer;
+        Field = 0;
+        Pos = 0;
+
+        while ((unsigned char) *p >= 32)
+        {
+            if (('\\' == *p) && (('|' == *(p+1)) || ('\\' == *(p+1))))
+            {
+                p++;
+            }
+            else if (('|' == *p) && (Field < 3))
+            {
+                pField[Field++][Pos] = '\0';
+                Pos = 0;
+                p++;
+                continue;
+            }
+
+            if (Pos < FieldSize[Field]-1)
+                pField[Field][Pos++] = *p;
+
+            p++;
+        }
+
+        pField[Field][Pos] = '\0';
+
+        if (Field < 3)
+            continue;
+
+        PrintSoftwareInfo (&SoftInfo, pFilter);
+
+    } /* while */
+
+Done:
+
+    if (fp)
+    {
+        fclose (fp);
+        fp = NULL;
+    }
+
+    return ret;
+}
+
+int IsExecutable (const char *pszFindPath)
 {
     const char *pExt = NULL;
     const char *p    = NULL;
@@ -934,7 +1737,6 @@ int CheckSignature (const char *pszFindPath, void *pCustomData)
         }
     }
 
-Done:
     return ret;
 }
 
@@ -976,139 +1778,178 @@ int CheckInstallVersion (const char *pszFindPath, void *pCustomData)
     return 1;
 }
 
-#define RUN_COMMAND_ON_FIND_FLAG_FILE      1
-#define RUN_COMMAND_ON_FIND_FLAG_DIRECTORY 2
 
-int RunCommandOnFileFind (long lFlags, const char *pszDirectory, const char *pszMatchFileName, TYPE_CMD_FUNCTION_CALLBACK *pCommandCallbackFunction, void *pCustomData, int levels)
+int CopyInstallDirectory (const char *pszBaseDir, const char *pszDirectory, const char *pszTargetDir, const char *pszTargetSubDir, int levels, CopyScheduler *pScheduler)
 {
+    /* Files are only collected and copied in parallel by CopyScheduler::Run() */
+
     int ret = 0;
-    char szFindPath[1024] = {0};
+    char szSourcePath[1024]  = {0};
+    char szTargetPath[1024]  = {0};
 
-    if (levels <= 0)
+    if (IsNullStr (pszBaseDir))
         goto Done;
 
-    if (NULL == pszMatchFileName)
+    if (IsNullStr (pszDirectory))
         goto Done;
 
-    WIN32_FIND_DATA file;
-    HANDLE hSearch = NULL;
-
-    BuildPath (szFindPath, sizeof (szFindPath), pszDirectory, "*");
-
-    hSearch = FindFirstFile (szFindPath, &file);
-
-    if (NULL == hSearch)
+    if (IsNullStr (pszTargetDir))
         goto Done;
 
-    if (INVALID_HANDLE_VALUE == hSearch)
+    if (NULL == pScheduler)
         goto Done;
 
-    if (NULL == pCommandCallbackFunction)
+    if (levels <= 0)
         goto Done;
 
-    do
-    {
-        if (0 == strcmp (file.cFileName, "."))
-            continue;
+    BuildPath (szSourcePath, sizeof (szSourcePath), pszBaseDir, pszDirectory);
 
-        if (0 == strcmp (file.cFileName, ".."))
-            continue;
+    if (IsNullStr (pszTargetSubDir))
+        strdncpy (szTargetPath, pszTargetDir, sizeof (szTargetPath));
+    else
+        BuildPath (szTargetPath, sizeof (szTargetPath), pszTargetDir, pszTargetSubDir);
 
-        BuildPath (szFindPath, sizeof (szFindPath), pszDirectory, file.cFileName);
+    ret = pScheduler->AddDirectory (szSourcePath, szTargetPath, levels);
 
-        if (FILE_ATTRIBUTE_DIRECTORY & file.dwFileAttributes)
-        {
-            if (RUN_COMMAND_ON_FIND_FLAG_DIRECTORY & lFlags)
-            {
-                pCommandCallbackFunction (szFindPath, pCustomData);
-            }
+Done:
+    return ret;
+}
 
-            RunCommandOnFileFind (lFlags, szFindPath, pszMatchFileName, pCommandCallbackFunction, pCustomData, levels-1);
-        }
-        else
-        {
-            if (RUN_COMMAND_ON_FIND_FLAG_FILE & lFlags)
-            {
-                if (*pszMatchFileName)
-                {
-                    if (0 == strcmp (file.cFileName, pszMatchFileName))
-                    {
-                        pCommandCallbackFunction (szFindPath, pCustomData);
-                    }
-                }
-                else
-                {
-                    pCommandCallbackFunction (szFindPath, pCustomData);
-                }
-            }
-        }
+void LogError (const char *pszErrorText)
+{
+    printf ("%s\n", pszErrorText);
+
+    if (g_fpLog)
+    {
+        fprintf (g_fpLog, "%s\n", pszErrorText);
+        FlushLogs();
+    }
+}
 
-    } while (FindNextFile (hSearch, &file) );
+int  ListInstalledSoftware (const char *pszInstallRegDir, TYPE_LIST_FILTER *pFilter)
+{
+    int ret = 0;
 
-Done:
+    if (OUTPUT_FORMAT_JSON == pFilter->Format)
+        printf ("[");
+    else if (OUTPUT_FORMAT_CSV == pFilter->Format)
+        printf ("name,version,vendor,description\n");
+    else
+        printf ("\n--- Installed Software ---\n");
 
-    if (hSearch)
+    /* Software installed by a version without inventory index gets an index on first use */
+    if (ReadInventoryIndex (pszInstallRegDir, pFilter))
     {
-        CloseHandle (hSearch);
-        hSearch = NULL;
+        if (UpdateInventoryIndex (pszInstallRegDir) || ReadInventoryIndex (pszInstallRegDir, pFilter))
+            RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_FILE, pszInstallRegDir, g_InstallIniName, PrintSoftwareInfoFromFile, pFilter, 2);
     }
 
+    if (OUTPUT_FORMAT_JSON == pFilter->Format)
+        printf ("%s]\n", pFilter->Count ? "\n" : "");
+    else if (OUTPUT_FORMAT_TEXT == pFilter->Format)
+        printf ("--- Installed Software ---\n\n");
+
     return ret;
 }
 
-#endif
-
-int CopyInstallDirectory (const char *pszBaseDir, const char *pszDirectory, const char *pszTargetDir, const char *pszTargetSubDir, int levels)
+int VerifySoftware (const char *pszInstallLogDir, const char *pszName, TYPE_VERIFY_INFO *pVerifyInfo)
 {
-    int ret = 0;
-    char szSourcePath[1024]  = {0};
-    char szTargetPath[1024]  = {0};
-
-    if (IsNullStr (pszBaseDir))
-        goto Done;
+    int  ret = 0;
+    struct stat Stat = {0};
+    InstallVerifier Verifier;
 
-    if (IsNullStr (pszDirectory))
-        goto Done;
+    char szInstallIniLog[1024] = {0};
+    char szManifestFile[1024]  = {0};
+    char szJournalFile[1024]   = {0};
 
-    if (IsNullStr (pszTargetDir))
-        goto Done;
+    BuildPath (szInstallIniLog, sizeof (szInstallIniLog), pszInstallLogDir, g_InstallIniName);
+    BuildPath (szManifestFile,  sizeof (szManifestFile),  pszInstallLogDir, g_InstallManifestName);
+    BuildPath (szJournalFile,   sizeof (szJournalFile),   pszInstallLogDir, g_InstallJournalName);
 
-    if (levels <= 0)
+    if (stat (szInstallIniLog, &Stat))
+    {
+        printf ("Cannot find specified software: [%s]\n", pszName);
+        ret = 1;
         goto Done;
+    }
 
-    BuildPath (szSourcePath, sizeof (szSourcePath), pszBaseDir, pszDirectory);
-
-    if (IsNullStr (pszTargetSubDir))
+    if (0 == stat (szJournalFile, &Stat))
     {
-        ret = CopyFilesFromDirectory (szSourcePath, pszTargetDir, levels);
+        printf ("[%s] Installation in progress or interrupted - not verified\n", pszName);
+        ret = 1;
+        goto Done;
     }
-    else
+
+    if (stat (szManifestFile, &Stat))
     {
-        BuildPath (szTargetPath, sizeof (szTargetPath), pszTargetDir, pszTargetSubDir);
-        ret = CopyFilesFromDirectory (szSourcePath, szTargetPath, levels);
+        printf ("[%s] No manifest - install again to verify\n", pszName);
+        ret = 1;
+        goto Done;
     }
 
+    ret = Verifier.Run (pszName, szManifestFile, pVerifyInfo->Threads, pVerifyInfo->bDeep);
+
+    if (ret < 0)
+        goto Done;
+
+    printf ("[%s] Files: %d, missing: %d, modified: %d, extra: %d\n", pszName, Verifier.GetFileCount(), Verifier.GetMissing(), Verifier.GetModified(), Verifier.GetExtra());
+
 Done:
+
+    if (ret)
+        pVerifyInfo->Failed++;
+
     return ret;
 }
 
-void LogError (const char *pszErrorText)
+int VerifySoftwareEntry (const char *pszFindPath, void *pCustomData)
 {
-    printf ("%s\n", pszErrorText);
+    /* Called for each install.ini in the install registry. The directory name is the application name */
+
+    char szInstallLogDir[1024] = {0};
+    char *pDirSep = NULL;
+
+    if (NULL == pCustomData)
+        return 0;
+
+    strdncpy (szInstallLogDir, pszFindPath, sizeof (szInstallLogDir));
+
+    pDirSep = strrchr (szInstallLogDir, g_OsDirSep);
+
+    if (NULL == pDirSep)
+        return 0;
+
+    *pDirSep = '\0';
+
+    pDirSep = strrchr (szInstallLogDir, g_OsDirSep);
+
+    return VerifySoftware (szInstallLogDir, pDirSep ? pDirSep+1 : szInstallLogDir, (TYPE_VERIFY_INFO *) pCustomData);
 }
 
-int  ListInstalledSoftware (const char *pszInstallRegDir)
+int VerifyInstalledSoftware (const char *pszInstallRegDir, const char *pszName, int Threads, BOOL bDeep)
 {
-    int ret = 0;
+    TYPE_VERIFY_INFO VerifyInfo = {0};
 
-    printf ("\n--- Installed Software ---\n");
+    char szInstallLogDir[1024] = {0};
 
-    RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_FILE, pszInstallRegDir, g_InstallIniName, PrintSoftwareInfo, NULL, 2);
+    VerifyInfo.Threads = Threads;
+    VerifyInfo.bDeep   = bDeep;
 
-    printf ("--- Installed Software ---\n\n");
+    printf ("\n--- Verify Installed Software ---\n");
 
-Done:
-    return ret;
+    if (IsNullStr (pszName))
+    {
+        RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_FILE, pszInstallRegDir, g_InstallIniName, VerifySoftwareEntry, &VerifyInfo, 2);
+    }
+    else
+    {
+        BuildPath (szInstallLogDir, sizeof (szInstallLogDir), pszInstallRegDir, pszName);
+        VerifySoftware (szInstallLogDir, pszName, &VerifyInfo);
+    }
+
+    printf ("--- Verify Installed Software ---\n\n");
+
+    return VerifyInfo.Failed ? 1 : 0;
 }
 
 int GetParam (const char *pParam, const char *pName, char *retpConfig, int MaxParamSize)
@@ -1145,59 +1986,259 @@ int help(const char *pszProgramName)
     printf ("Options\n");
     printf ("-------\n");
     printf ("-name=<application name>  Name of application for remove or status\n");
-    printf ("-data=<data dir>          Explicit data directory override\n");
+    printf ("-data=<data dir>          Explicit data directory override. Further -data= install to additional partitions\n");
     printf ("-bin=<binary dir>         Explicit binary directory override\n");
+    printf ("-hardlink                 Partitions: Hard link data files to the first data directory instead of copying\n");
+    printf ("-eventlog                 Write a JSON lines event per file to install.jsonl in addition to install.log\n");
     printf ("-wait=<seconds>           Wait number of seconds before stopping the program (to show output)\n");
+    printf ("-threads=<n>              Number of parallel copy threads (default: number of CPUs, max %d. 1 = copy sequentially)\n", DEFAULT_COPY_THREADS);
+    printf ("-tar=<file>|-             Install from a tar archive or from stdin without extracting it first\n");
+    printf ("-dry-run[=text|json]      Print the install plan and check the disk space without installing\n");
+    printf ("-dir=<package dir>        Install the package in this directory instead of the directory of the binary\n");
+    printf ("-pkg=<dir>|<archive>      Install multiple packages in one run (can be specified multiple times)\n");
+    printf ("-parallel=<n>             Number of packages installed at the same time (default: %d)\n", DEFAULT_BATCH_PARALLEL);
+    printf ("-deep                     Verify: Hash all files, not only files with a changed time stamp\n");
+    printf ("-vendor=<vendor>          List: Only software of the vendor\n");
+    printf ("-minversion=<version>     List: Only software with this or a higher version\n");
+    printf ("-maxversion=<version>     List: Only software with this or a lower version\n");
+    printf ("-format=text|json|csv     List: Output format (json and csv only print the list)\n");
 
     printf ("\nCommands\n");
     printf ("--------\n");
-    printf ("-list                     List Installed software\n");
-    printf ("-remove                   Remove/uninstall application\n");
+    printf ("-list                     List Installed software (-name= filters by application name)\n");
+    printf ("-remove                   Remove/uninstall application and directories emptied by the remove\n");
+    printf ("-verify[=<name>]          Verify installed files of all or the specified application (%d threads by default)\n", DEFAULT_VERIFY_THREADS);
 
     return 0;
 }
 
 
-int UninstallFiles (const char *pszFilePath)
+int GetThreadCount()
 {
-    int  ret = 0;
+    /* Explicit -threads= or number of CPUs limited to the default maximum */
+
+    int Threads = g_CopyThreads;
+
+    if (0 == Threads)
+    {
+        Threads = (int) std::thread::hardware_concurrency();
+
+        if (Threads > DEFAULT_COPY_THREADS)
+            Threads = DEFAULT_COPY_THREADS;
+    }
+
+    if (Threads < 1)
+        Threads = 1;
+
+    return Threads;
+}
+
+int UninstallFiles (const char *pszFilePath, const char *pszManifestFile, const char *pszProgramDir, const char *pszDataDir)
+{
+    int ret = 0;
+    Uninstaller Uninstall;
+
+    ret = Uninstall.Run (pszFilePath, pszManifestFile, pszProgramDir, pszDataDir, GetThreadCount());
+
+    /* Without a file log there is nothing to remove. The registration is still removed */
+    if (ret < 0)
+        return 0;
+
+    printf ("Files removed: %d, not found: %d, directories removed: %d, errors: %d\n",
+            Uninstall.GetRemovedFiles(), Uninstall.GetMissingFiles(), Uninstall.GetRemovedDirectories(), Uninstall.GetErrors());
+
+    return ret ? 1 : 0;
+}
+
+int JournalObsoleteFiles (InstallManifest *pOldManifest, CopyScheduler *pScheduler, InstallJournal *pJournal)
+{
+    /* Files of the previous version, which are not part of the new package, are removed on commit */
+
+    int i = 0;
+    const MANIFEST_ENTRY *pEntry = NULL;
+
+    for (i=0; i<pOldManifest->GetCount(); i++)
+    {
+        pEntry = pOldManifest->GetEntry (i);
+
+        if (MANIFEST_TYPE_FILE != pEntry->Type)
+            continue;
+
+        if (pScheduler->FindTarget (pEntry->pszPath) >= 0)
+            continue;
+
+        pJournal->AddEntry (JOURNAL_REMOVE_FILE, pEntry->pszPath);
+        g_RemovedFiles++;
+
+        if (g_fpLog)
+            fprintf (g_fpLog, "Removed: %s\n", pEntry->pszPath);
+    }
+
+    return 0;
+}
+
+int IsOwnedDirectory (const COPY_DIR *pDir, InstallManifest *pOldManifest)
+{
+    const MANIFEST_ENTRY *pEntry = NULL;
+
+    if (pDir->Created)
+        return 1;
+
+    pEntry = pOldManifest->Find (pDir->pszTarget);
+
+    if (pEntry && (MANIFEST_TYPE_OWNED_DIRECTORY == pEntry->Type))
+        return 1;
+
+    return 0;
+}
+
+int WriteInstallManifest (CopyScheduler *pScheduler, InstallManifest *pOldManifest, const char *pszManifestFile)
+{
+    int i   = 0;
+    int ret = 0;
+    const COPY_DIR *pDir = NULL;
+    const COPY_JOB *pJob = NULL;
+    InstallManifest Manifest;
+
+    /* Directories created by this or a previous install of the application first. A Release_ directory adds the same targets again */
+    for (i=0; i<pScheduler->GetDirectoryCount(); i++)
+    {
+        pDir = pScheduler->GetDirectory (i);
+
+        if (IsOwnedDirectory (pDir, pOldManifest) && (NULL == Manifest.Find (pDir->pszTarget)))
+            Manifest.AddDirectory (pDir->pszTarget, TRUE);
+    }
+
+    for (i=0; i<pScheduler->GetDirectoryCount(); i++)
+    {
+        pDir = pScheduler->GetDirectory (i);
+
+        if (NULL == Manifest.Find (pDir->pszTarget))
+            Manifest.AddDirectory (pDir->pszTarget, FALSE);
+    }
+
+    /* Failed files are not recorded and copied again on the next update */
+    for (i=0; i<pScheduler->GetFileCount(); i++)
+    {
+        pJob = pScheduler->GetJob (i);
+
+        if ((COPY_JOB_COPIED == pJob->Result) || (COPY_JOB_SKIPPED == pJob->Result))
+            Manifest.AddFile (pJob->pszTarget, pJob->Size, pJob->Mtime, pJob->Hash);
+    }
+
+    ret = Manifest.Write (pszManifestFile);
+
+    if (ret)
+    {
+        printf ("Cannot write manifest: [%s]\n", pszManifestFile);
+
+        if (g_fpLog)
+            fprintf (g_fpLog, "Cannot write manifest: [%s]\n", pszManifestFile);
+    }
+
+    return ret;
+}
+
+int ReadDataDirList (const char *pszFileName, char szDataDirs[][1024], int MaxDataDirs)
+{
+    /* Returns the number of further data directories of the installed version. No file means no further data directories */
+
+    int  count = 0;
+    FILE *fp   = NULL;
+    char *p    = NULL;
+
     char szBuffer[1024] = {0};
-    char *p  = NULL;
+
+    fp = fopen (pszFileName, "r");
+
+    if (NULL == fp)
+        return 0;
+
+    while ( (count < MaxDataDirs) && fgets (szBuffer, sizeof (szBuffer), fp) )
+    {
+        p = szBuffer;
+
+        while ((unsigned char) *p >= 32)
+            p++;
+
+        *p = '\0';
+
+        if (*szBuffer)
+            snprintf (szDataDirs[count++], sizeof (szDataDirs[0]), "%s", szBuffer);
+    }
+
+    fclose (fp);
+    fp = NULL;
+
+    return count;
+}
+
+int WriteDataDirList (const char *pszFileName, char szDataDirs[][1024], int DataDirs)
+{
+    int  d  = 0;
+    int  ret = 0;
     FILE *fp = NULL;
 
-    fp = fopen (pszFilePath, "r");
+    fp = fopen (pszFileName, "w");
 
     if (NULL == fp)
     {
-        printf ("Cannot open: [%s]\n", pszFilePath);
-        ret = 1;
-        goto Done;
+        printf ("Cannot write data directory list: [%s]\n", pszFileName);
+        return 1;
     }
 
-    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    for (d=0; d<DataDirs; d++)
+        fprintf (fp, "%s\n", szDataDirs[d]);
+
+    if (ferror (fp))
+        ret = 1;
+
+    if (fclose (fp))
+        ret = 1;
+
+    return ret;
+}
+
+int CheckDataDirList (const char *pszFileName, char szDataDirs[][1024], int *pDataDirs, BOOL bQuiet)
+{
+    /* Data directories of the installed version are kept on update. Without further -data= the recorded directories are used.
+       A recorded directory missing in the specified list would remove its files, so the update is refused */
+
+    int  d = 0;
+    int  i = 0;
+    int  ret = 0;
+    int  Recorded = 0;
+
+    char szRecorded[MAX_DATA_DIRS][1024] = {0};
+
+    if (0 == *pDataDirs)
     {
-        p=szBuffer;
+        *pDataDirs = ReadDataDirList (pszFileName, szDataDirs, MAX_DATA_DIRS);
 
-        while (*p)
+        if (FALSE == bQuiet)
         {
-            if (*p < 32)
-            {
-                *p = '\0';
-                break;
-            }
-            p++;
+            for (d=0; d<*pDataDirs; d++)
+                printf ("Data Dir  : [%s] (installed)\n", szDataDirs[d]);
         }
 
-        delete_file (szBuffer);
-
-    } /* while */
+        return 0;
+    }
 
-Done:
+    Recorded = ReadDataDirList (pszFileName, szRecorded, MAX_DATA_DIRS);
 
-    if (fp)
+    for (d=0; d<Recorded; d++)
     {
-        fclose (fp);
-        fp = NULL;
+        for (i=0; i<*pDataDirs; i++)
+        {
+            if (0 == strcmp (szRecorded[d], szDataDirs[i]))
+                break;
+        }
+
+        if (i >= *pDataDirs)
+        {
+            printf ("Data directory of the installed version not specified: [%s]\n", szRecorded[d]);
+            ret = 1;
+        }
     }
 
     return ret;
@@ -1221,11 +2262,27 @@ int main (int argc, const char *argv[])
     char szInstallIniFile[1024]    = {0};
     char szInstallIniLog[1024]     = {0};
     char szLogFileName[1024]       = {0};
+    char szEventLogFileName[1024]  = {0};
+    char szStatsFileName[1024]     = {0};
     char szLogInstalledFiles[1024] = {0};
+    char szManifestFile[1024]      = {0};
+    char szDataDirsFile[1024]      = {0};
+    char szJournalFile[1024]       = {0};
+    char szStageFile[1024]         = {0};
     char szDominoVersion[80]       = {0};
     char szDominoBuild[80]         = {0};
     char szName[80]                = {0};
     char szDelay[40]               = {0};
+    char szThreads[40]             = {0};
+    char szVendor[80]              = {0};
+    char szMinVersion[40]          = {0};
+    char szMaxVersion[40]          = {0};
+    char szFormat[40]              = {0};
+    char szTarFile[1024]           = {0};
+    char szPackage[1024]           = {0};
+    char szDataParam[1024]         = {0};
+    char szFanOutDataDir[MAX_DATA_DIRS][1024] = {0};
+    char szParallel[40]            = {0};
     char szSignInfoBuffer[1024]    = {0};
     char szFileToCheck[1024]       = {0};
     char szCheckSignatureDir[1024] = {0};
@@ -1233,6 +2290,17 @@ int main (int argc, const char *argv[])
     TYPE_SOFTWARE_INFO NewSoft       = {0};
     TYPE_SOFTWARE_INFO InstalledSoft = {0};
     TYPE_VERSION_CHECK VersionCheck  = {0};
+    TYPE_LIST_FILTER   ListFilter    = {0};
+
+    CopyScheduler   Scheduler;
+    InstallManifest OldManifest;
+    InstallJournal  Journal;
+    TarInstaller    TarInstall;
+    InstallPlan     Plan;
+    BatchInstaller  Batch;
+    InstallStats    Stats;
+    InstallManifest *pOldManifest = NULL;
+    struct stat Stat = {0};
 
     char *p            = NULL;
     char *pDirSep      = NULL;
@@ -1242,9 +2310,23 @@ int main (int argc, const char *argv[])
 
     int CmdListSoftware   = 0;
     int CmdRemoveSoftware = 0;
+    int CmdVerifySoftware = 0;
+    BOOL bDeepVerify      = FALSE;
+    BOOL bDryRun          = FALSE;
+    BOOL bQuiet           = FALSE;
+    int  DryRunFormat     = OUTPUT_FORMAT_TEXT;
+    int  Parallel         = DEFAULT_BATCH_PARALLEL;
+    int  DataDirParams    = 0;
+    int  FanOutDataDirs   = 0;
+    int  d                = 0;
+    BOOL bHardLinks       = FALSE;
+    BOOL bEventLog        = FALSE;
+    int  FileLogError     = 0;
 
     long lBuild = 0;
     int  Hotfix = 0;
+    int  ArchiveError = 0;
+    int  CopyError    = 0;
 
     strdncpy (szInstallDir, argv[0], sizeof (szInstallDir));
 
@@ -1263,7 +2345,11 @@ int main (int argc, const char *argv[])
     else
     {
         *szInstallDir = '\0';
+#ifdef UNIX
+        ret = (NULL != getcwd (szInstallDir, sizeof(szInstallDir)-1));
+#else
         ret = GetCurrentDirectory (sizeof(szInstallDir)-1, szInstallDir);
+#endif
         if (0 == ret)
         {
             LogError ("Cannot get current directory");
@@ -1279,42 +2365,157 @@ int main (int argc, const char *argv[])
     if (pValue)
         strdncpy (szDataDir, pValue, sizeof (szDataDir));
 
-    pValue = getenv (ENV_DOMINO_INI);
-    if (pValue)
-        strdncpy (szNotesIni, pValue, sizeof (szNotesIni));
+    pValue = getenv (ENV_DOMINO_INI);
+    if (pValue)
+        strdncpy (szNotesIni, pValue, sizeof (szNotesIni));
+
+    pValue = getenv (ENV_DOMINO_VERSION);
+    if (pValue)
+        strdncpy (szDominoVersion, pValue, sizeof (szDominoVersion));
+
+    pValue = getenv (ENV_DOMINO_BUILD);
+    if (pValue)
+        strdncpy (szDominoBuild, pValue, sizeof (szDominoBuild));
+
+    pValue = getenv (ENV_DOMINO_SERVICE);
+    if (pValue)
+        strdncpy (szDominoService, pValue, sizeof (szDominoService));
+
+    for (i=1; i<argc; i++)
+    {
+        pParam = argv[i];
+
+        if ('-' == *pParam)
+        {
+            if (GetParam (pParam, "-bin=", szProgramDir, sizeof (szProgramDir)))
+                continue;
+
+            /* The first data directory is the primary data directory. Files are fanned out from there to further data directories */
+            if (GetParam (pParam, "-data=", szDataParam, sizeof (szDataParam)))
+            {
+                if (0 == DataDirParams)
+                {
+                    strdncpy (szDataDir, szDataParam, sizeof (szDataDir));
+                }
+                else if (FanOutDataDirs < MAX_DATA_DIRS)
+                {
+                    strdncpy (szFanOutDataDir[FanOutDataDirs], szDataParam, sizeof (szFanOutDataDir[FanOutDataDirs]));
+                    FanOutDataDirs++;
+                }
+                else
+                {
+                    printf ("Too many data directories, maximum is %d\n", MAX_DATA_DIRS+1);
+                    goto Syntax;
+                }
+
+                DataDirParams++;
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-hardlink"))
+            {
+                bHardLinks = TRUE;
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-eventlog"))
+            {
+                bEventLog = TRUE;
+                continue;
+            }
+
+            if (GetParam (pParam, "-name=", szName, sizeof (szName)))
+                continue;
+
+            if (GetParam (pParam, "-wait=", szDelay, sizeof (szDelay)))
+            {
+                wait = atoi (szDelay);
+                if (wait > 60)
+                    wait = 60;
+                continue;
+            }
+
+            if (GetParam (pParam, "-threads=", szThreads, sizeof (szThreads)))
+            {
+                g_CopyThreads = atoi (szThreads);
+
+                if (g_CopyThreads < 0)
+                    g_CopyThreads = 0;
+
+                if (g_CopyThreads > MAX_COPY_THREADS)
+                    g_CopyThreads = MAX_COPY_THREADS;
+                continue;
+            }
+
+            if (GetParam (pParam, "-vendor=", szVendor, sizeof (szVendor)))
+                continue;
 
-    pValue = getenv (ENV_DOMINO_VERSION);
-    if (pValue)
-        strdncpy (szDominoVersion, pValue, sizeof (szDominoVersion));
+            if (GetParam (pParam, "-minversion=", szMinVersion, sizeof (szMinVersion)))
+                continue;
 
-    pValue = getenv (ENV_DOMINO_BUILD);
-    if (pValue)
-        strdncpy (szDominoBuild, pValue, sizeof (szDominoBuild));
+            if (GetParam (pParam, "-maxversion=", szMaxVersion, sizeof (szMaxVersion)))
+                continue;
 
-    pValue = getenv (ENV_DOMINO_SERVICE);
-    if (pValue)
-        strdncpy (szDominoService, pValue, sizeof (szDominoService));
+            if (GetParam (pParam, "-format=", szFormat, sizeof (szFormat)))
+            {
+                if (0 == STRICMP (szFormat, "json"))
+                    ListFilter.Format = OUTPUT_FORMAT_JSON;
+                else if (0 == STRICMP (szFormat, "csv"))
+                    ListFilter.Format = OUTPUT_FORMAT_CSV;
+                else if (0 == STRICMP (szFormat, "text"))
+                    ListFilter.Format = OUTPUT_FORMAT_TEXT;
+                else
+                {
+                    printf ("Invalid format: [%s]\n", szFormat);
+                    goto Syntax;
+                }
+                continue;
+            }
 
-    for (i=1; i<argc; i++)
-    {
-        pParam = argv[i];
+            if (GetParam (pParam, "-tar=", szTarFile, sizeof (szTarFile)))
+                continue;
 
-        if ('-' == *pParam)
-        {
-            if (GetParam (pParam, "-bin=", szProgramDir, sizeof (szProgramDir)))
+            if (GetParam (pParam, "-dir=", szInstallDir, sizeof (szInstallDir)))
                 continue;
 
-            if (GetParam (pParam, "-data=", szDataDir, sizeof (szDataDir)))
+            if (GetParam (pParam, "-pkg=", szPackage, sizeof (szPackage)))
+            {
+                if (Batch.AddPackage (szPackage))
+                    goto Syntax;
                 continue;
+            }
 
-            if (GetParam (pParam, "-name=", szName, sizeof (szName)))
+            if (GetParam (pParam, "-parallel=", szParallel, sizeof (szParallel)))
+            {
+                Parallel = atoi (szParallel);
+
+                if (Parallel < 1)
+                    Parallel = 1;
+
+                if (Parallel > BATCH_MAX_PACKAGES)
+                    Parallel = BATCH_MAX_PACKAGES;
                 continue;
+            }
 
-            if (GetParam (pParam, "-wait=", szDelay, sizeof (szDelay)))
+            if (GetParam (pParam, "-dry-run=", szFormat, sizeof (szFormat)))
             {
-                wait = atoi (szDelay);
-                if (wait > 60)
-                    wait = 60;
+                bDryRun = TRUE;
+
+                if (0 == STRICMP (szFormat, "json"))
+                    DryRunFormat = OUTPUT_FORMAT_JSON;
+                else if (0 == STRICMP (szFormat, "text"))
+                    DryRunFormat = OUTPUT_FORMAT_TEXT;
+                else
+                {
+                    printf ("Invalid format: [%s]\n", szFormat);
+                    goto Syntax;
+                }
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-dry-run"))
+            {
+                bDryRun = TRUE;
                 continue;
             }
 
@@ -1336,6 +2537,24 @@ int main (int argc, const char *argv[])
                 continue;
             }
 
+            if (GetParam (pParam, "-verify=", szName, sizeof (szName)))
+            {
+                CmdVerifySoftware = 1;
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-verify"))
+            {
+                CmdVerifySoftware = 1;
+                continue;
+            }
+
+            if (0 == strcmp (pParam, "-deep"))
+            {
+                bDeepVerify = TRUE;
+                continue;
+            }
+
             if (0 == strcmp (pParam, "-help") || (0 == strcmp (pParam, "-?")) )
             {
                 help (argv[0]);
@@ -1412,22 +2631,78 @@ int main (int argc, const char *argv[])
         goto Done;
     }
 
+    Stats.Phase ("version");
+
     if (!*szDominoVersion)
         GetDominoVersion (szProgramDir, szDominoVersion, sizeof (szDominoVersion)-1);
 
     lBuild = DominoBuildNumFromVersion (szDominoVersion, &Hotfix);
 
-    printf ("ProgramDir: [%s]\n", szProgramDir);
-    printf ("Data Dir  : [%s]\n", szDataDir);
-    printf ("Version   : [%s]\n", szDominoVersion);
-    printf ("Build     : %ld\n",  lBuild);
-    printf ("Hotfix    : %d\n",   Hotfix);
+    Stats.Phase (NULL);
 
     BuildPath (szInstallRegDir, sizeof (szInstallRegDir), szProgramDir, g_InstallRegDirName);
 
+    ListFilter.pszName       = szName;
+    ListFilter.pszVendor     = szVendor;
+    ListFilter.pszMinVersion = szMinVersion;
+    ListFilter.pszMaxVersion = szMaxVersion;
+
+    /* JSON and CSV output is read by tools and only contains the list */
+    if (CmdListSoftware && (OUTPUT_FORMAT_TEXT != ListFilter.Format))
+    {
+        ListInstalledSoftware (szInstallRegDir, &ListFilter);
+        return 0;
+    }
+
+    /* A JSON plan is read by tools and only contains the plan */
+    bQuiet = bDryRun && (OUTPUT_FORMAT_JSON == DryRunFormat);
+
+    if (FALSE == bQuiet)
+    {
+        printf ("ProgramDir: [%s]\n", szProgramDir);
+        printf ("Data Dir  : [%s]\n", szDataDir);
+
+        for (d=0; d<FanOutDataDirs; d++)
+            printf ("Data Dir  : [%s]\n", szFanOutDataDir[d]);
+
+        printf ("Version   : [%s]\n", szDominoVersion);
+        printf ("Build     : %ld\n",  lBuild);
+        printf ("Hotfix    : %d\n",   Hotfix);
+    }
+
     if (CmdListSoftware)
     {
-        ListInstalledSoftware (szInstallRegDir);
+        ListInstalledSoftware (szInstallRegDir, &ListFilter);
+        goto Done;
+    }
+
+    if (CmdVerifySoftware)
+    {
+        ret = VerifyInstalledSoftware (szInstallRegDir, szName, g_CopyThreads ? g_CopyThreads : DEFAULT_VERIFY_THREADS, bDeepVerify);
+        goto Done;
+    }
+
+    /* Each package is installed by its own process with the version and directories determined once */
+    if (Batch.GetCount())
+    {
+        if (bDryRun || CmdRemoveSoftware)
+        {
+            LogError ("-pkg= can only be used to install");
+            ret = 1;
+            goto Done;
+        }
+
+        for (d=0; d<FanOutDataDirs; d++)
+            Batch.AddDataDirectory (szFanOutDataDir[d]);
+
+        Batch.SetHardLinks (bHardLinks);
+        Batch.SetEventLog  (bEventLog);
+
+        ret = Batch.Run (argv[0], szDominoVersion, szProgramDir, szDataDir, szInstallRegDir, g_CopyThreads, Parallel);
+
+        if (UpdateInventoryIndex (szInstallRegDir))
+            printf ("Cannot update inventory index in [%s]\n", szInstallRegDir);
+
         goto Done;
     }
 
@@ -1459,6 +2734,16 @@ int main (int argc, const char *argv[])
         BuildPath (szInstallLogDir,     sizeof (szInstallLogDir),     szInstallRegDir, pName);
         BuildPath (szLogInstalledFiles, sizeof (szLogInstalledFiles), szInstallLogDir, g_InstallFileLogName);
         BuildPath (szInstallIniLog,     sizeof (szInstallIniLog),     szInstallLogDir, g_InstallIniName);
+        BuildPath (szManifestFile,      sizeof (szManifestFile),      szInstallLogDir, g_InstallManifestName);
+        BuildPath (szJournalFile,       sizeof (szJournalFile),       szInstallLogDir, g_InstallJournalName);
+        BuildPath (szDataDirsFile,      sizeof (szDataDirsFile),      szInstallLogDir, g_InstallDataDirsName);
+
+        if (InstallJournal::Recover (szJournalFile))
+        {
+            LogError ("Cannot recover interrupted installation");
+            ret = 1;
+            goto Done;
+        }
 
         GetSoftwareInfoFromFile (&InstalledSoft, szInstallIniLog);
 
@@ -1471,14 +2756,48 @@ int main (int argc, const char *argv[])
         printf ("Removing %s %s via %s\n", pName, InstalledSoft.szVersion, szLogInstalledFiles);
 
         /* Remove files via file-log and remove ini + file-log -- keep install history */
-        UninstallFiles (szLogInstalledFiles);
+        if (UninstallFiles (szLogInstalledFiles, szManifestFile, szProgramDir, szDataDir))
+        {
+            /* Keep the registration, so that the remove can be repeated */
+            printf ("Not all files could be removed\n");
+            ret = 1;
+            goto Done;
+        }
+
         delete_file (szInstallIniLog);
         delete_file (szLogInstalledFiles);
+        delete_file (szManifestFile);
+        delete_file (szDataDirsFile);
+
+        if (UpdateInventoryIndex (szInstallRegDir))
+            printf ("Cannot update inventory index in [%s]\n", szInstallRegDir);
 
         goto Done;
     }
 
-    GetSoftwareInfoFromFile (&NewSoft, szInstallIniFile);
+    /* install.ini is the first file of an archive and read before any file is installed */
+    if (*szTarFile)
+    {
+        /* The content of a stream is only known while installing it */
+        if (bDryRun)
+        {
+            LogError ("-dry-run is not supported for archives");
+            ret = 1;
+            goto Done;
+        }
+
+        if (TarInstall.Open (szTarFile) || TarInstall.ReadInstallIni())
+        {
+            ret = 1;
+            goto Done;
+        }
+
+        GetSoftwareInfoFromBuffer (&NewSoft, TarInstall.GetInstallIni());
+    }
+    else
+    {
+        GetSoftwareInfoFromFile (&NewSoft, szInstallIniFile);
+    }
 
     if (!(*NewSoft.szName))
     {
@@ -1494,34 +2813,148 @@ int main (int argc, const char *argv[])
 
     BuildPath (szInstallLogDir,     sizeof (szInstallLogDir),     szInstallRegDir, NewSoft.szName);
     BuildPath (szLogFileName,       sizeof (szLogFileName),       szInstallLogDir, g_InstallLogName);
+    BuildPath (szEventLogFileName,  sizeof (szEventLogFileName),  szInstallLogDir, g_InstallEventLogName);
+    BuildPath (szStatsFileName,     sizeof (szStatsFileName),     szInstallLogDir, g_InstallStatsName);
     BuildPath (szLogInstalledFiles, sizeof (szLogInstalledFiles), szInstallLogDir, g_InstallFileLogName);
     BuildPath (szInstallIniLog,     sizeof (szInstallIniLog),     szInstallLogDir, g_InstallIniName);
+    BuildPath (szManifestFile,      sizeof (szManifestFile),      szInstallLogDir, g_InstallManifestName);
+    BuildPath (szDataDirsFile,      sizeof (szDataDirsFile),      szInstallLogDir, g_InstallDataDirsName);
+
+    /* Finish or roll back an interrupted install before checking the installed version */
+    BuildPath (szJournalFile, sizeof (szJournalFile), szInstallLogDir, g_InstallJournalName);
+
+    Stats.Phase ("recover");
+
+    if (bDryRun)
+    {
+        /* A dry run does not change anything. The plan is based on the current state */
+        if (InstallJournal::Exists (szJournalFile) && (FALSE == bQuiet))
+            printf ("Interrupted installation found. It is completed or rolled back by the next install\n");
+    }
+    else if (InstallJournal::Recover (szJournalFile))
+    {
+        LogError ("Cannot recover interrupted installation");
+        ret = 1;
+        goto Done;
+    }
 
-    GetSoftwareInfoFromFile (&InstalledSoft, szInstallIniLog);
+    Stats.Phase ("collect");
+
+    /* A JSON plan of a new install must not contain the message for the missing install.ini */
+    if ((FALSE == bQuiet) || (0 == stat (szInstallIniLog, &Stat)))
+        GetSoftwareInfoFromFile (&InstalledSoft, szInstallIniLog);
 
     if (0 == strcmp (InstalledSoft.szVersion, NewSoft.szVersion))
     {
+        if (bQuiet)
+        {
+            Plan.Print (DryRunFormat);
+            return 0;
+        }
+
         printf ("[%s] latest version %s already installed.\n", InstalledSoft.szName, InstalledSoft.szVersion);
         goto Done;
     }
 
     if (*InstalledSoft.szVersion)
     {
-        printf ("[%s] Updating %s -> %s\n", InstalledSoft.szName, InstalledSoft.szVersion, NewSoft.szVersion);
+        if (FALSE == bQuiet)
+            printf ("[%s] Updating %s -> %s\n", InstalledSoft.szName, InstalledSoft.szVersion, NewSoft.szVersion);
 
-        printf ("Removing [%s] via [%s]\n", NewSoft.szName, szLogInstalledFiles);
-        UninstallFiles (szLogInstalledFiles);
-        delete_file (szLogInstalledFiles);
+        /* With a manifest only changed files are copied. Files of the previous version not in the new package are removed on commit */
+        if (0 == OldManifest.Read (szManifestFile))
+        {
+            if (FALSE == bQuiet)
+                printf ("Incremental update via [%s]\n", szManifestFile);
+
+            Scheduler.SetManifest (&OldManifest);
+            pOldManifest = &OldManifest;
+        }
+        else
+        {
+            if (FALSE == bQuiet)
+                printf ("Replacing [%s] via [%s]\n", NewSoft.szName, szLogInstalledFiles);
+
+            OldManifest.ReadFileList (szLogInstalledFiles);
+        }
     }
-    else
+    else if (FALSE == bQuiet)
     {
         printf ("[%s] Installing %s\n", NewSoft.szName, NewSoft.szVersion);
     }
 
+    if (CheckDataDirList (szDataDirsFile, szFanOutDataDir, &FanOutDataDirs, bQuiet))
+    {
+        LogError ("Specify all data directories of the installed version or remove it first");
+        ret = 1;
+        goto Done;
+    }
+
+    /* Plan: Collect the package including the matching Release_ directory. Nothing is written before the plan is checked */
+    if (0 == *szTarFile)
+    {
+        CopyInstallDirectory (szInstallDir, "domino-bin", szProgramDir, "", 10, &Scheduler);
+        CopyInstallDirectory (szInstallDir, "domino-data", szDataDir, "", 10, &Scheduler);
+
+        VersionCheck.lDominoBuild = lBuild;
+        VersionCheck.lBuildBestMatch = 0;
+        *VersionCheck.szBestMatchVersionPath = '\0';
+
+        RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_DIRECTORY, szInstallDir, "", CheckInstallVersion, &VersionCheck, 1);
+
+        /* Check for special version directory to install with format example: Release_12.0.2 */
+        if (VersionCheck.lBuildBestMatch)
+        {
+            strdncpy (szInstallVersionDir, VersionCheck.szBestMatchVersionPath, sizeof (szInstallVersionDir));
+
+            if (FALSE == bQuiet)
+                printf ("InstallDirVersion=%s\n", szInstallVersionDir);
+
+            CopyInstallDirectory (szInstallVersionDir, "domino-bin", szProgramDir, "", 10, &Scheduler);
+            CopyInstallDirectory (szInstallVersionDir, "domino-data", szDataDir, "", 10, &Scheduler);
+        }
+
+        /* domino-bin is shared. domino-data is copied to each data directory */
+        for (d=0; d<FanOutDataDirs; d++)
+        {
+            if (Scheduler.AddFanOut (szDataDir, szFanOutDataDir[d]))
+            {
+                LogError ("Cannot add data directory");
+                ret = 1;
+                goto Done;
+            }
+        }
+
+        if (Plan.Build (&Scheduler, pOldManifest, &OldManifest))
+        {
+            LogError ("Cannot build install plan");
+            ret = 1;
+            goto Done;
+        }
+
+        if (bDryRun)
+        {
+            Plan.Print (DryRunFormat);
+
+            if (bQuiet)
+                return 0;
+
+            ret = Plan.CheckDiskSpace();
+            goto Done;
+        }
+
+        if (Plan.CheckDiskSpace())
+        {
+            LogError ("Installation stopped before copying any file");
+            ret = 1;
+            goto Done;
+        }
+    }
+
     create_directory (szInstallRegDir);
     create_directory (szInstallLogDir);
 
-    g_fpLog = fopen (szLogFileName, "w");
+    g_fpLog = OpenLogFile (szLogFileName, g_szLogBuffer);
 
     if (NULL == g_fpLog)
     {
@@ -1529,9 +2962,10 @@ int main (int argc, const char *argv[])
         goto Done;
     }
 
-    setbuf (g_fpLog, NULL);
+    /* Metadata is staged and committed together with the installed files */
+    GetStagePath (szStageFile, sizeof (szStageFile), szLogInstalledFiles);
 
-    g_fpFileInstallLog = fopen (szLogInstalledFiles, "w");
+    g_fpFileInstallLog = OpenLogFile (szStageFile, g_szFileLogBuffer);
 
     if (NULL == g_fpFileInstallLog)
     {
@@ -1539,7 +2973,16 @@ int main (int argc, const char *argv[])
         goto Done;
     }
 
-    setbuf (g_fpFileInstallLog, NULL);
+    if (bEventLog)
+    {
+        g_fpEventLog = OpenLogFile (szEventLogFileName, g_szEventLogBuffer);
+
+        if (NULL == g_fpEventLog)
+        {
+            LogError ("Cannot open event log file");
+            goto Done;
+        }
+    }
 
     printf ("Install log file: [%s]\n", szLogInstalledFiles);
 
@@ -1555,33 +2998,196 @@ int main (int argc, const char *argv[])
     fprintf (g_fpLog, "-- Parameters --\n");
     fprintf (g_fpLog, "ProgamDir=%s\n",  szProgramDir);
     fprintf (g_fpLog, "DataDir=%s\n",    szDataDir);
+
+    for (d=0; d<FanOutDataDirs; d++)
+        fprintf (g_fpLog, "DataDir=%s\n", szFanOutDataDir[d]);
+
     fprintf (g_fpLog, "NotesIni=%s\n",   szNotesIni);
     fprintf (g_fpLog, "InstallDir=%s\n", szInstallDir);
 
-    CopyInstallDirectory (szInstallDir, "domino-bin", szProgramDir, "", 10);
-    CopyInstallDirectory (szInstallDir, "domino-data", szDataDir, "", 10);
+    g_CopyThreads = GetThreadCount();
 
-    VersionCheck.lDominoBuild = lBuild;
-    VersionCheck.lBuildBestMatch = 0;
-    *VersionCheck.szBestMatchVersionPath = '\0';
+    fprintf (g_fpLog, "CopyThreads=%d\n", g_CopyThreads);
 
-    RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_DIRECTORY, szInstallDir, "", CheckInstallVersion, &VersionCheck, 1);
+    Stats.Phase ("copy");
+    LogPhase ("copy");
 
-    /* Check for special version directory to install with format example: Release_12.0.2 */
-    if (VersionCheck.lBuildBestMatch)
+    if (*szTarFile)
     {
-        strdncpy (szInstallVersionDir, VersionCheck.szBestMatchVersionPath, sizeof (szInstallVersionDir));
-        printf ("InstallDirVersion=%s\n", szInstallVersionDir);
+        if (Journal.Begin (szJournalFile))
+        {
+            LogError ("Cannot create install journal");
+            goto Done;
+        }
+
+        printf ("Installing from archive [%s]\n", szTarFile);
+        fprintf (g_fpLog, "Archive=%s\n", szTarFile);
+
+        ArchiveError = TarInstall.Run (lBuild, szProgramDir, szDataDir, &Scheduler, &Journal, pOldManifest);
+
+        /* Further data directories are copied from the files written to the primary data directory */
+        if ((0 == ArchiveError) && FanOutDataDirs)
+        {
+            i = Scheduler.GetFileCount();
+
+            for (d=0; d<FanOutDataDirs; d++)
+                ArchiveError |= Scheduler.AddFanOut (szDataDir, szFanOutDataDir[d]);
+
+            for (; i<Scheduler.GetFileCount(); i++)
+                Journal.AddTarget (Scheduler.GetJob (i)->pszTarget);
+
+            Scheduler.SetHardLinks (bHardLinks);
+            Scheduler.SetJournal (&Journal);
+
+            if (Scheduler.Run (g_CopyThreads))
+            {
+                LogError ("Cannot copy files to further data directories");
+                CopyError = 1;
+            }
+        }
+
+        goto Copied;
+    }
+
+    if (*szInstallVersionDir)
         fprintf (g_fpLog, "InstallDirVersion=%s\n", szInstallVersionDir);
 
-        CopyInstallDirectory (szInstallVersionDir, "domino-bin", szProgramDir, "", 10);
-        CopyInstallDirectory (szInstallVersionDir, "domino-data", szDataDir, "", 10);
+    fprintf (g_fpLog, "PlanCopyFiles=%d\n", Plan.GetCount (PLAN_COPY_FILE));
+    fprintf (g_fpLog, "PlanCopyBytes=%lld\n", Plan.GetCopyBytes());
+
+    if (Journal.Begin (szJournalFile))
+    {
+        LogError ("Cannot create install journal");
+        goto Done;
+    }
+
+    for (i=0; i<Scheduler.GetFileCount(); i++)
+        Journal.AddTarget (Scheduler.GetJob (i)->pszTarget);
+
+    Scheduler.SetJournal (&Journal);
+    Scheduler.SetHardLinks (bHardLinks);
+
+    printf ("Copying %d files with %d threads\n", Scheduler.GetFileCount(), g_CopyThreads);
+
+    if (Scheduler.Run (g_CopyThreads))
+    {
+        LogError ("Cannot copy files");
+        CopyError = 1;
+    }
+
+Copied:
+
+    /* A job not copied or skipped was not installed, even if no copy error was counted for it */
+    i = Scheduler.GetUnfinishedCount();
+
+    if (i)
+    {
+        fprintf (g_fpLog, "UnfinishedFiles=%d\n", i);
+        printf ("Files not installed: %d\n", i);
+        CopyError = 1;
+    }
+
+    Stats.Phase ("register");
+    Stats.AddJobs (&Scheduler, *szTarFile ? NULL : szInstallDir);
+
+    LogPhase ("commit");
+
+    /* Buffered file log lines are only written on close */
+    if (fclose (g_fpFileInstallLog))
+    {
+        LogError ("Cannot write file log");
+        FileLogError = 1;
+    }
+
+    g_fpFileInstallLog = NULL;
+
+    if ((0 == g_CopyErrors) && (0 == CopyError) && (0 == ArchiveError) && (0 == FileLogError))
+    {
+        JournalObsoleteFiles (&OldManifest, &Scheduler, &Journal);
+
+        Journal.AddTarget (szLogInstalledFiles);
+        Journal.AddTarget (szManifestFile);
+        Journal.AddTarget (szInstallIniLog);
+
+        if (FanOutDataDirs)
+            Journal.AddTarget (szDataDirsFile);
+
+        if (Journal.Sync())
+        {
+            LogError ("Cannot write install journal");
+            ret = 1;
+        }
+        else
+        {
+            GetStagePath (szStageFile, sizeof (szStageFile), szManifestFile);
+            ret = WriteInstallManifest (&Scheduler, &OldManifest, szStageFile);
+
+            GetStagePath (szStageFile, sizeof (szStageFile), szInstallIniLog);
+
+            if (*szTarFile)
+                ret |= TarInstall.WriteInstallIni (szStageFile);
+            else
+                ret |= copy_file (szInstallIniFile, szStageFile, TRUE);
+
+            if (FanOutDataDirs)
+            {
+                GetStagePath (szStageFile, sizeof (szStageFile), szDataDirsFile);
+                ret |= WriteDataDirList (szStageFile, szFanOutDataDir, FanOutDataDirs);
+            }
+        }
+    }
+
+    Stats.Phase ("commit");
+
+    if (g_CopyErrors || CopyError || ArchiveError || FileLogError || ret || Journal.Commit())
+    {
+        printf ("\nInstallation failed - rolling back\n\n");
+        Stats.Phase ("rollback");
+        LogPhase ("rollback");
+
+        Journal.Rollback();
+
+        Stats.Phase (NULL);
+        Stats.Write (g_fpLog);
+        Stats.WriteJson (szStatsFileName, NewSoft.szName, NewSoft.szVersion, "rolled back", g_CopyThreads);
+
+        fprintf (g_fpLog, "Installation failed - rolled back\n");
+
+        GetStagePath (szStageFile, sizeof (szStageFile), szLogInstalledFiles);
+        remove (szStageFile);
+
+        ret = 1;
+        goto Done;
     }
 
-    fprintf (g_fpLog, "FilesCopied=%ld\n",   g_CopiedFiles);
-    fprintf (g_fpLog, "FileCopyErrors=%ld\n",g_CopyErrors);
+    /* Backups of replaced files and files of the previous version are deleted */
+    Stats.Phase ("remove-old");
+
+    Journal.Finish();
+    Scheduler.SetDirectoryAttributes();
+    TarInstall.SetDirectoryAttributes();
+
+    Stats.Phase ("index");
+
+    if (UpdateInventoryIndex (szInstallRegDir))
+        printf ("Cannot update inventory index in [%s]\n", szInstallRegDir);
+
+    Stats.Phase (NULL);
+
+    fprintf (g_fpLog, "FilesCopied=%d\n",   g_CopiedFiles);
+    fprintf (g_fpLog, "FilesUnchanged=%d\n", g_SkippedFiles);
+    fprintf (g_fpLog, "FilesRemoved=%d\n",  g_RemovedFiles);
+    fprintf (g_fpLog, "FileCopyErrors=%d\n",g_CopyErrors);
+
+    printf ("Files copied: %d, unchanged: %d, removed: %d, errors: %d\n", g_CopiedFiles, g_SkippedFiles, g_RemovedFiles, g_CopyErrors);
+    Stats.Print();
 
-    copy_file (szInstallIniFile, szInstallIniLog, TRUE);
+    Stats.Write (g_fpLog);
+
+    if (Stats.WriteJson (szStatsFileName, NewSoft.szName, NewSoft.szVersion, "completed", g_CopyThreads))
+        printf ("Cannot write statistics file [%s]\n", szStatsFileName);
+
+    LogPhase ("completed");
 
     printf ("\nInstallation completed\n\n");
 
@@ -1599,10 +3205,20 @@ Done:
         g_fpFileInstallLog = NULL;
     }
 
+    if (g_fpEventLog)
+    {
+        fclose (g_fpEventLog);
+        g_fpEventLog = NULL;
+    }
+
     if (wait)
     {
-        printf ("\nWaiting %ld seconds before termination\n\n", wait);
+        printf ("\nWaiting %d seconds before termination\n\n", wait);
+#ifdef UNIX
+        sleep (wait);
+#else
         Sleep (wait * 1000);
+#endif
     }
 
     printf ("Done\n");
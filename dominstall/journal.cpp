@@ -0,0 +1,468 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef UNIX
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <io.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "dominoinstall.hpp"
+#include "journal.hpp"
+
+#define STAGE_SUFFIX   ".dominstall-new"
+#define BACKUP_SUFFIX  ".dominstall-old"
+
+
+void GetStagePath (char *retpszPath, size_t BufferSize, const char *pszPath)
+{
+    snprintf (retpszPath, BufferSize-1, "%s%s", pszPath, STAGE_SUFFIX);
+}
+
+void GetBackupPath (char *retpszPath, size_t BufferSize, const char *pszPath)
+{
+    snprintf (retpszPath, BufferSize-1, "%s%s", pszPath, BACKUP_SUFFIX);
+}
+
+static int PathExists (const char *pszPath)
+{
+    struct stat Stat = {0};
+
+#ifdef UNIX
+    return (0 == lstat (pszPath, &Stat));
+#else
+    return (0 == stat (pszPath, &Stat));
+#endif
+}
+
+static int RemoveDirectoryIfEmpty (const char *pszPath)
+{
+#ifdef UNIX
+    return rmdir (pszPath);
+#else
+    return RemoveDirectory (pszPath) ? 0 : 1;
+#endif
+}
+
+static int BackupFile (const char *pszPath, const char *pszBackupPath)
+{
+    /* On UNIX the backup is a hard link. The target path stays valid until the new file is renamed over it */
+
+    struct stat Stat = {0};
+
+    /* A directory is never replaced by a file */
+    if ((0 == stat (pszPath, &Stat)) && (S_IFDIR == (Stat.st_mode & S_IFMT)))
+    {
+        if (g_fpLog)
+            fprintf (g_fpLog, "Target is a directory: %s\n", pszPath);
+
+        return 1;
+    }
+
+#ifdef UNIX
+    remove (pszBackupPath);
+
+    if (0 == link (pszPath, pszBackupPath))
+        return 0;
+
+    /* No previous file anymore, nothing to backup */
+    if (ENOENT == errno)
+        return 0;
+
+    /* File system without hard links */
+    if ((EPERM == errno) || (EOPNOTSUPP == errno) || (EXDEV == errno))
+        return replace_file (pszPath, pszBackupPath);
+
+    return 1;
+#else
+    if (!PathExists (pszPath))
+        return 0;
+
+    return replace_file (pszPath, pszBackupPath);
+#endif
+}
+
+
+InstallJournal::InstallJournal()
+{
+    m_fp       = NULL;
+    m_Done     = 0;
+    m_pEntries = NULL;
+    m_Count    = 0;
+    m_CountMax = 0;
+    m_szJournalFile[0] = '\0';
+}
+
+InstallJournal::~InstallJournal()
+{
+    int i = 0;
+
+    Close (FALSE);
+
+    for (i=0; i<m_Count; i++)
+        free (m_pEntries[i].pszPath);
+
+    if (m_pEntries)
+    {
+        free (m_pEntries);
+        m_pEntries = NULL;
+    }
+}
+
+void InstallJournal::Close (int bDelete)
+{
+    if (m_fp)
+    {
+        fclose (m_fp);
+        m_fp = NULL;
+    }
+
+    if (bDelete && m_szJournalFile[0])
+    {
+        remove (m_szJournalFile);
+        m_szJournalFile[0] = '\0';
+    }
+}
+
+int InstallJournal::Add (char Type, const char *pszPath)
+{
+    JOURNAL_ENTRY *pNew = NULL;
+
+    if (m_Count >= m_CountMax)
+    {
+        pNew = (JOURNAL_ENTRY *) realloc (m_pEntries, (m_CountMax + 1024) * sizeof (JOURNAL_ENTRY));
+
+        if (NULL == pNew)
+            return 1;
+
+        m_pEntries  = pNew;
+        m_CountMax += 1024;
+    }
+
+    m_pEntries[m_Count].pszPath = strdup (pszPath);
+
+    if (NULL == m_pEntries[m_Count].pszPath)
+        return 1;
+
+    m_pEntries[m_Count].Type = Type;
+    m_Count++;
+
+    return 0;
+}
+
+int InstallJournal::Begin (const char *pszJournalFile)
+{
+    strdncpy (m_szJournalFile, pszJournalFile, sizeof (m_szJournalFile));
+
+    m_fp = fopen (m_szJournalFile, "w");
+
+    if (NULL == m_fp)
+    {
+        m_szJournalFile[0] = '\0';
+        return 1;
+    }
+
+    fprintf (m_fp, "%s\n", JOURNAL_BEGIN);
+
+    return Sync();
+}
+
+int InstallJournal::AddEntry (char Type, const char *pszPath)
+{
+    /* Entries are written before the operation. Callers Sync() before the first staged file of a batch is written */
+
+    if (IsNullStr (pszPath))
+        return 0;
+
+    if (Add (Type, pszPath))
+        return 1;
+
+    if (m_fp)
+        fprintf (m_fp, "%c|%s\n", Type, pszPath);
+
+    return 0;
+}
+
+int InstallJournal::AddTarget (const char *pszPath)
+{
+    return AddEntry (PathExists (pszPath) ? JOURNAL_REPLACE_FILE : JOURNAL_NEW_FILE, pszPath);
+}
+
+int InstallJournal::Sync()
+{
+    if (NULL == m_fp)
+        return 1;
+
+    if (fflush (m_fp) || ferror (m_fp))
+        return 1;
+
+#ifdef UNIX
+    if (fsync (fileno (m_fp)))
+        return 1;
+#else
+    if (_commit (_fileno (m_fp)))
+        return 1;
+#endif
+
+    return 0;
+}
+
+int InstallJournal::Commit()
+{
+    /* Rename staged files into place. Any error leaves everything needed for Rollback() */
+
+    int  i   = 0;
+    int  ret = 0;
+    JOURNAL_ENTRY *pEntry = NULL;
+
+    char szStagePath[2048]  = {0};
+    char szBackupPath[2048] = {0};
+
+    if (Sync())
+        return 1;
+
+    for (i=0; i<m_Count; i++)
+    {
+        pEntry = m_pEntries + i;
+
+        GetStagePath  (szStagePath,  sizeof (szStagePath),  pEntry->pszPath);
+        GetBackupPath (szBackupPath, sizeof (szBackupPath), pEntry->pszPath);
+
+        switch (pEntry->Type)
+        {
+            case JOURNAL_NEW_FILE:
+
+                /* Not staged: unchanged or failed file */
+                if (!PathExists (szStagePath))
+                    break;
+
+                ret = replace_file (szStagePath, pEntry->pszPath);
+                break;
+
+            case JOURNAL_REPLACE_FILE:
+
+                if (!PathExists (szStagePath))
+                    break;
+
+                ret = BackupFile (pEntry->pszPath, szBackupPath);
+
+                if (0 == ret)
+                    ret = replace_file (szStagePath, pEntry->pszPath);
+                break;
+
+            case JOURNAL_REMOVE_FILE:
+
+                if (!PathExists (pEntry->pszPath))
+                    break;
+
+                ret = replace_file (pEntry->pszPath, szBackupPath);
+                break;
+
+            default:
+                break;
+        } /* switch */
+
+        if (ret)
+        {
+            if (g_fpLog)
+                fprintf (g_fpLog, "Commit failed: %s\n", pEntry->pszPath);
+
+            return ret;
+        }
+    }
+
+    fprintf (m_fp, "%s\n", JOURNAL_DONE);
+    m_Done = 1;
+
+    return Sync();
+}
+
+int InstallJournal::Finish()
+{
+    /* Transaction is committed: Remove backups of replaced and removed files */
+
+    int  i = 0;
+    JOURNAL_ENTRY *pEntry = NULL;
+
+    char szPath[2048] = {0};
+
+    for (i=0; i<m_Count; i++)
+    {
+        pEntry = m_pEntries + i;
+
+        if ((JOURNAL_REPLACE_FILE == pEntry->Type) || (JOURNAL_REMOVE_FILE == pEntry->Type))
+        {
+            GetBackupPath (szPath, sizeof (szPath), pEntry->pszPath);
+            remove (szPath);
+        }
+
+        if ((JOURNAL_REPLACE_FILE == pEntry->Type) || (JOURNAL_NEW_FILE == pEntry->Type))
+        {
+            GetStagePath (szPath, sizeof (szPath), pEntry->pszPath);
+
+            if (PathExists (szPath))
+                remove (szPath);
+        }
+    }
+
+    Close (TRUE);
+    return 0;
+}
+
+int InstallJournal::Rollback()
+{
+    /* Undo in reverse order: Restore backups, remove staged and committed new files and created directories */
+
+    int  i = 0;
+    int  Errors = 0;
+    JOURNAL_ENTRY *pEntry = NULL;
+
+    char szStagePath[2048]  = {0};
+    char szBackupPath[2048] = {0};
+
+    for (i=m_Count-1; i>=0; i--)
+    {
+        pEntry = m_pEntries + i;
+
+        GetStagePath  (szStagePath,  sizeof (szStagePath),  pEntry->pszPath);
+        GetBackupPath (szBackupPath, sizeof (szBackupPath), pEntry->pszPath);
+
+        switch (pEntry->Type)
+        {
+            case JOURNAL_NEW_FILE:
+
+                if (PathExists (szStagePath))
+                    remove (szStagePath);
+                else if (PathExists (pEntry->pszPath))
+                    remove (pEntry->pszPath);
+                break;
+
+            case JOURNAL_REPLACE_FILE:
+
+                if (PathExists (szBackupPath))
+                {
+                    if (replace_file (szBackupPath, pEntry->pszPath))
+                        Errors++;
+                }
+
+                if (PathExists (szStagePath))
+                    remove (szStagePath);
+                break;
+
+            case JOURNAL_REMOVE_FILE:
+
+                if (PathExists (szBackupPath))
+                {
+                    if (replace_file (szBackupPath, pEntry->pszPath))
+                        Errors++;
+                }
+                break;
+
+            default:
+                break;
+        } /* switch */
+    }
+
+    /* Directories after all files, children were created after their parents */
+    for (i=m_Count-1; i>=0; i--)
+    {
+        if (JOURNAL_NEW_DIRECTORY == m_pEntries[i].Type)
+            RemoveDirectoryIfEmpty (m_pEntries[i].pszPath);
+    }
+
+    /* Keep the journal if a backup could not be restored to retry on the next run */
+    Close (0 == Errors);
+
+    return Errors;
+}
+
+int InstallJournal::Read (const char *pszJournalFile)
+{
+    FILE *fp = NULL;
+    char *p  = NULL;
+
+    char szBuffer[4096] = {0};
+
+    fp = fopen (pszJournalFile, "r");
+
+    if (NULL == fp)
+        return 1;
+
+    strdncpy (m_szJournalFile, pszJournalFile, sizeof (m_szJournalFile));
+
+    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    {
+        p = szBuffer;
+
+        while (*p)
+        {
+            if ((unsigned char) *p < 32)
+            {
+                *p = '\0';
+                break;
+            }
+            p++;
+        }
+
+        if (0 == strcmp (szBuffer, JOURNAL_DONE))
+            m_Done = 1;
+        else if (('|' == szBuffer[1]) && szBuffer[2])
+            Add (szBuffer[0], szBuffer+2);
+    }
+
+    fclose (fp);
+    fp = NULL;
+
+    return 0;
+}
+
+int InstallJournal::Recover (const char *pszJournalFile)
+{
+    /* Returns 0 if there was no journal or it was recovered */
+
+    int ret = 0;
+    InstallJournal Journal;
+
+    if (Journal.Read (pszJournalFile))
+        return 0;
+
+    if (Journal.m_Done)
+    {
+        printf ("Completing interrupted installation via [%s]\n", pszJournalFile);
+        ret = Journal.Finish();
+    }
+    else
+    {
+        printf ("Rolling back interrupted installation via [%s]\n", pszJournalFile);
+        ret = Journal.Rollback();
+    }
+
+    return ret;
+}
+
+int InstallJournal::Exists (const char *pszJournalFile)
+{
+    return PathExists (pszJournalFile);
+}
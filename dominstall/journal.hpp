@@ -0,0 +1,89 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef JOURNAL_HPP
+    #define JOURNAL_HPP
+
+#include "dominoinstall.hpp"
+
+#define JOURNAL_NEW_FILE        'N'   /* File did not exist before */
+#define JOURNAL_REPLACE_FILE    'R'   /* Existing file is replaced */
+#define JOURNAL_REMOVE_FILE     'X'   /* Existing file is removed */
+#define JOURNAL_NEW_DIRECTORY   'M'   /* Directory created by the install */
+
+#define JOURNAL_BEGIN           "BEGIN"
+#define JOURNAL_DONE            "DONE"
+
+typedef struct {
+    char Type;
+    char *pszPath;
+} JOURNAL_ENTRY;
+
+
+/* Transactional install. New files are staged as <file>.dominstall-new next to the target.
+   Commit keeps the previous file as <file>.dominstall-old and renames the staged file into place.
+   All operations are recorded in a journal file before they are made.
+   Without the DONE marker the journal is rolled back, with the marker only backups are removed */
+
+class InstallJournal
+{
+
+public:
+
+    InstallJournal();
+    ~InstallJournal();
+
+    int  Begin     (const char *pszJournalFile);
+    int  AddEntry  (char Type, const char *pszPath);
+    int  AddTarget (const char *pszPath);
+    int  Sync      ();
+    int  Commit    ();
+    int  Finish    ();
+    int  Rollback  ();
+
+    static int Recover (const char *pszJournalFile);
+    static int Exists  (const char *pszJournalFile);
+
+    int  IsActive()
+    {
+        return (NULL != m_fp);
+    }
+
+private:
+
+    int  Read      (const char *pszJournalFile);
+    int  Add       (char Type, const char *pszPath);
+    void Close     (int bDelete);
+
+    FILE *m_fp;
+    int  m_Done;
+
+    JOURNAL_ENTRY *m_pEntries;
+    int  m_Count;
+    int  m_CountMax;
+
+    char m_szJournalFile[1024];
+};
+
+
+void GetStagePath  (char *retpszPath, size_t BufferSize, const char *pszPath);
+void GetBackupPath (char *retpszPath, size_t BufferSize, const char *pszPath);
+
+#endif
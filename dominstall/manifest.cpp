@@ -0,0 +1,547 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef __linux__
+#include <fcntl.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dominoinstall.hpp"
+#include "manifest.hpp"
+
+#define XXH_PRIME64_1  0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2  0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3  0x165667B19E3779F9ULL
+#define XXH_PRIME64_4  0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5  0x27D4EB2F165667C5ULL
+
+typedef unsigned long long XXH_U64;
+
+
+static XXH_U64 XxhRotl (XXH_U64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static XXH_U64 XxhRead64 (const unsigned char *p)
+{
+    /* Little endian independent of the platform. Compilers turn this into a single load */
+    return  (XXH_U64) p[0]        | ((XXH_U64) p[1] << 8)  | ((XXH_U64) p[2] << 16) | ((XXH_U64) p[3] << 24) |
+           ((XXH_U64) p[4] << 32) | ((XXH_U64) p[5] << 40) | ((XXH_U64) p[6] << 48) | ((XXH_U64) p[7] << 56);
+}
+
+static XXH_U64 XxhRead32 (const unsigned char *p)
+{
+    return (XXH_U64) p[0] | ((XXH_U64) p[1] << 8) | ((XXH_U64) p[2] << 16) | ((XXH_U64) p[3] << 24);
+}
+
+static XXH_U64 XxhRound (XXH_U64 Acc, XXH_U64 Input)
+{
+    Acc += Input * XXH_PRIME64_2;
+    Acc  = XxhRotl (Acc, 31);
+    return Acc * XXH_PRIME64_1;
+}
+
+static XXH_U64 XxhMergeRound (XXH_U64 Acc, XXH_U64 Val)
+{
+    Acc ^= XxhRound (0, Val);
+    return Acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+void Xxh64Init (XXH64_STATE *pState)
+{
+    memset (pState, 0, sizeof (XXH64_STATE));
+
+    pState->Acc[0] = XXH_PRIME64_1 + XXH_PRIME64_2;
+    pState->Acc[1] = XXH_PRIME64_2;
+    pState->Acc[2] = 0;
+    pState->Acc[3] = 0 - XXH_PRIME64_1;
+}
+
+static void Xxh64Stripe (XXH64_STATE *pState, const unsigned char *p)
+{
+    pState->Acc[0] = XxhRound (pState->Acc[0], XxhRead64 (p));
+    pState->Acc[1] = XxhRound (pState->Acc[1], XxhRead64 (p+8));
+    pState->Acc[2] = XxhRound (pState->Acc[2], XxhRead64 (p+16));
+    pState->Acc[3] = XxhRound (pState->Acc[3], XxhRead64 (p+24));
+}
+
+void Xxh64Update (XXH64_STATE *pState, const unsigned char *pData, size_t len)
+{
+    const unsigned char *pEnd = pData + len;
+    size_t fill = 0;
+
+    pState->TotalLen += len;
+
+    if (pState->MemSize + len < 32)
+    {
+        memcpy (pState->Mem + pState->MemSize, pData, len);
+        pState->MemSize += (int) len;
+        return;
+    }
+
+    if (pState->MemSize)
+    {
+        fill = 32 - pState->MemSize;
+        memcpy (pState->Mem + pState->MemSize, pData, fill);
+        Xxh64Stripe (pState, pState->Mem);
+        pData += fill;
+        pState->MemSize = 0;
+    }
+
+    while (pData + 32 <= pEnd)
+    {
+        Xxh64Stripe (pState, pData);
+        pData += 32;
+    }
+
+    if (pData < pEnd)
+    {
+        memcpy (pState->Mem, pData, pEnd - pData);
+        pState->MemSize = (int) (pEnd - pData);
+    }
+}
+
+XXH_U64 Xxh64Digest (const XXH64_STATE *pState)
+{
+    XXH_U64 h = 0;
+    const unsigned char *p    = pState->Mem;
+    const unsigned char *pEnd = pState->Mem + pState->MemSize;
+
+    if (pState->TotalLen >= 32)
+    {
+        h = XxhRotl (pState->Acc[0], 1) + XxhRotl (pState->Acc[1], 7) + XxhRotl (pState->Acc[2], 12) + XxhRotl (pState->Acc[3], 18);
+        h = XxhMergeRound (h, pState->Acc[0]);
+        h = XxhMergeRound (h, pState->Acc[1]);
+        h = XxhMergeRound (h, pState->Acc[2]);
+        h = XxhMergeRound (h, pState->Acc[3]);
+    }
+    else
+    {
+        h = XXH_PRIME64_5;
+    }
+
+    h += pState->TotalLen;
+
+    while (p + 8 <= pEnd)
+    {
+        h ^= XxhRound (0, XxhRead64 (p));
+        h  = XxhRotl (h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+
+    if (p + 4 <= pEnd)
+    {
+        h ^= XxhRead32 (p) * XXH_PRIME64_1;
+        h  = XxhRotl (h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+
+    while (p < pEnd)
+    {
+        h ^= (*p) * XXH_PRIME64_5;
+        h  = XxhRotl (h, 11) * XXH_PRIME64_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+unsigned long long HashFile (const char *pszFileName, int Flags, int *retpError)
+{
+    /* XXH64 of the file content. Read in blocks into a stack buffer to be usable from copy threads.
+       With HASH_FILE_NOCACHE the file is dropped from the page cache after reading */
+
+    FILE   *fp  = NULL;
+    size_t len  = 0;
+    int    Error = 0;
+    XXH64_STATE State;
+    unsigned char Buffer[MANIFEST_HASH_BUFFER];
+
+    Xxh64Init (&State);
+
+    fp = fopen (pszFileName, "rb");
+
+    if (NULL == fp)
+    {
+        Error = 1;
+        goto Done;
+    }
+
+    setvbuf (fp, NULL, _IONBF, 0);
+
+#ifdef __linux__
+    posix_fadvise (fileno (fp), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    while ((len = fread (Buffer, 1, sizeof (Buffer), fp)) > 0)
+        Xxh64Update (&State, Buffer, len);
+
+    if (ferror (fp))
+        Error = 1;
+
+#ifdef __linux__
+    if (HASH_FILE_NOCACHE & Flags)
+        posix_fadvise (fileno (fp), 0, 0, POSIX_FADV_DONTNEED);
+#endif
+
+Done:
+
+    if (fp)
+    {
+        fclose (fp);
+        fp = NULL;
+    }
+
+    if (retpError)
+        *retpError = Error;
+
+    return Xxh64Digest (&State);
+}
+
+
+InstallManifest::InstallManifest()
+{
+    m_pEntries  = NULL;
+    m_Count     = 0;
+    m_CountMax  = 0;
+    m_pIndex    = NULL;
+    m_IndexSize = 0;
+}
+
+InstallManifest::~InstallManifest()
+{
+    int i = 0;
+
+    for (i=0; i<m_Count; i++)
+        free (m_pEntries[i].pszPath);
+
+    if (m_pEntries)
+    {
+        free (m_pEntries);
+        m_pEntries = NULL;
+    }
+
+    if (m_pIndex)
+    {
+        free (m_pIndex);
+        m_pIndex = NULL;
+    }
+}
+
+int InstallManifest::AddFile (const char *pszPath, long long Size, long long Mtime, unsigned long long Hash)
+{
+    return Add (MANIFEST_TYPE_FILE, pszPath, Size, Mtime, Hash);
+}
+
+int InstallManifest::AddDirectory (const char *pszPath, int bOwned)
+{
+    return Add (bOwned ? MANIFEST_TYPE_OWNED_DIRECTORY : MANIFEST_TYPE_DIRECTORY, pszPath, 0, 0, 0);
+}
+
+int InstallManifest::Add (int Type, const char *pszPath, long long Size, long long Mtime, unsigned long long Hash)
+{
+    MANIFEST_ENTRY *pNew = NULL;
+
+    if (IsNullStr (pszPath))
+        return 0;
+
+    if (m_Count >= m_CountMax)
+    {
+        pNew = (MANIFEST_ENTRY *) realloc (m_pEntries, (m_CountMax + 1024) * sizeof (MANIFEST_ENTRY));
+
+        if (NULL == pNew)
+            return 1;
+
+        m_pEntries  = pNew;
+        m_CountMax += 1024;
+    }
+
+    m_pEntries[m_Count].pszPath = strdup (pszPath);
+
+    if (NULL == m_pEntries[m_Count].pszPath)
+        return 1;
+
+    m_pEntries[m_Count].Type  = Type;
+    m_pEntries[m_Count].Size  = Size;
+    m_pEntries[m_Count].Mtime = Mtime;
+    m_pEntries[m_Count].Hash  = Hash;
+    m_Count++;
+
+    return IndexEntry (m_Count-1);
+}
+
+int InstallManifest::IndexEntry (int Entry)
+{
+    /* Open addressing hash table with entry numbers. Rebuilt with double size when half full */
+
+    int  i    = 0;
+    int  Size = 0;
+    int  *pNewIndex = NULL;
+    unsigned int pos = 0;
+
+    if (2 * m_Count > m_IndexSize)
+    {
+        Size = m_IndexSize ? m_IndexSize * 2 : 4096;
+
+        pNewIndex = (int *) malloc (Size * sizeof (int));
+
+        if (NULL == pNewIndex)
+            return 1;
+
+        if (m_pIndex)
+            free (m_pIndex);
+
+        m_pIndex    = pNewIndex;
+        m_IndexSize = Size;
+
+        for (pos=0; pos < (unsigned int) Size; pos++)
+            m_pIndex[pos] = -1;
+
+        i = 0;
+    }
+    else
+    {
+        i = Entry;
+    }
+
+    for (; i<=Entry; i++)
+    {
+        pos = HashPath (m_pEntries[i].pszPath) & (m_IndexSize-1);
+
+        while (m_pIndex[pos] >= 0)
+            pos = (pos+1) & (m_IndexSize-1);
+
+        m_pIndex[pos] = i;
+    }
+
+    return 0;
+}
+
+const MANIFEST_ENTRY *InstallManifest::Find (const char *pszPath)
+{
+    unsigned int pos = 0;
+
+    if ((NULL == m_pIndex) || (NULL == pszPath))
+        return NULL;
+
+    pos = HashPath (pszPath) & (m_IndexSize-1);
+
+    while (m_pIndex[pos] >= 0)
+    {
+        if (0 == PATHCMP (m_pEntries[m_pIndex[pos]].pszPath, pszPath))
+            return m_pEntries + m_pIndex[pos];
+
+        pos = (pos+1) & (m_IndexSize-1);
+    }
+
+    return NULL;
+}
+
+int InstallManifest::Read (const char *pszFileName)
+{
+    int  ret = 0;
+    FILE *fp = NULL;
+    char *p  = NULL;
+    char *pPath = NULL;
+    long long Size  = 0;
+    long long Mtime = 0;
+    unsigned long long Hash = 0;
+
+    char szBuffer[4096] = {0};
+
+    fp = fopen (pszFileName, "r");
+
+    if (NULL == fp)
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    {
+        /* Remove control chars end of line */
+        p = szBuffer;
+
+        while (*p)
+        {
+            if ((unsigned char) *p < 32)
+            {
+                *p = '\0';
+                break;
+            }
+            p++;
+        }
+
+        if (0 == strncmp (szBuffer, "D|", 2))
+        {
+            AddDirectory (szBuffer+2, FALSE);
+        }
+        else if (0 == strncmp (szBuffer, "O|", 2))
+        {
+            AddDirectory (szBuffer+2, TRUE);
+        }
+        else if (0 == strncmp (szBuffer, "F|", 2))
+        {
+            /* Path is the last field and may contain the separator */
+            p = szBuffer+2;
+
+            Size = strtoll (p, &p, 10);
+            if ('|' != *p++)
+                continue;
+
+            Mtime = strtoll (p, &p, 10);
+            if ('|' != *p++)
+                continue;
+
+            Hash = strtoull (p, &p, 16);
+            if ('|' != *p++)
+                continue;
+
+            pPath = p;
+
+            AddFile (pPath, Size, Mtime, Hash);
+        }
+
+    } /* while */
+
+Done:
+
+    if (fp)
+    {
+        fclose (fp);
+        fp = NULL;
+    }
+
+    return ret;
+}
+
+int InstallManifest::ReadFileList (const char *pszFileName)
+{
+    /* Plain file log of an install without manifest: Paths only, failed files have an "ERROR:" prefix */
+
+    int  ret = 0;
+    FILE *fp = NULL;
+    char *p  = NULL;
+
+    char szBuffer[4096] = {0};
+
+    fp = fopen (pszFileName, "r");
+
+    if (NULL == fp)
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    while ( fgets (szBuffer, sizeof (szBuffer)-1, fp) )
+    {
+        p = szBuffer;
+
+        while (*p)
+        {
+            if ((unsigned char) *p < 32)
+            {
+                *p = '\0';
+                break;
+            }
+            p++;
+        }
+
+        p = szBuffer;
+
+        if (0 == strncmp (p, "ERROR:", 6))
+            p += 6;
+
+        AddFile (p, 0, 0, 0);
+    }
+
+Done:
+
+    if (fp)
+    {
+        fclose (fp);
+        fp = NULL;
+    }
+
+    return ret;
+}
+
+int InstallManifest::Write (const char *pszFileName)
+{
+    /* Written to a temporary file and renamed, a crash leaves the previous manifest */
+
+    int  ret = 0;
+    int  i   = 0;
+    FILE *fp = NULL;
+    const MANIFEST_ENTRY *pEntry = NULL;
+
+    char szTempFile[1024] = {0};
+
+    snprintf (szTempFile, sizeof (szTempFile)-1, "%s.tmp", pszFileName);
+
+    fp = fopen (szTempFile, "w");
+
+    if (NULL == fp)
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    for (i=0; i<m_Count; i++)
+    {
+        pEntry = m_pEntries + i;
+
+        if (MANIFEST_TYPE_DIRECTORY == pEntry->Type)
+            fprintf (fp, "D|%s\n", pEntry->pszPath);
+        else if (MANIFEST_TYPE_OWNED_DIRECTORY == pEntry->Type)
+            fprintf (fp, "O|%s\n", pEntry->pszPath);
+        else
+            fprintf (fp, "F|%lld|%lld|%016llx|%s\n", pEntry->Size, pEntry->Mtime, pEntry->Hash, pEntry->pszPath);
+    }
+
+    if (fflush (fp) || ferror (fp))
+        ret = 1;
+
+    if (fclose (fp))
+        ret = 1;
+
+    fp = NULL;
+
+    if (ret)
+    {
+        remove (szTempFile);
+        goto Done;
+    }
+
+    ret = replace_file (szTempFile, pszFileName);
+
+Done:
+
+    return ret;
+}
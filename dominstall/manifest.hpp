@@ -0,0 +1,101 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef MANIFEST_HPP
+    #define MANIFEST_HPP
+
+#include "dominoinstall.hpp"
+
+#define MANIFEST_TYPE_FILE             1
+#define MANIFEST_TYPE_DIRECTORY        2
+#define MANIFEST_TYPE_OWNED_DIRECTORY  3
+
+#define HASH_FILE_NOCACHE        1
+
+#define MANIFEST_HASH_BUFFER     (64*1024)
+
+typedef struct {
+    unsigned long long TotalLen;
+    unsigned long long Acc[4];
+    unsigned char Mem[32];
+    int  MemSize;
+} XXH64_STATE;
+
+typedef struct {
+    char *pszPath;
+    long long Size;
+    long long Mtime;
+    unsigned long long Hash;
+    int  Type;
+} MANIFEST_ENTRY;
+
+
+/* Manifest of installed files with size, modification time and XXH64 content hash.
+   One line per entry: "F|size|mtime|hash|path" for files and "D|path" for directories.
+   Directories created by the install are listed as "O|path" and only contain files of the application */
+
+class InstallManifest
+{
+
+public:
+
+    InstallManifest();
+    ~InstallManifest();
+
+    int  Read         (const char *pszFileName);
+    int  ReadFileList (const char *pszFileName);
+    int  Write        (const char *pszFileName);
+    int  AddFile      (const char *pszPath, long long Size, long long Mtime, unsigned long long Hash);
+    int  AddDirectory (const char *pszPath, int bOwned);
+
+    const MANIFEST_ENTRY *Find (const char *pszPath);
+
+    int  GetCount()
+    {
+        return m_Count;
+    }
+
+    const MANIFEST_ENTRY *GetEntry (int Entry)
+    {
+        return ( (Entry >= 0) && (Entry < m_Count) ) ? &m_pEntries[Entry] : NULL;
+    }
+
+private:
+
+    int  Add        (int Type, const char *pszPath, long long Size, long long Mtime, unsigned long long Hash);
+    int  IndexEntry (int Entry);
+
+    MANIFEST_ENTRY *m_pEntries;
+    int  m_Count;
+    int  m_CountMax;
+
+    int  *m_pIndex;
+    int  m_IndexSize;
+};
+
+
+/* XXH64 of data passed in pieces, e.g. while writing a file */
+void Xxh64Init (XXH64_STATE *pState);
+void Xxh64Update (XXH64_STATE *pState, const unsigned char *pData, size_t len);
+unsigned long long Xxh64Digest (const XXH64_STATE *pState);
+
+unsigned long long HashFile (const char *pszFileName, int Flags, int *retpError);
+
+#endif
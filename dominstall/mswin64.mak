@@ -1,7 +1,7 @@
 
 ###########################################################################
 # Domino Add-On Install                                                   #
-# Version 0.1 02.02.2023                                                  #
+# Version 0.2 19.10.2026                                                  #
 # (C) Copyright Daniel Nashed/NashCom 2023                                #
 #                                                                         #
 # Windows 64-bit version using                                            #
@@ -26,8 +26,10 @@ NODEBUG=1
 
 # Link command
 
-$(PROGRAM).exe: $(PROGRAM).obj
-	link /SUBSYSTEM:CONSOLE $(PROGRAM).obj msvcrt.lib  wintrust.lib Imagehlp.lib crypt32.lib User32.lib Advapi32.lib /PDB:$*.pdb /DEBUG /PDBSTRIPPED:$*_small.pdb /NODEFAULTLIB:LIBCMT -out:$@
+OBJS=$(PROGRAM).obj copysched.obj manifest.obj journal.obj verify.obj walker.obj tarinst.obj uninstall.obj plan.obj batch.obj stats.obj
+
+$(PROGRAM).exe: $(OBJS)
+	link /SUBSYSTEM:CONSOLE $(OBJS) msvcrt.lib msvcprt.lib  wintrust.lib Imagehlp.lib crypt32.lib User32.lib Advapi32.lib /PDB:$*.pdb /DEBUG /PDBSTRIPPED:$*_small.pdb /NODEFAULTLIB:LIBCMT -out:$@
 	del $*.pdb $*.sym
 	rename $*_small.pdb $*.pdb
 
@@ -36,6 +38,36 @@ $(PROGRAM).exe: $(PROGRAM).obj
 $(PROGRAM).obj: $(PROGRAM).cpp
 	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION $(PROGRAM).cpp
 
+copysched.obj: copysched.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION copysched.cpp
+
+manifest.obj: manifest.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION manifest.cpp
+
+journal.obj: journal.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION journal.cpp
+
+verify.obj: verify.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION verify.cpp
+
+walker.obj: walker.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION walker.cpp
+
+tarinst.obj: tarinst.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION tarinst.cpp
+
+uninstall.obj: uninstall.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION uninstall.cpp
+
+plan.obj: plan.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION plan.cpp
+
+batch.obj: batch.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION batch.cpp
+
+stats.obj: stats.cpp
+	cl -nologo -c -D_MT -MT /Zi /Ot /O2 /Ob2 /Oy- -Gd /Gy /GF /Gs4096 /GS- /favor:INTEL64 /EHsc /Zc:wchar_t- -Zl -W1 -DNT -DW32 -DW -DW64 -DND64 -D_AMD64_ -DDTRACE -D_CRT_SECURE_NO_WARNINGS -DPRODUCTION_VERSION stats.cpp
+
 all: $(PROGRAM).exe
 
 clean:
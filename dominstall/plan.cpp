@@ -0,0 +1,409 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef UNIX
+#include <sys/statvfs.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "dominoinstall.hpp"
+#include "plan.hpp"
+
+#ifdef UNIX
+    #define LSTAT lstat
+#else
+    #define LSTAT stat
+#endif
+
+/* Space of a file rounded up to full blocks */
+#define PLAN_BLOCK_SIZE  4096
+
+
+static size_t DirLen (const char *pszPath)
+{
+    const char *p = pszPath + strlen (pszPath);
+
+    while (p > pszPath)
+    {
+        p--;
+
+        if (('/' == *p) || (g_OsDirSep == *p))
+            return p - pszPath;
+    }
+
+    return 0;
+}
+
+static const char *GetOpName (int Type)
+{
+    switch (Type)
+    {
+        case PLAN_CREATE_DIRECTORY:
+            return "CREATE";
+
+        case PLAN_COPY_FILE:
+            return "COPY";
+
+        case PLAN_UNCHANGED_FILE:
+            return "UNCHANGED";
+
+        case PLAN_DELETE_FILE:
+            return "DELETE";
+
+        default:
+            return "";
+    } /* switch */
+}
+
+
+InstallPlan::InstallPlan()
+{
+    m_pOps   = NULL;
+    m_Ops    = 0;
+    m_OpsMax = 0;
+
+    m_FileSystemCount = 0;
+    m_CopyBytes       = 0;
+    m_LastFileSystem  = -1;
+
+    memset (m_FileSystems, 0, sizeof (m_FileSystems));
+    memset (m_szLastDir,   0, sizeof (m_szLastDir));
+}
+
+InstallPlan::~InstallPlan()
+{
+    if (m_pOps)
+    {
+        free (m_pOps);
+        m_pOps = NULL;
+    }
+}
+
+int InstallPlan::Add (int Type, const char *pszSource, const char *pszTarget, long long Size)
+{
+    PLAN_OP *pNew = NULL;
+
+    if (m_Ops >= m_OpsMax)
+    {
+        pNew = (PLAN_OP *) realloc (m_pOps, (m_OpsMax + 1024) * sizeof (PLAN_OP));
+
+        if (NULL == pNew)
+            return 1;
+
+        m_pOps    = pNew;
+        m_OpsMax += 1024;
+    }
+
+    m_pOps[m_Ops].Type      = Type;
+    m_pOps[m_Ops].pszSource = pszSource;
+    m_pOps[m_Ops].pszTarget = pszTarget;
+    m_pOps[m_Ops].Size      = Size;
+    m_Ops++;
+
+    return 0;
+}
+
+int InstallPlan::GetCount (int Type)
+{
+    int i = 0;
+    int Count = 0;
+
+    for (i=0; i<m_Ops; i++)
+    {
+        if (Type == m_pOps[i].Type)
+            Count++;
+    }
+
+    return Count;
+}
+
+int InstallPlan::IsUnchanged (const COPY_JOB *pJob, InstallManifest *pManifest)
+{
+    /* Same size and time stamp as recorded for the installed file. The content hash is still compared when copying */
+
+    const MANIFEST_ENTRY *pEntry = NULL;
+    struct stat Stat = {0};
+
+    if (NULL == pManifest)
+        return 0;
+
+    if (pJob->Link)
+        return 0;
+
+    pEntry = pManifest->Find (pJob->pszTarget);
+
+    if ((NULL == pEntry) || (MANIFEST_TYPE_FILE != pEntry->Type))
+        return 0;
+
+    if ((pEntry->Size != pJob->Size) || (pEntry->Mtime != pJob->Mtime))
+        return 0;
+
+    if (LSTAT (pJob->pszTarget, &Stat))
+        return 0;
+
+    return (pEntry->Size == Stat.st_size) && (pEntry->Mtime == Stat.st_mtime);
+}
+
+int InstallPlan::AddNeeded (const char *pszTarget, long long Size)
+{
+    /* Files are accounted to the file system of their nearest existing parent directory */
+
+    int  i = 0;
+    size_t len = DirLen (pszTarget);
+    unsigned long long Device = 0;
+    long long Available = -1;
+    PLAN_FILESYSTEM *pFileSystem = NULL;
+
+    char szDirectory[1024] = {0};
+
+    if ((len >= sizeof (szDirectory)) || (0 == len))
+        return 1;
+
+    memcpy (szDirectory, pszTarget, len);
+    szDirectory[len] = '\0';
+
+    Size = ((Size + PLAN_BLOCK_SIZE - 1) / PLAN_BLOCK_SIZE) * PLAN_BLOCK_SIZE;
+
+    if ((m_LastFileSystem >= 0) && (0 == strcmp (szDirectory, m_szLastDir)))
+    {
+        m_FileSystems[m_LastFileSystem].Needed += Size;
+        return 0;
+    }
+
+    strdncpy (m_szLastDir, szDirectory, sizeof (m_szLastDir));
+
+#ifdef UNIX
+    struct stat Stat = {0};
+    struct statvfs FsStat = {0};
+
+    while (stat (szDirectory, &Stat))
+    {
+        len = DirLen (szDirectory);
+
+        if (0 == len)
+        {
+            strdncpy (szDirectory, "/", sizeof (szDirectory));
+            continue;
+        }
+
+        szDirectory[len] = '\0';
+    }
+
+    Device = (unsigned long long) Stat.st_dev;
+
+#else
+    ULARGE_INTEGER FreeBytes = {0};
+    char szVolume[MAX_PATH+1] = {0};
+
+    if (0 == GetVolumePathName (szDirectory, szVolume, sizeof (szVolume)))
+        return 1;
+
+    strdncpy (szDirectory, szVolume, sizeof (szDirectory));
+    Device = HashPath (szVolume);
+#endif
+
+    for (i=0; i<m_FileSystemCount; i++)
+    {
+        if (Device == m_FileSystems[i].Device)
+        {
+            pFileSystem = &m_FileSystems[i];
+            break;
+        }
+    }
+
+    if (NULL == pFileSystem)
+    {
+        if (m_FileSystemCount >= PLAN_MAX_FILESYSTEMS)
+        {
+            m_LastFileSystem = -1;
+            return 1;
+        }
+
+#ifdef UNIX
+        if (0 == statvfs (szDirectory, &FsStat))
+            Available = (long long) FsStat.f_bavail * (long long) FsStat.f_frsize;
+#else
+        if (GetDiskFreeSpaceEx (szVolume, &FreeBytes, NULL, NULL))
+            Available = (long long) FreeBytes.QuadPart;
+#endif
+
+        pFileSystem = &m_FileSystems[m_FileSystemCount++];
+        strdncpy (pFileSystem->szPath, szDirectory, sizeof (pFileSystem->szPath));
+        pFileSystem->Device    = Device;
+        pFileSystem->Available = Available;
+        pFileSystem->Needed    = 0;
+    }
+
+    m_LastFileSystem = (int) (pFileSystem - m_FileSystems);
+    pFileSystem->Needed += Size;
+
+    return 0;
+}
+
+int InstallPlan::Build (CopyScheduler *pScheduler, InstallManifest *pIncrementalManifest, InstallManifest *pPreviousFiles)
+{
+    int i = 0;
+    int ret = 0;
+    const COPY_DIR *pDir = NULL;
+    const COPY_JOB *pJob = NULL;
+    const MANIFEST_ENTRY *pEntry = NULL;
+    struct stat Stat = {0};
+
+    for (i=0; i<pScheduler->GetDirectoryCount(); i++)
+    {
+        pDir = pScheduler->GetDirectory (i);
+
+        if (stat (pDir->pszTarget, &Stat))
+            ret |= Add (PLAN_CREATE_DIRECTORY, pDir->pszSource, pDir->pszTarget, 0);
+    }
+
+    for (i=0; i<pScheduler->GetFileCount(); i++)
+    {
+        pJob = pScheduler->GetJob (i);
+
+        if (IsUnchanged (pJob, pIncrementalManifest))
+        {
+            ret |= Add (PLAN_UNCHANGED_FILE, pJob->pszSource, pJob->pszTarget, pJob->Size);
+            continue;
+        }
+
+        ret |= Add (PLAN_COPY_FILE, pJob->pszSource, pJob->pszTarget, pJob->Size);
+        AddNeeded (pJob->pszTarget, pJob->Size);
+        m_CopyBytes += pJob->Size;
+    }
+
+    /* Files of the previous version are only deleted on commit and do not free space before */
+    for (i=0; pPreviousFiles && (i<pPreviousFiles->GetCount()); i++)
+    {
+        pEntry = pPreviousFiles->GetEntry (i);
+
+        if (MANIFEST_TYPE_FILE != pEntry->Type)
+            continue;
+
+        if (pScheduler->FindTarget (pEntry->pszPath) >= 0)
+            continue;
+
+        ret |= Add (PLAN_DELETE_FILE, NULL, pEntry->pszPath, pEntry->Size);
+    }
+
+    return ret;
+}
+
+int InstallPlan::CheckDiskSpace()
+{
+    int i = 0;
+    int ret = 0;
+
+    for (i=0; i<m_FileSystemCount; i++)
+    {
+        if (m_FileSystems[i].Available < 0)
+            continue;
+
+        if (m_FileSystems[i].Needed <= m_FileSystems[i].Available)
+            continue;
+
+        printf ("Not enough disk space in [%s]: %lld MB needed, %lld MB available\n",
+                m_FileSystems[i].szPath, m_FileSystems[i].Needed / 1048576, m_FileSystems[i].Available / 1048576);
+
+        ret = 1;
+    }
+
+    return ret;
+}
+
+void InstallPlan::Print (int Format)
+{
+    int i = 0;
+    int Count = 0;
+    const PLAN_OP *pOp = NULL;
+
+    if (OUTPUT_FORMAT_JSON == Format)
+    {
+        printf ("{\n  \"operations\": [");
+
+        for (i=0; i<m_Ops; i++)
+        {
+            pOp = &m_pOps[i];
+
+            printf ("%s\n    {\"op\": \"%s\", ", i ? "," : "", GetOpName (pOp->Type));
+
+            if (pOp->pszSource && *pOp->pszSource)
+            {
+                printf ("\"source\": ");
+                PrintJsonString (stdout, pOp->pszSource);
+                printf (", ");
+            }
+
+            printf ("\"target\": ");
+            PrintJsonString (stdout, pOp->pszTarget);
+
+            if (PLAN_CREATE_DIRECTORY != pOp->Type)
+                printf (", \"size\": %lld", pOp->Size);
+
+            printf ("}");
+        }
+
+        printf ("%s],\n  \"filesystems\": [", m_Ops ? "\n  " : "");
+
+        for (i=0; i<m_FileSystemCount; i++)
+        {
+            printf ("%s\n    {\"path\": ", i ? "," : "");
+            PrintJsonString (stdout, m_FileSystems[i].szPath);
+            printf (", \"needed\": %lld, \"available\": %lld}", m_FileSystems[i].Needed, m_FileSystems[i].Available);
+        }
+
+        printf ("%s],\n", m_FileSystemCount ? "\n  " : "");
+
+        printf ("  \"directories\": %d,\n", GetCount (PLAN_CREATE_DIRECTORY));
+        printf ("  \"copy\": %d,\n",        GetCount (PLAN_COPY_FILE));
+        printf ("  \"copy_bytes\": %lld,\n", m_CopyBytes);
+        printf ("  \"unchanged\": %d,\n",   GetCount (PLAN_UNCHANGED_FILE));
+        printf ("  \"delete\": %d,\n",      GetCount (PLAN_DELETE_FILE));
+
+        for (i=0; i<m_FileSystemCount; i++)
+        {
+            if ((m_FileSystems[i].Available >= 0) && (m_FileSystems[i].Needed > m_FileSystems[i].Available))
+                Count++;
+        }
+
+        printf ("  \"space_ok\": %s\n}\n", Count ? "false" : "true");
+        return;
+    }
+
+    for (i=0; i<m_Ops; i++)
+    {
+        pOp = &m_pOps[i];
+
+        if (PLAN_CREATE_DIRECTORY == pOp->Type)
+            printf ("%s|%s\n", GetOpName (pOp->Type), pOp->pszTarget);
+        else
+            printf ("%s|%lld|%s\n", GetOpName (pOp->Type), pOp->Size, pOp->pszTarget);
+    }
+
+    for (i=0; i<m_FileSystemCount; i++)
+        printf ("SPACE|%lld|%lld|%s\n", m_FileSystems[i].Needed, m_FileSystems[i].Available, m_FileSystems[i].szPath);
+
+    printf ("Plan: create %d directories, copy %d files (%lld MB), unchanged: %d, delete: %d\n",
+            GetCount (PLAN_CREATE_DIRECTORY), GetCount (PLAN_COPY_FILE), m_CopyBytes / 1048576,
+            GetCount (PLAN_UNCHANGED_FILE), GetCount (PLAN_DELETE_FILE));
+}
@@ -0,0 +1,91 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef PLAN_HPP
+    #define PLAN_HPP
+
+#include "dominoinstall.hpp"
+#include "manifest.hpp"
+#include "copysched.hpp"
+
+#define PLAN_CREATE_DIRECTORY  1
+#define PLAN_COPY_FILE         2
+#define PLAN_UNCHANGED_FILE    3
+#define PLAN_DELETE_FILE       4
+
+#define PLAN_MAX_FILESYSTEMS   16
+
+typedef struct {
+    int  Type;
+    const char *pszSource;
+    const char *pszTarget;
+    long long Size;
+} PLAN_OP;
+
+typedef struct {
+    char szPath[1024];
+    unsigned long long Device;
+    long long Needed;
+    long long Available;
+} PLAN_FILESYSTEM;
+
+
+/* Install plan built from the collected package before anything is written.
+   Lists directories to create, files to copy or to keep and files of the previous version to delete.
+   Staged files exist next to the previous version until commit, so every file to copy needs its full size on the target file system */
+
+class InstallPlan
+{
+
+public:
+
+    InstallPlan();
+    ~InstallPlan();
+
+    int  Build (CopyScheduler *pScheduler, InstallManifest *pIncrementalManifest, InstallManifest *pPreviousFiles);
+    int  CheckDiskSpace();
+    void Print (int Format);
+
+    int  GetCount (int Type);
+
+    long long GetCopyBytes()
+    {
+        return m_CopyBytes;
+    }
+
+private:
+
+    int  Add (int Type, const char *pszSource, const char *pszTarget, long long Size);
+    int  IsUnchanged (const COPY_JOB *pJob, InstallManifest *pManifest);
+    int  AddNeeded (const char *pszTarget, long long Size);
+
+    PLAN_OP *m_pOps;
+    int  m_Ops;
+    int  m_OpsMax;
+
+    PLAN_FILESYSTEM m_FileSystems[PLAN_MAX_FILESYSTEMS];
+    int  m_FileSystemCount;
+
+    long long m_CopyBytes;
+    char m_szLastDir[1024];
+    int  m_LastFileSystem;
+};
+
+#endif
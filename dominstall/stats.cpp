@@ -0,0 +1,316 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dominoinstall.hpp"
+#include "stats.hpp"
+
+/* Upper bounds of the latency buckets in microseconds. The last bucket has no upper bound */
+static const long long g_LatencyBounds[STATS_LATENCY_BUCKETS-1] = { 10, 100, 1000, 10000, 100000, 1000000 };
+
+static const char *g_pszGroupNames[STATS_GROUPS] = { "domino-bin", "domino-data", "version-dir", "fan-out" };
+
+
+static int HasComponent (const char *pszPath, const char *pszName, BOOL bPrefix)
+{
+    /* Archive entries always use '/', collected files the OS separator */
+
+    size_t Len = strlen (pszName);
+    const char *p = pszPath;
+
+    while (*p)
+    {
+        if (((p == pszPath) || ('/' == p[-1]) || ('\\' == p[-1])) && (0 == strncmp (p, pszName, Len)))
+        {
+            if (bPrefix || ('\0' == p[Len]) || ('/' == p[Len]) || ('\\' == p[Len]))
+                return 1;
+        }
+
+        p++;
+    }
+
+    return 0;
+}
+
+static int GetGroup (const COPY_JOB *pJob, const char *pszPackageDir)
+{
+    const char *pszSource = pJob->pszSource;
+    size_t Len = pszPackageDir ? strlen (pszPackageDir) : 0;
+
+    if (pJob->Primary >= 0)
+        return STATS_GROUP_FANOUT;
+
+    if (Len && (0 == strncmp (pszSource, pszPackageDir, Len)))
+        pszSource += Len;
+
+    if (HasComponent (pszSource, "Release_", TRUE))
+        return STATS_GROUP_VERSION;
+
+    if (HasComponent (pszSource, "domino-bin", FALSE))
+        return STATS_GROUP_BIN;
+
+    return STATS_GROUP_DATA;
+}
+
+static int CompareDuration (const void *p1, const void *p2)
+{
+    long long d1 = *(const long long *) p1;
+    long long d2 = *(const long long *) p2;
+
+    return (d1 > d2) - (d1 < d2);
+}
+
+
+InstallStats::InstallStats()
+{
+    memset (m_Phases,  0, sizeof (m_Phases));
+    memset (m_Groups,  0, sizeof (m_Groups));
+    memset (m_Latency, 0, sizeof (m_Latency));
+
+    m_PhaseCount  = 0;
+    m_PhaseStart  = 0;
+    m_pDurations  = NULL;
+    m_Durations   = 0;
+    m_Copied      = 0;
+    m_CopiedBytes = 0;
+}
+
+InstallStats::~InstallStats()
+{
+    free (m_pDurations);
+    m_pDurations = NULL;
+}
+
+void InstallStats::Phase (const char *pszPhase)
+{
+    /* Ends the running phase and starts the next one. NULL only ends the running phase. Phase names must be constant strings */
+
+    long long Now = GetMicroseconds();
+
+    if (m_PhaseStart && m_PhaseCount)
+        m_Phases[m_PhaseCount-1].Duration = Now - m_PhaseStart;
+
+    m_PhaseStart = 0;
+
+    if ((NULL == pszPhase) || (m_PhaseCount >= STATS_MAX_PHASES))
+        return;
+
+    m_Phases[m_PhaseCount].pszName  = pszPhase;
+    m_Phases[m_PhaseCount].Duration = 0;
+    m_PhaseCount++;
+
+    m_PhaseStart = Now;
+}
+
+long long InstallStats::GetPhaseDuration (const char *pszPhase)
+{
+    int i = 0;
+
+    for (i=0; i<m_PhaseCount; i++)
+    {
+        if (0 == strcmp (m_Phases[i].pszName, pszPhase))
+            return m_Phases[i].Duration;
+    }
+
+    return 0;
+}
+
+long long InstallStats::GetPerSecond (long long Count)
+{
+    long long Duration = GetPhaseDuration ("copy");
+
+    if (Duration <= 0)
+        return 0;
+
+    return (long long) ((double) Count * 1000000.0 / (double) Duration);
+}
+
+long long InstallStats::GetPercentile (int Percent)
+{
+    if (0 == m_Durations)
+        return 0;
+
+    /* Nearest rank */
+    return m_pDurations[((long long) m_Durations * Percent + 99) / 100 - 1];
+}
+
+int InstallStats::AddJobs (CopyScheduler *pScheduler, const char *pszPackageDir)
+{
+    /* Called once after copying. Package directory is NULL for archives */
+
+    int i = 0;
+    int b = 0;
+    const COPY_JOB *pJob = NULL;
+    STATS_GROUP *pGroup  = NULL;
+
+    free (m_pDurations);
+    m_Durations  = 0;
+    m_pDurations = (long long *) malloc (sizeof (long long) * (pScheduler->GetFileCount() + 1));
+
+    if (NULL == m_pDurations)
+        return 1;
+
+    for (i=0; i<pScheduler->GetFileCount(); i++)
+    {
+        pJob   = pScheduler->GetJob (i);
+        pGroup = &m_Groups[GetGroup (pJob, pszPackageDir)];
+
+        if (COPY_JOB_SKIPPED == pJob->Result)
+        {
+            pGroup->Unchanged++;
+            pGroup->Busy += pJob->Duration;
+            continue;
+        }
+
+        if (COPY_JOB_ERROR == pJob->Result)
+        {
+            pGroup->Errors++;
+            pGroup->Busy += pJob->Duration;
+            continue;
+        }
+
+        if (COPY_JOB_COPIED != pJob->Result)
+            continue;
+
+        pGroup->Copied++;
+        pGroup->Bytes += pJob->Size;
+        pGroup->Busy  += pJob->Duration;
+
+        m_Copied++;
+        m_CopiedBytes += pJob->Size;
+
+        for (b=0; b<STATS_LATENCY_BUCKETS-1; b++)
+        {
+            if (pJob->Duration <= g_LatencyBounds[b])
+                break;
+        }
+
+        m_Latency[b]++;
+        m_pDurations[m_Durations++] = pJob->Duration;
+    }
+
+    qsort (m_pDurations, m_Durations, sizeof (long long), CompareDuration);
+
+    return 0;
+}
+
+void InstallStats::Print()
+{
+    printf ("Copy time: %.3f sec, %lld files/sec, %.1f MB/sec, latency p50: %lld us, p99: %lld us\n",
+            (double) GetPhaseDuration ("copy") / 1000000.0,
+            GetPerSecond (m_Copied),
+            (double) GetPerSecond (m_CopiedBytes) / (1024.0 * 1024.0),
+            GetPercentile (50),
+            GetPercentile (99));
+}
+
+void InstallStats::Write (FILE *fp)
+{
+    /* Statistics section of the install log */
+
+    int i = 0;
+
+    if (NULL == fp)
+        return;
+
+    fprintf (fp, "-- Statistics --\n");
+
+    for (i=0; i<m_PhaseCount; i++)
+        fprintf (fp, "PhaseTimeUs=%s,%lld\n", m_Phases[i].pszName, m_Phases[i].Duration);
+
+    fprintf (fp, "CopiedBytes=%lld\n",     m_CopiedBytes);
+    fprintf (fp, "CopyFilesPerSec=%lld\n", GetPerSecond (m_Copied));
+    fprintf (fp, "CopyBytesPerSec=%lld\n", GetPerSecond (m_CopiedBytes));
+
+    /* Copied, unchanged, errors, bytes, summed copy time of all threads */
+    for (i=0; i<STATS_GROUPS; i++)
+    {
+        fprintf (fp, "CopyGroup=%s,%d,%d,%d,%lld,%lld\n", g_pszGroupNames[i],
+                 m_Groups[i].Copied, m_Groups[i].Unchanged, m_Groups[i].Errors, m_Groups[i].Bytes, m_Groups[i].Busy);
+    }
+
+    for (i=0; i<STATS_LATENCY_BUCKETS-1; i++)
+        fprintf (fp, "CopyLatencyUs=%lld,%d\n", g_LatencyBounds[i], m_Latency[i]);
+
+    fprintf (fp, "CopyLatencyUs=inf,%d\n", m_Latency[STATS_LATENCY_BUCKETS-1]);
+
+    fprintf (fp, "CopyLatencyP50Us=%lld\n", GetPercentile (50));
+    fprintf (fp, "CopyLatencyP95Us=%lld\n", GetPercentile (95));
+    fprintf (fp, "CopyLatencyP99Us=%lld\n", GetPercentile (99));
+    fprintf (fp, "CopyLatencyMaxUs=%lld\n", GetPercentile (100));
+    fprintf (fp, "-- Statistics --\n");
+}
+
+int InstallStats::WriteJson (const char *pszFileName, const char *pszName, const char *pszVersion, const char *pszResult, int Threads)
+{
+    int  i  = 0;
+    int  ret = 0;
+    FILE *fp = NULL;
+
+    fp = fopen (pszFileName, "w");
+
+    if (NULL == fp)
+        return 1;
+
+    fprintf (fp, "{\n  \"name\": ");
+    PrintJsonString (fp, pszName);
+    fprintf (fp, ",\n  \"version\": ");
+    PrintJsonString (fp, pszVersion);
+    fprintf (fp, ",\n  \"result\": \"%s\",\n  \"threads\": %d,\n", pszResult, Threads);
+
+    fprintf (fp, "  \"phases_us\": {");
+
+    for (i=0; i<m_PhaseCount; i++)
+        fprintf (fp, "%s\"%s\": %lld", i ? ", " : "", m_Phases[i].pszName, m_Phases[i].Duration);
+
+    fprintf (fp, "},\n");
+
+    fprintf (fp, "  \"copy\": {\"files\": %d, \"bytes\": %lld, \"files_per_sec\": %lld, \"bytes_per_sec\": %lld},\n",
+             m_Copied, m_CopiedBytes, GetPerSecond (m_Copied), GetPerSecond (m_CopiedBytes));
+
+    fprintf (fp, "  \"groups\": {\n");
+
+    for (i=0; i<STATS_GROUPS; i++)
+    {
+        fprintf (fp, "    \"%s\": {\"copied\": %d, \"unchanged\": %d, \"errors\": %d, \"bytes\": %lld, \"busy_us\": %lld}%s\n",
+                 g_pszGroupNames[i], m_Groups[i].Copied, m_Groups[i].Unchanged, m_Groups[i].Errors, m_Groups[i].Bytes, m_Groups[i].Busy,
+                 (i < STATS_GROUPS-1) ? "," : "");
+    }
+
+    fprintf (fp, "  },\n");
+
+    fprintf (fp, "  \"latency_us\": {\"p50\": %lld, \"p95\": %lld, \"p99\": %lld, \"max\": %lld, \"histogram\": [",
+             GetPercentile (50), GetPercentile (95), GetPercentile (99), GetPercentile (100));
+
+    for (i=0; i<STATS_LATENCY_BUCKETS-1; i++)
+        fprintf (fp, "{\"le\": %lld, \"count\": %d}, ", g_LatencyBounds[i], m_Latency[i]);
+
+    fprintf (fp, "{\"le\": null, \"count\": %d}]}\n}\n", m_Latency[STATS_LATENCY_BUCKETS-1]);
+
+    if (fflush (fp) || ferror (fp))
+        ret = 1;
+
+    if (fclose (fp))
+        ret = 1;
+
+    return ret;
+}
@@ -0,0 +1,88 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef STATS_HPP
+    #define STATS_HPP
+
+#include "dominoinstall.hpp"
+#include "copysched.hpp"
+
+#define STATS_GROUP_BIN        0
+#define STATS_GROUP_DATA       1
+#define STATS_GROUP_VERSION    2
+#define STATS_GROUP_FANOUT     3
+#define STATS_GROUPS           4
+
+#define STATS_MAX_PHASES       16
+#define STATS_LATENCY_BUCKETS  7
+
+typedef struct {
+    const char *pszName;
+    long long Duration;
+} STATS_PHASE;
+
+typedef struct {
+    int  Copied;
+    int  Unchanged;
+    int  Errors;
+    long long Bytes;
+    long long Busy;
+} STATS_GROUP;
+
+
+/* Timing of an install.
+   Phases are measured in wall clock time. Files are copied in parallel, so per package directory the summed copy time of all threads is reported.
+   The latency histogram and percentiles only contain copied files */
+
+class InstallStats
+{
+
+public:
+
+    InstallStats();
+    ~InstallStats();
+
+    void Phase (const char *pszPhase);
+    int  AddJobs (CopyScheduler *pScheduler, const char *pszPackageDir);
+    void Print();
+    void Write (FILE *fp);
+    int  WriteJson (const char *pszFileName, const char *pszName, const char *pszVersion, const char *pszResult, int Threads);
+
+private:
+
+    long long GetPhaseDuration (const char *pszPhase);
+    long long GetPercentile (int Percent);
+    long long GetPerSecond (long long Count);
+
+    STATS_PHASE m_Phases[STATS_MAX_PHASES];
+    int  m_PhaseCount;
+    long long m_PhaseStart;
+
+    STATS_GROUP m_Groups[STATS_GROUPS];
+    int  m_Latency[STATS_LATENCY_BUCKETS];
+
+    long long *m_pDurations;
+    int  m_Durations;
+
+    int  m_Copied;
+    long long m_CopiedBytes;
+};
+
+#endif
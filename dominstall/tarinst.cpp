@@ -0,0 +1,1106 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef UNIX
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#include <fcntl.h>
+#include <sys/utime.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "dominoinstall.hpp"
+#include "tarinst.hpp"
+
+#define TAR_TYPE_FILE        '0'
+#define TAR_TYPE_OLD_FILE    '\0'
+#define TAR_TYPE_CONTIGUOUS  '7'
+#define TAR_TYPE_HARDLINK    '1'
+#define TAR_TYPE_SYMLINK     '2'
+#define TAR_TYPE_DIRECTORY   '5'
+#define TAR_TYPE_GNU_NAME    'L'
+#define TAR_TYPE_GNU_LINK    'K'
+#define TAR_TYPE_PAX         'x'
+#define TAR_TYPE_PAX_GLOBAL  'g'
+
+#define TAR_PADDING(Size)    ((TAR_BLOCK_SIZE - ((Size) % TAR_BLOCK_SIZE)) % TAR_BLOCK_SIZE)
+
+#ifdef UNIX
+    #define LSTAT lstat
+    #define TAR_NAME_SEPARATORS "/"
+#else
+    #define LSTAT stat
+    #define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+    #define TAR_NAME_SEPARATORS "/\\"
+#endif
+
+
+static void TarError (const char *pszError, const char *pszName)
+{
+    printf ("%s: [%s]\n", pszError, pszName);
+
+    if (g_fpLog)
+        fprintf (g_fpLog, "%s: [%s]\n", pszError, pszName);
+}
+
+static long long ParseTarNumber (const unsigned char *p, int len)
+{
+    /* Octal ASCII. GNU tar uses base-256 with the high bit set for values which do not fit */
+
+    long long Value = 0;
+    int i = 0;
+
+    if (0x80 & p[0])
+    {
+        Value = p[0] & 0x3f;
+
+        for (i=1; i<len; i++)
+            Value = (Value << 8) | p[i];
+
+        return Value;
+    }
+
+    while ((i < len) && ((' ' == p[i]) || ('\0' == p[i])))
+        i++;
+
+    while ((i < len) && (p[i] >= '0') && (p[i] <= '7'))
+        Value = (Value << 3) + (p[i++] - '0');
+
+    return Value;
+}
+
+static const char *NormalizeTarName (const char *pszName)
+{
+    /* Archives created with "tar -C pkg -cf pkg.tar ." prefix all entries with "./" */
+
+    const char *p = pszName;
+
+    while (1)
+    {
+        if (('.' == p[0]) && ('/' == p[1]))
+            p += 2;
+        else if ('/' == p[0])
+            p++;
+        else
+            break;
+    }
+
+    return p;
+}
+
+static int IsRealDirectory (const char *pszPath)
+{
+    /* An existing directory must not be a link, which would redirect writes outside the target directories */
+
+    struct stat Stat = {0};
+
+    if (LSTAT (pszPath, &Stat) || !S_ISDIR (Stat.st_mode))
+        return 0;
+
+#ifndef UNIX
+    if (FILE_ATTRIBUTE_REPARSE_POINT & GetFileAttributes (pszPath))
+        return 0;
+#endif
+
+    return 1;
+}
+
+static int HasRealParents (const char *pszPath, size_t RootLen)
+{
+    /* All existing parent directories below the root are real directories */
+
+    char *p = NULL;
+    char szPath[TAR_MAX_PATH] = {0};
+
+    strdncpy (szPath, pszPath, sizeof (szPath));
+
+    for (p = szPath + RootLen + 1; *p; p++)
+    {
+        if (g_OsDirSep != *p)
+            continue;
+
+        *p = '\0';
+
+        if (!IsRealDirectory (szPath))
+            return 0;
+
+        *p = g_OsDirSep;
+    }
+
+    return 1;
+}
+
+static int IsLinkInsideRoot (const char *pszTarget, size_t RootLen, const char *pszLink)
+{
+    /* A symbolic link must be relative and must not point above the install directory it is written to */
+
+    int Depth = 0;
+    size_t len = 0;
+    const char *p = NULL;
+
+    if (('\0' == *pszLink) || ('/' == *pszLink) || ('\\' == *pszLink) || strchr (pszLink, ':'))
+        return 0;
+
+    /* Directory level of the link itself below the root */
+    for (p = pszTarget + RootLen + 1; *p; p++)
+    {
+        if (g_OsDirSep == *p)
+            Depth++;
+    }
+
+    for (p = pszLink; *p; )
+    {
+        len = strcspn (p, "/\\");
+
+        if ((2 == len) && (0 == strncmp (p, "..", 2)))
+            Depth--;
+        else if ((len > 0) && !((1 == len) && ('.' == *p)))
+            Depth++;
+
+        if (Depth < 0)
+            return 0;
+
+        p += len;
+
+        if (*p)
+            p++;
+    }
+
+    return 1;
+}
+
+static int IsTarFile (char Type)
+{
+    return ((TAR_TYPE_FILE == Type) || (TAR_TYPE_OLD_FILE == Type) || (TAR_TYPE_CONTIGUOUS == Type));
+}
+
+static int IsTarPayload (const char *pszName)
+{
+    if (0 == strncmp (pszName, "domino-bin/", 11))
+        return 1;
+
+    if (0 == strncmp (pszName, "domino-data/", 12))
+        return 1;
+
+    if (0 == strncmp (pszName, "Release_", 8))
+        return 1;
+
+    return 0;
+}
+
+static long GetTarEntryBuild (const char *pszName)
+{
+    /* Build of the Release_ directory of an entry. 0 for the generic directories */
+
+    char szVersion[80] = {0};
+    const char *p = NormalizeTarName (pszName);
+    size_t len = 0;
+
+    if (strncmp (p, "Release_", 8))
+        return 0;
+
+    p += 8;
+
+    while (p[len] && ('/' != p[len]) && (len < sizeof (szVersion)-1))
+        len++;
+
+    memcpy (szVersion, p, len);
+    szVersion[len] = '\0';
+
+    return DominoBuildNumFromVersion (szVersion, NULL);
+}
+
+
+TarInstaller::TarInstaller()
+{
+    m_fp      = NULL;
+    m_bStdin  = FALSE;
+    m_pBuffer = NULL;
+    m_pszInstallIni = NULL;
+
+    m_lDominoBuild  = 0;
+    m_pszProgramDir = NULL;
+    m_pszDataDir    = NULL;
+    m_pScheduler    = NULL;
+    m_pJournal      = NULL;
+    m_pOldManifest  = NULL;
+
+    m_pDirs   = NULL;
+    m_Dirs    = 0;
+    m_DirsMax = 0;
+
+    m_szLastParent[0] = '\0';
+}
+
+TarInstaller::~TarInstaller()
+{
+    int i = 0;
+
+    if (m_fp && (FALSE == m_bStdin))
+        fclose (m_fp);
+
+    m_fp = NULL;
+
+    for (i=0; i<m_Dirs; i++)
+        free (m_pDirs[i].pszTarget);
+
+    if (m_pDirs)
+    {
+        free (m_pDirs);
+        m_pDirs = NULL;
+    }
+
+    if (m_pBuffer)
+    {
+        free (m_pBuffer);
+        m_pBuffer = NULL;
+    }
+
+    if (m_pszInstallIni)
+    {
+        free (m_pszInstallIni);
+        m_pszInstallIni = NULL;
+    }
+}
+
+int TarInstaller::Open (const char *pszTarFile)
+{
+    m_pBuffer = (unsigned char *) malloc (TAR_BUFFER_SIZE);
+
+    if (NULL == m_pBuffer)
+        return 1;
+
+    if (0 == strcmp (pszTarFile, "-"))
+    {
+        m_fp = stdin;
+        m_bStdin = TRUE;
+
+#ifndef UNIX
+        _setmode (_fileno (stdin), _O_BINARY);
+#endif
+    }
+    else
+    {
+        m_fp = fopen (pszTarFile, "rb");
+    }
+
+    if (NULL == m_fp)
+    {
+        TarError ("Cannot open archive", pszTarFile);
+        return 1;
+    }
+
+    return 0;
+}
+
+int TarInstaller::Read (void *pBuffer, size_t len)
+{
+    if (0 == len)
+        return 0;
+
+    if (len != fread (pBuffer, 1, len, m_fp))
+        return 1;
+
+    return 0;
+}
+
+int TarInstaller::Skip (long long Size)
+{
+    /* Skip data and padding of an entry. A pipe cannot seek */
+
+    long long Remaining = Size + TAR_PADDING (Size);
+    size_t len = 0;
+
+    while (Remaining > 0)
+    {
+        len = (Remaining > TAR_BUFFER_SIZE) ? TAR_BUFFER_SIZE : (size_t) Remaining;
+
+        if (Read (m_pBuffer, len))
+            return 1;
+
+        Remaining -= len;
+    }
+
+    return 0;
+}
+
+int TarInstaller::ReadLongName (long long Size, char *retpszName)
+{
+    /* GNU long name or link. The data is the NUL terminated name */
+
+    if ((Size <= 0) || (Size >= TAR_MAX_PATH))
+        return 1;
+
+    if (Read (m_pBuffer, (size_t) (Size + TAR_PADDING (Size))))
+        return 1;
+
+    memcpy (retpszName, m_pBuffer, (size_t) Size);
+    retpszName[Size] = '\0';
+
+    return 0;
+}
+
+int TarInstaller::ReadPaxHeader (long long Size, TAR_ENTRY *pEntry)
+{
+    /* Records in the format "<length> <key>=<value>\n". Only path, linkpath, size and mtime are used */
+
+    char *p      = NULL;
+    char *pEnd   = NULL;
+    char *pKey   = NULL;
+    char *pValue = NULL;
+    char *pNext  = NULL;
+    long len     = 0;
+
+    if ((Size < 0) || (Size >= TAR_BUFFER_SIZE))
+        return 1;
+
+    if (Read (m_pBuffer, (size_t) (Size + TAR_PADDING (Size))))
+        return 1;
+
+    p    = (char *) m_pBuffer;
+    pEnd = p + Size;
+
+    while (p < pEnd)
+    {
+        len = strtol (p, &pKey, 10);
+
+        if ((len <= 0) || (p + len > pEnd) || (' ' != *pKey))
+            return 1;
+
+        pNext = p + len;
+        pKey++;
+
+        /* Value ends before the newline of the record */
+        pValue = (char *) memchr (pKey, '=', pNext - pKey);
+
+        if ((NULL == pValue) || ('\n' != pNext[-1]))
+            return 1;
+
+        *pValue++   = '\0';
+        pNext[-1]   = '\0';
+
+        if (0 == strcmp (pKey, "path"))
+        {
+            if (strlen (pValue) >= sizeof (pEntry->szName))
+                return 1;
+
+            strdncpy (pEntry->szName, pValue, sizeof (pEntry->szName));
+        }
+        else if (0 == strcmp (pKey, "linkpath"))
+        {
+            if (strlen (pValue) >= sizeof (pEntry->szLink))
+                return 1;
+
+            strdncpy (pEntry->szLink, pValue, sizeof (pEntry->szLink));
+        }
+        else if (0 == strcmp (pKey, "size"))
+        {
+            pEntry->Size = strtoll (pValue, NULL, 10);
+
+            if (pEntry->Size < 0)
+                return 1;
+        }
+        else if (0 == strcmp (pKey, "mtime"))
+        {
+            pEntry->Mtime = strtoll (pValue, NULL, 10);
+        }
+
+        p = pNext;
+    }
+
+    return 0;
+}
+
+int TarInstaller::ReadHeader (TAR_ENTRY *pEntry)
+{
+    /* Returns 0 for an entry, -1 at the end of the archive and 1 for a damaged archive.
+       GNU long names and PAX headers are applied to the following entry */
+
+    int  i = 0;
+    size_t len = 0;
+    unsigned int Sum = 0;
+    unsigned char Header[TAR_BLOCK_SIZE];
+    TAR_ENTRY Pax;
+
+    memset (&Pax, 0, sizeof (Pax));
+    Pax.Size  = -1;
+    Pax.Mtime = -1;
+
+    while (1)
+    {
+        len = fread (Header, 1, sizeof (Header), m_fp);
+
+        if ((0 == len) && feof (m_fp))
+            return -1;
+
+        if (len != sizeof (Header))
+            return 1;
+
+        Sum = 0;
+
+        for (i=0; i<TAR_BLOCK_SIZE; i++)
+            Sum += ((i >= 148) && (i < 156)) ? ' ' : Header[i];
+
+        /* End of archive marker */
+        if (8 * ' ' == Sum)
+            return -1;
+
+        if (Sum != (unsigned int) ParseTarNumber (Header+148, 8))
+            return 1;
+
+        memset (pEntry, 0, sizeof (TAR_ENTRY));
+
+        pEntry->Type  = (char) Header[156];
+        pEntry->Mode  = (int) ParseTarNumber (Header+100, 8);
+        pEntry->Size  = ParseTarNumber (Header+124, 12);
+        pEntry->Mtime = ParseTarNumber (Header+136, 12);
+
+        /* A base-256 size can be negative in a damaged archive */
+        if (pEntry->Size < 0)
+            return 1;
+
+        switch (pEntry->Type)
+        {
+            case TAR_TYPE_GNU_NAME:
+
+                if (ReadLongName (pEntry->Size, Pax.szName))
+                    return 1;
+                continue;
+
+            case TAR_TYPE_GNU_LINK:
+
+                if (ReadLongName (pEntry->Size, Pax.szLink))
+                    return 1;
+                continue;
+
+            case TAR_TYPE_PAX:
+
+                if (ReadPaxHeader (pEntry->Size, &Pax))
+                    return 1;
+                continue;
+
+            case TAR_TYPE_PAX_GLOBAL:
+
+                if (Skip (pEntry->Size))
+                    return 1;
+                continue;
+
+            default:
+                break;
+        } /* switch */
+
+        if (Pax.szName[0])
+            strdncpy (pEntry->szName, Pax.szName, sizeof (pEntry->szName));
+        else if ((0 == memcmp (Header+257, "ustar", 5)) && Header[345])
+            snprintf (pEntry->szName, sizeof (pEntry->szName), "%.155s/%.100s", Header+345, Header);
+        else
+            snprintf (pEntry->szName, sizeof (pEntry->szName), "%.100s", Header);
+
+        if (Pax.szLink[0])
+            strdncpy (pEntry->szLink, Pax.szLink, sizeof (pEntry->szLink));
+        else
+            snprintf (pEntry->szLink, sizeof (pEntry->szLink), "%.100s", Header+157);
+
+        if (Pax.Size >= 0)
+            pEntry->Size = Pax.Size;
+
+        if (Pax.Mtime >= 0)
+            pEntry->Mtime = Pax.Mtime;
+
+        return 0;
+    }
+}
+
+int TarInstaller::ReadInstallIni()
+{
+    /* Entries outside the install directories (e.g. dominstall itself) may come first */
+
+    int ret = 0;
+    const char *pszName = NULL;
+    TAR_ENTRY Entry;
+
+    while (0 == (ret = ReadHeader (&Entry)))
+    {
+        pszName = NormalizeTarName (Entry.szName);
+
+        if (TAR_TYPE_DIRECTORY == Entry.Type)
+            continue;
+
+        if (IsTarFile (Entry.Type) && (0 == strcmp (pszName, "install.ini")))
+        {
+            if ((Entry.Size < 0) || (Entry.Size > TAR_MAX_INSTALL_INI))
+            {
+                TarError ("install.ini too large", Entry.szName);
+                return 1;
+            }
+
+            m_pszInstallIni = (char *) malloc ((size_t) Entry.Size + 1);
+
+            if (NULL == m_pszInstallIni)
+                return 1;
+
+            if (Read (m_pszInstallIni, (size_t) Entry.Size) || Read (m_pBuffer, TAR_PADDING (Entry.Size)))
+            {
+                TarError ("Archive truncated", Entry.szName);
+                return 1;
+            }
+
+            m_pszInstallIni[Entry.Size] = '\0';
+            return 0;
+        }
+
+        if (IsTarPayload (pszName))
+        {
+            TarError ("install.ini must be the first file in the archive", Entry.szName);
+            return 1;
+        }
+
+        if (Skip (Entry.Size))
+        {
+            TarError ("Archive truncated", Entry.szName);
+            return 1;
+        }
+    }
+
+    if (ret > 0)
+        TarError ("Invalid archive header", "install.ini");
+    else
+        TarError ("No install.ini found in archive", "install.ini");
+
+    return 1;
+}
+
+int TarInstaller::WriteInstallIni (const char *pszFileName)
+{
+    int  ret = 0;
+    FILE *fp = NULL;
+
+    if (NULL == m_pszInstallIni)
+        return 1;
+
+    fp = fopen (pszFileName, "wb");
+
+    if (NULL == fp)
+        return 1;
+
+    if (EOF == fputs (m_pszInstallIni, fp))
+        ret = 1;
+
+    if (fclose (fp))
+        ret = 1;
+
+    return ret;
+}
+
+int TarInstaller::MapTarget (const char *pszName, char *retpszTarget, size_t BufferSize, long *retpBuild, size_t *retpRootLen)
+{
+    /* Returns 0 for an entry of the install directories, 1 for other entries and -1 for invalid names */
+
+    const char *p      = NormalizeTarName (pszName);
+    const char *pRoot  = NULL;
+    const char *pStart = NULL;
+    char *t = NULL;
+    size_t len = 0;
+
+    *retpBuild = 0;
+
+    /* Never write outside the target directories */
+    for (pStart = p; *pStart; )
+    {
+        len = strcspn (pStart, TAR_NAME_SEPARATORS);
+
+        if ((2 == len) && (0 == strncmp (pStart, "..", 2)))
+            return -1;
+
+        pStart += len;
+
+        if (*pStart)
+            pStart++;
+    }
+
+    if (0 == strncmp (p, "Release_", 8))
+    {
+        *retpBuild = GetTarEntryBuild (p);
+
+        p = strchr (p, '/');
+
+        if (NULL == p)
+            return 1;
+
+        p++;
+    }
+
+    if (0 == strncmp (p, "domino-bin", 10) && (('/' == p[10]) || ('\0' == p[10])))
+    {
+        pRoot = m_pszProgramDir;
+        p += 10;
+    }
+    else if (0 == strncmp (p, "domino-data", 11) && (('/' == p[11]) || ('\0' == p[11])))
+    {
+        pRoot = m_pszDataDir;
+        p += 11;
+    }
+    else
+    {
+        return 1;
+    }
+
+    while ('/' == *p)
+        p++;
+
+    /* The install directory itself */
+    if ('\0' == *p)
+        return 1;
+
+    *retpRootLen = strlen (pRoot);
+
+    if (*retpRootLen + strlen (p) + 2 > BufferSize)
+        return -1;
+
+    snprintf (retpszTarget, BufferSize, "%s%c%s", pRoot, g_OsDirSep, p);
+
+    /* Directory entries end with a slash */
+    len = strlen (retpszTarget);
+
+    while ((len > *retpRootLen + 1) && ('/' == retpszTarget[len-1]))
+        retpszTarget[--len] = '\0';
+
+    for (t = retpszTarget + *retpRootLen; *t; t++)
+    {
+        if ('/' == *t)
+            *t = g_OsDirSep;
+    }
+
+    return 0;
+}
+
+int TarInstaller::AddDirectory (const char *pszTarget, int Mode, long long Mtime, int Created)
+{
+    TAR_DIR *pNew = NULL;
+
+    if (m_Dirs >= m_DirsMax)
+    {
+        pNew = (TAR_DIR *) realloc (m_pDirs, (m_DirsMax + 256) * sizeof (TAR_DIR));
+
+        if (NULL == pNew)
+            return 1;
+
+        m_pDirs    = pNew;
+        m_DirsMax += 256;
+    }
+
+    m_pDirs[m_Dirs].pszTarget = strdup (pszTarget);
+
+    if (NULL == m_pDirs[m_Dirs].pszTarget)
+        return 1;
+
+    m_pDirs[m_Dirs].Mode  = Mode;
+    m_pDirs[m_Dirs].Mtime = Mtime;
+    m_Dirs++;
+
+    if (Created && m_pJournal)
+        m_pJournal->AddEntry (JOURNAL_NEW_DIRECTORY, pszTarget);
+
+    return m_pScheduler->AddTargetDirectory (pszTarget, Created);
+}
+
+int TarInstaller::CreateParents (const char *pszTarget, size_t RootLen)
+{
+    /* Archives do not need to contain directory entries. Entries of one directory are usually stored together */
+
+    char c = 0;
+    char *p = NULL;
+    char *pSep = NULL;
+    char szPath[TAR_MAX_PATH] = {0};
+
+    strdncpy (szPath, pszTarget, sizeof (szPath));
+
+    pSep = strrchr (szPath, g_OsDirSep);
+
+    if ((NULL == pSep) || ((size_t) (pSep - szPath) <= RootLen))
+        return 0;
+
+    *pSep = '\0';
+
+    if (0 == strcmp (szPath, m_szLastParent))
+        return 0;
+
+    for (p = szPath + RootLen + 1; ; p++)
+    {
+        if ((g_OsDirSep == *p) || ('\0' == *p))
+        {
+            c  = *p;
+            *p = '\0';
+
+            if (0 == create_directory (szPath))
+            {
+                if (AddDirectory (szPath, 0, 0, TRUE))
+                    return 1;
+            }
+            else if (!IsRealDirectory (szPath))
+            {
+                TarError ("Parent is not a directory", szPath);
+                return 1;
+            }
+
+            *p = c;
+
+            if ('\0' == c)
+                break;
+        }
+    }
+
+    strdncpy (m_szLastParent, szPath, sizeof (m_szLastParent));
+    return 0;
+}
+
+int TarInstaller::ExtractFile (const TAR_ENTRY *pEntry, const char *pszStagePath, unsigned long long *retpHash)
+{
+    /* Returns 0 if written, 1 for a write error and -1 if the archive is truncated. The data is consumed in all cases */
+
+    int  Error = 0;
+    size_t len = 0;
+    long long Remaining = pEntry->Size;
+    XXH64_STATE State;
+
+#ifdef UNIX
+    int  fd = -1;
+    ssize_t written = 0;
+    size_t  offset  = 0;
+    struct timespec Times[2];
+
+    fd = open (pszStagePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_NOFOLLOW, 0600);
+
+    if (fd < 0)
+        Error = 1;
+
+#ifdef __linux__
+    if ((fd >= 0) && (pEntry->Size > 0))
+        fallocate (fd, 0, 0, pEntry->Size);
+#endif
+
+#else
+    FILE *fp = NULL;
+    struct _utimbuf Times;
+
+    fp = fopen (pszStagePath, "wb");
+
+    if (NULL == fp)
+        Error = 1;
+#endif
+
+    Xxh64Init (&State);
+
+    while (Remaining > 0)
+    {
+        len = (Remaining > TAR_BUFFER_SIZE) ? TAR_BUFFER_SIZE : (size_t) Remaining;
+
+        if (Read (m_pBuffer, len))
+        {
+            Error = -1;
+            break;
+        }
+
+        Xxh64Update (&State, m_pBuffer, len);
+        Remaining -= len;
+
+        if (Error)
+            continue;
+
+#ifdef UNIX
+        for (offset = 0; offset < len; offset += written)
+        {
+            written = write (fd, m_pBuffer + offset, len - offset);
+
+            if (written <= 0)
+            {
+                Error = 1;
+                break;
+            }
+        }
+#else
+        if (len != fwrite (m_pBuffer, 1, len, fp))
+            Error = 1;
+#endif
+    }
+
+    if ((Error >= 0) && Read (m_pBuffer, TAR_PADDING (pEntry->Size)))
+        Error = -1;
+
+#ifdef UNIX
+    if (fd >= 0)
+    {
+        Times[0].tv_sec  = pEntry->Mtime;
+        Times[0].tv_nsec = 0;
+        Times[1] = Times[0];
+
+        fchmod (fd, pEntry->Mode & 07777);
+        futimens (fd, Times);
+
+        if (close (fd) && (0 == Error))
+            Error = 1;
+    }
+#else
+    if (fp)
+    {
+        if (fclose (fp) && (0 == Error))
+            Error = 1;
+
+        Times.actime  = (time_t) pEntry->Mtime;
+        Times.modtime = (time_t) pEntry->Mtime;
+        _utime (pszStagePath, &Times);
+    }
+#endif
+
+    if (Error)
+        remove (pszStagePath);
+
+    *retpHash = Xxh64Digest (&State);
+    return Error;
+}
+
+int TarInstaller::ExtractEntry (const TAR_ENTRY *pEntry, const char *pszTarget, size_t RootLen, long Build)
+{
+    /* Returns 1 only if the archive cannot be read any further. Failed files are recorded as errors */
+
+    int  Job    = 0;
+    int  Error  = 0;
+    int  Link   = 0;
+    int  Result = COPY_JOB_COPIED;
+    long long Start = 0;
+    long long Size  = pEntry->Size;
+    long long Mtime = pEntry->Mtime;
+    unsigned long long Hash = 0;
+    long LinkBuild = 0;
+    size_t LinkRootLen = 0;
+    const MANIFEST_ENTRY *pOld = NULL;
+    struct stat Stat = {0};
+
+    char szStagePath[TAR_MAX_PATH+32] = {0};
+    char szLinkTarget[TAR_MAX_PATH]   = {0};
+    char szLinkSource[TAR_MAX_PATH+32] = {0};
+
+    /* A file from the best matching Release_ directory replaces the generic file, independent of the order in the archive */
+    Job = m_pScheduler->FindTarget (pszTarget);
+
+    if ((Job >= 0) && (GetTarEntryBuild (m_pScheduler->GetJob (Job)->pszSource) > Build))
+        return Skip (pEntry->Size);
+
+    if (TAR_TYPE_DIRECTORY == pEntry->Type)
+    {
+        if (CreateParents (pszTarget, RootLen))
+            return 1;
+
+        return AddDirectory (pszTarget, pEntry->Mode, pEntry->Mtime, (0 == create_directory (pszTarget)));
+    }
+
+    if (!IsTarFile (pEntry->Type) && (TAR_TYPE_HARDLINK != pEntry->Type) && (TAR_TYPE_SYMLINK != pEntry->Type))
+    {
+        TarError ("Skipped unsupported archive entry", pEntry->szName);
+        return Skip (pEntry->Size);
+    }
+
+    if (CreateParents (pszTarget, RootLen))
+        return 1;
+
+    /* Entries of the archive are only known while reading it. Each entry is synced before its stage file is written */
+    if ((Job < 0) && (m_pJournal->AddTarget (pszTarget) || m_pJournal->Sync()))
+    {
+        TarError ("Cannot write install journal", pEntry->szName);
+        return 1;
+    }
+
+    Start = GetMicroseconds();
+
+    GetStagePath (szStagePath, sizeof (szStagePath), pszTarget);
+
+    if (IsTarFile (pEntry->Type))
+    {
+        Error = ExtractFile (pEntry, szStagePath, &Hash);
+
+        if (Error < 0)
+        {
+            TarError ("Archive truncated", pEntry->szName);
+            return 1;
+        }
+    }
+    else if (TAR_TYPE_SYMLINK == pEntry->Type)
+    {
+        if (!IsLinkInsideRoot (pszTarget, RootLen, pEntry->szLink))
+        {
+            TarError ("Symbolic link points outside the install directory", pEntry->szName);
+            return 1;
+        }
+
+        Link = 1;
+        Size = (long long) strlen (pEntry->szLink);
+        remove (szStagePath);
+
+#ifdef UNIX
+        Error = symlink (pEntry->szLink, szStagePath) ? 1 : 0;
+#else
+        Error = 1;
+#endif
+        if (Skip (pEntry->Size))
+            return 1;
+    }
+    else
+    {
+        /* Hard link to a file earlier in the archive. Copied from its staged or installed file */
+        if (Skip (pEntry->Size))
+            return 1;
+
+        if (MapTarget (pEntry->szLink, szLinkTarget, sizeof (szLinkTarget), &LinkBuild, &LinkRootLen) || !HasRealParents (szLinkTarget, LinkRootLen))
+        {
+            Error = 1;
+        }
+        else
+        {
+            /* Not staged if the file was unchanged */
+            GetStagePath (szLinkSource, sizeof (szLinkSource), szLinkTarget);
+
+            if (LSTAT (szLinkSource, &Stat))
+                strdncpy (szLinkSource, szLinkTarget, sizeof (szLinkSource));
+
+            Error = copy_file (szLinkSource, szStagePath, TRUE);
+        }
+
+        if ((0 == Error) && (0 == LSTAT (szStagePath, &Stat)))
+        {
+            Size = Stat.st_size;
+            Hash = HashFile (szStagePath, 0, &Error);
+        }
+    }
+
+    if (Error)
+    {
+        Result = COPY_JOB_ERROR;
+    }
+    else if (0 == Link)
+    {
+        /* Unchanged file: The staged copy is not needed. Reading the archive is needed anyway */
+        pOld = m_pOldManifest ? m_pOldManifest->Find (pszTarget) : NULL;
+
+        if (pOld && (MANIFEST_TYPE_FILE == pOld->Type) && (pOld->Size == Size) && (pOld->Hash == Hash) &&
+            (0 == LSTAT (pszTarget, &Stat)) && !S_ISDIR (Stat.st_mode) && (pOld->Size == Stat.st_size) && (pOld->Mtime == Stat.st_mtime))
+        {
+            remove (szStagePath);
+            Result = COPY_JOB_SKIPPED;
+            Mtime  = pOld->Mtime;
+        }
+    }
+
+    return m_pScheduler->AddResult (pEntry->szName, pszTarget, Size, Mtime, Hash, Link, Result, GetMicroseconds() - Start);
+}
+
+int TarInstaller::Run (long lDominoBuild, const char *pszProgramDir, const char *pszDataDir, CopyScheduler *pScheduler, InstallJournal *pJournal, InstallManifest *pOldManifest)
+{
+    int  ret = 0;
+    int  rc  = 0;
+    int  i   = 0;
+    long Build = 0;
+    size_t RootLen = 0;
+    const COPY_JOB *pJob = NULL;
+    TAR_ENTRY Entry;
+
+    char szTarget[TAR_MAX_PATH] = {0};
+
+    m_lDominoBuild  = lDominoBuild;
+    m_pszProgramDir = pszProgramDir;
+    m_pszDataDir    = pszDataDir;
+    m_pScheduler    = pScheduler;
+    m_pJournal      = pJournal;
+    m_pOldManifest  = pOldManifest;
+
+    while (0 == (ret = ReadHeader (&Entry)))
+    {
+        rc = MapTarget (Entry.szName, szTarget, sizeof (szTarget), &Build, &RootLen);
+
+        if (rc < 0)
+        {
+            TarError ("Invalid path in archive", Entry.szName);
+            ret = 1;
+            break;
+        }
+
+        /* Not part of the install or for a later Domino version */
+        if (rc || (Build > m_lDominoBuild))
+        {
+            if (Skip (Entry.Size))
+            {
+                ret = 1;
+                break;
+            }
+            continue;
+        }
+
+        if (ExtractEntry (&Entry, szTarget, RootLen, Build))
+        {
+            ret = 1;
+            break;
+        }
+    }
+
+    if (ret > 0)
+        TarError ("Cannot read archive", Entry.szName);
+    else
+        ret = 0;
+
+    /* Logged after the archive is read. A file can be written more than once when a Release_ file follows the generic file */
+    for (i=0; i<m_pScheduler->GetFileCount(); i++)
+    {
+        pJob = m_pScheduler->GetJob (i);
+
+        if (COPY_JOB_SKIPPED == pJob->Result)
+            LogSkippedFile (pJob->pszTarget, pJob->Size, pJob->Duration);
+        else
+            LogCopyResult ((COPY_JOB_COPIED == pJob->Result) ? 0 : 1, pJob->pszTarget, pJob->Size, pJob->Duration);
+    }
+
+    return ret;
+}
+
+void TarInstaller::SetDirectoryAttributes()
+{
+#ifdef UNIX
+    int i = 0;
+    struct timespec Times[2];
+
+    /* Children first. Directories created for files without a directory entry keep their attributes */
+    for (i=m_Dirs-1; i>=0; i--)
+    {
+        if (0 == m_pDirs[i].Mode)
+            continue;
+
+        Times[0].tv_sec  = m_pDirs[i].Mtime;
+        Times[0].tv_nsec = 0;
+        Times[1] = Times[0];
+
+        chmod (m_pDirs[i].pszTarget, m_pDirs[i].Mode & 07777);
+        utimensat (AT_FDCWD, m_pDirs[i].pszTarget, Times, 0);
+    }
+#endif
+}
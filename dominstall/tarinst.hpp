@@ -0,0 +1,106 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef TARINST_HPP
+    #define TARINST_HPP
+
+#include "dominoinstall.hpp"
+#include "copysched.hpp"
+#include "journal.hpp"
+#include "manifest.hpp"
+
+#define TAR_BLOCK_SIZE       512
+#define TAR_BUFFER_SIZE      (1024*1024)
+#define TAR_MAX_INSTALL_INI  (64*1024)
+#define TAR_MAX_PATH         2048
+
+typedef struct {
+    char szName[TAR_MAX_PATH];
+    char szLink[TAR_MAX_PATH];
+    char Type;
+    long long Size;
+    long long Mtime;
+    int  Mode;
+} TAR_ENTRY;
+
+typedef struct {
+    char *pszTarget;
+    long long Mtime;
+    int  Mode;
+} TAR_DIR;
+
+
+/* Install directly from a tar stream (ustar, GNU and PAX format) without extracting the package first.
+   install.ini must be the first file in the archive. Entries below domino-bin, domino-data and an applicable
+   Release_ directory are written to the stage path of their target while reading and hashed at the same time.
+   Results are recorded in the CopyScheduler, so journal, manifest and file log work like for a copied install */
+
+class TarInstaller
+{
+
+public:
+
+    TarInstaller();
+    ~TarInstaller();
+
+    int  Open            (const char *pszTarFile);
+    int  ReadInstallIni  ();
+    int  WriteInstallIni (const char *pszFileName);
+    int  Run             (long lDominoBuild, const char *pszProgramDir, const char *pszDataDir, CopyScheduler *pScheduler, InstallJournal *pJournal, InstallManifest *pOldManifest);
+    void SetDirectoryAttributes();
+
+    const char *GetInstallIni()
+    {
+        return m_pszInstallIni;
+    }
+
+private:
+
+    int  Read            (void *pBuffer, size_t len);
+    int  Skip            (long long Size);
+    int  ReadHeader      (TAR_ENTRY *pEntry);
+    int  ReadLongName    (long long Size, char *retpszName);
+    int  ReadPaxHeader   (long long Size, TAR_ENTRY *pEntry);
+    int  MapTarget       (const char *pszName, char *retpszTarget, size_t BufferSize, long *retpBuild, size_t *retpRootLen);
+    int  CreateParents   (const char *pszTarget, size_t RootLen);
+    int  AddDirectory    (const char *pszTarget, int Mode, long long Mtime, int Created);
+    int  ExtractFile     (const TAR_ENTRY *pEntry, const char *pszStagePath, unsigned long long *retpHash);
+    int  ExtractEntry    (const TAR_ENTRY *pEntry, const char *pszTarget, size_t RootLen, long Build);
+
+    FILE *m_fp;
+    BOOL m_bStdin;
+    unsigned char *m_pBuffer;
+    char *m_pszInstallIni;
+
+    long  m_lDominoBuild;
+    const char *m_pszProgramDir;
+    const char *m_pszDataDir;
+    CopyScheduler   *m_pScheduler;
+    InstallJournal  *m_pJournal;
+    InstallManifest *m_pOldManifest;
+
+    TAR_DIR *m_pDirs;
+    int  m_Dirs;
+    int  m_DirsMax;
+
+    char m_szLastParent[TAR_MAX_PATH];
+};
+
+#endif
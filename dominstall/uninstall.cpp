@@ -0,0 +1,409 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef UNIX
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <thread>
+
+#include "dominoinstall.hpp"
+#include "uninstall.hpp"
+
+/* Large directories are split, so that one directory does not end up on a single thread */
+#define UNINSTALL_DIR_CHUNK  256
+
+#define UNINSTALL_OK         0
+#define UNINSTALL_MISSING    1
+#define UNINSTALL_ERROR      2
+
+
+static size_t DirLen (const char *pszPath)
+{
+    /* Length of the directory part without the trailing separator */
+
+    const char *p = pszPath + strlen (pszPath);
+
+    while (p > pszPath)
+    {
+        p--;
+
+        if (('/' == *p) || (g_OsDirSep == *p))
+            return p - pszPath;
+    }
+
+    return 0;
+}
+
+static int ComparePathByDirectory (const void *p1, const void *p2)
+{
+    const char *pszPath1 = *(const char **) p1;
+    const char *pszPath2 = *(const char **) p2;
+    size_t len1 = DirLen (pszPath1);
+    size_t len2 = DirLen (pszPath2);
+    int    ret  = 0;
+
+    /* All files of a directory are next to each other, sorted by name */
+    ret = memcmp (pszPath1, pszPath2, (len1 < len2) ? len1 : len2);
+
+    if (ret)
+        return ret;
+
+    if (len1 != len2)
+        return (len1 < len2) ? -1 : 1;
+
+    return strcmp (pszPath1 + len1, pszPath2 + len2);
+}
+
+static int CompareChildFirst (const void *p1, const void *p2)
+{
+    /* Descending order: A directory is always sorted before its parent */
+    return strcmp (*(const char **) p2, *(const char **) p1);
+}
+
+static int IsBelowDirectory (const char *pszPath, size_t len, const char *pszDirectory)
+{
+    size_t DirectoryLen = strlen (pszDirectory);
+
+    while (DirectoryLen && (('/' == pszDirectory[DirectoryLen-1]) || (g_OsDirSep == pszDirectory[DirectoryLen-1])))
+        DirectoryLen--;
+
+    if ((0 == DirectoryLen) || (len <= DirectoryLen + 1))
+        return 0;
+
+    if (strncmp (pszPath, pszDirectory, DirectoryLen))
+        return 0;
+
+    return ('/' == pszPath[DirectoryLen]) || (g_OsDirSep == pszPath[DirectoryLen]);
+}
+
+
+Uninstaller::Uninstaller()
+{
+    m_ppPaths      = NULL;
+    m_pDirs        = NULL;
+    m_DirCount     = 0;
+    m_Next         = 0;
+    m_RemovedFiles = 0;
+    m_MissingFiles = 0;
+    m_RemovedDirs  = 0;
+    m_Errors       = 0;
+}
+
+Uninstaller::~Uninstaller()
+{
+    if (m_ppPaths)
+    {
+        free (m_ppPaths);
+        m_ppPaths = NULL;
+    }
+
+    if (m_pDirs)
+    {
+        free (m_pDirs);
+        m_pDirs = NULL;
+    }
+}
+
+void Uninstaller::Report (int Result, const char *pszPath)
+{
+    std::lock_guard<std::mutex> Lock (m_Mutex);
+
+    switch (Result)
+    {
+        case UNINSTALL_OK:
+            m_RemovedFiles++;
+            break;
+
+        case UNINSTALL_MISSING:
+            m_MissingFiles++;
+            break;
+
+        default:
+            m_Errors++;
+#ifdef UNIX
+            printf ("Cannot remove file: [%s] (%s)\n", pszPath, strerror (errno));
+#else
+            printf ("Cannot remove file: [%s] (error: %lu)\n", pszPath, GetLastError());
+#endif
+            if (g_fpLog)
+                fprintf (g_fpLog, "Cannot remove file: %s\n", pszPath);
+            break;
+    } /* switch */
+}
+
+int Uninstaller::BuildDirectoryList()
+{
+    int i = 0;
+    int Count = 0;
+    int MaxDirs = 0;
+    size_t len = 0;
+    const MANIFEST_ENTRY *pEntry = NULL;
+
+    m_ppPaths = (const char **) malloc ((m_Files.GetCount() + 1) * sizeof (const char *));
+
+    if (NULL == m_ppPaths)
+        return 1;
+
+    for (i=0; i<m_Files.GetCount(); i++)
+    {
+        pEntry = m_Files.GetEntry (i);
+
+        if (MANIFEST_TYPE_FILE == pEntry->Type)
+            m_ppPaths[Count++] = pEntry->pszPath;
+    }
+
+    qsort (m_ppPaths, Count, sizeof (const char *), ComparePathByDirectory);
+
+    /* Worst case every file is in its own directory */
+    MaxDirs = Count + 1;
+    m_pDirs = (UNINSTALL_DIR *) malloc (MaxDirs * sizeof (UNINSTALL_DIR));
+
+    if (NULL == m_pDirs)
+        return 1;
+
+    for (i=0; i<Count; i++)
+    {
+        if (m_DirCount && (m_pDirs[m_DirCount-1].Count < UNINSTALL_DIR_CHUNK))
+        {
+            len = DirLen (m_ppPaths[i]);
+
+            if ((len == DirLen (m_ppPaths[i-1])) && (0 == memcmp (m_ppPaths[i], m_ppPaths[i-1], len)))
+            {
+                m_pDirs[m_DirCount-1].Count++;
+                continue;
+            }
+        }
+
+        m_pDirs[m_DirCount].First = i;
+        m_pDirs[m_DirCount].Count = 1;
+        m_DirCount++;
+    }
+
+    return 0;
+}
+
+void Uninstaller::RemoveDirectoryFiles (const UNINSTALL_DIR *pDir)
+{
+    int i = 0;
+    const char *pszPath = NULL;
+
+#ifdef UNIX
+
+    int fd = -1;
+    int DirError = 0;
+    size_t len = DirLen (m_ppPaths[pDir->First]);
+    char *pszDirectory = strdup (m_ppPaths[pDir->First]);
+
+    /* Files are removed relative to the opened directory. The path is only resolved once per directory */
+    if (pszDirectory)
+    {
+        pszDirectory[len ? len : 1] = '\0';
+        fd = open (len ? pszDirectory : "/", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        DirError = errno;
+        free (pszDirectory);
+        pszDirectory = NULL;
+    }
+
+    for (i=0; i<pDir->Count; i++)
+    {
+        pszPath = m_ppPaths[pDir->First + i];
+
+        if (fd < 0)
+        {
+            errno = DirError;
+            Report ((ENOENT == DirError) ? UNINSTALL_MISSING : UNINSTALL_ERROR, pszPath);
+            continue;
+        }
+
+        if (0 == unlinkat (fd, pszPath + len + 1, 0))
+            Report (UNINSTALL_OK, pszPath);
+        else
+            Report ((ENOENT == errno) ? UNINSTALL_MISSING : UNINSTALL_ERROR, pszPath);
+    }
+
+    if (fd >= 0)
+        close (fd);
+
+#else
+
+    DWORD dwError = 0;
+
+    for (i=0; i<pDir->Count; i++)
+    {
+        pszPath = m_ppPaths[pDir->First + i];
+
+        if (DeleteFile (pszPath))
+        {
+            Report (UNINSTALL_OK, pszPath);
+            continue;
+        }
+
+        dwError = GetLastError();
+        Report (((ERROR_FILE_NOT_FOUND == dwError) || (ERROR_PATH_NOT_FOUND == dwError)) ? UNINSTALL_MISSING : UNINSTALL_ERROR, pszPath);
+    }
+
+#endif
+}
+
+void Uninstaller::Worker()
+{
+    int i = 0;
+
+    while ((i = m_Next++) < m_DirCount)
+        RemoveDirectoryFiles (&m_pDirs[i]);
+}
+
+void Uninstaller::WorkerThread (Uninstaller *pUninstaller)
+{
+    pUninstaller->Worker();
+}
+
+void Uninstaller::RemoveEmptyDirectories (const char *pszProgramDir, const char *pszDataDir)
+{
+    int i = 0;
+    int Count = 0;
+    int bOwned = 0;
+    size_t len = 0;
+    const char **ppDirs = NULL;
+    const MANIFEST_ENTRY *pEntry = NULL;
+    InstallManifest Candidates;
+
+    char szDirectory[4096] = {0};
+
+    for (i=0; i<m_Manifest.GetCount(); i++)
+    {
+        pEntry = m_Manifest.GetEntry (i);
+
+        if (MANIFEST_TYPE_OWNED_DIRECTORY != pEntry->Type)
+            continue;
+
+        Candidates.AddDirectory (pEntry->pszPath, 1);
+        bOwned = 1;
+    }
+
+    /* Without ownership information: Parent directories of removed files up to the program and data directory */
+    for (i=0; (0 == bOwned) && (i<m_DirCount); i++)
+    {
+        strdncpy (szDirectory, m_ppPaths[m_pDirs[i].First], sizeof (szDirectory));
+        len = DirLen (szDirectory);
+
+        while (len && (IsBelowDirectory (szDirectory, len, pszProgramDir) || IsBelowDirectory (szDirectory, len, pszDataDir)))
+        {
+            szDirectory[len] = '\0';
+
+            if (Candidates.Find (szDirectory))
+                break;
+
+            Candidates.AddDirectory (szDirectory, 0);
+            len = DirLen (szDirectory);
+        }
+    }
+
+    if (0 == Candidates.GetCount())
+        return;
+
+    ppDirs = (const char **) malloc (Candidates.GetCount() * sizeof (const char *));
+
+    if (NULL == ppDirs)
+        return;
+
+    for (i=0; i<Candidates.GetCount(); i++)
+        ppDirs[Count++] = Candidates.GetEntry (i)->pszPath;
+
+    qsort (ppDirs, Count, sizeof (const char *), CompareChildFirst);
+
+    /* Directories which still contain files are kept */
+    for (i=0; i<Count; i++)
+    {
+#ifdef UNIX
+        if (0 == rmdir (ppDirs[i]))
+#else
+        if (RemoveDirectory (ppDirs[i]))
+#endif
+        {
+            m_RemovedDirs++;
+
+            if (g_fpLog)
+                fprintf (g_fpLog, "Removed directory: %s\n", ppDirs[i]);
+        }
+    }
+
+    free (ppDirs);
+}
+
+int Uninstaller::Run (const char *pszFileList, const char *pszManifestFile, const char *pszProgramDir, const char *pszDataDir, int Threads)
+{
+    /* Returns the number of files which could not be removed */
+
+    int i = 0;
+    std::thread *pThreads = NULL;
+
+    if (m_Files.ReadFileList (pszFileList))
+    {
+        printf ("Cannot open: [%s]\n", pszFileList);
+        return -1;
+    }
+
+    /* Only needed for the directories created by the install */
+    m_Manifest.Read (pszManifestFile);
+
+    if (BuildDirectoryList())
+    {
+        printf ("Cannot allocate memory for %d files\n", m_Files.GetCount());
+        return -1;
+    }
+
+    if (Threads < 1)
+        Threads = 1;
+
+    if (Threads > MAX_COPY_THREADS)
+        Threads = MAX_COPY_THREADS;
+
+    if (Threads > m_DirCount)
+        Threads = m_DirCount;
+
+    if (Threads > 1)
+    {
+        pThreads = new std::thread[Threads];
+
+        for (i=0; i<Threads; i++)
+            pThreads[i] = std::thread (WorkerThread, this);
+
+        for (i=0; i<Threads; i++)
+            pThreads[i].join();
+
+        delete [] pThreads;
+        pThreads = NULL;
+    }
+    else
+    {
+        Worker();
+    }
+
+    RemoveEmptyDirectories (pszProgramDir, pszDataDir);
+
+    return m_Errors;
+}
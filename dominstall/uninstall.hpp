@@ -0,0 +1,97 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef UNINSTALL_HPP
+    #define UNINSTALL_HPP
+
+#include <atomic>
+#include <mutex>
+
+#include "dominoinstall.hpp"
+#include "manifest.hpp"
+
+typedef struct {
+    int  First;
+    int  Count;
+} UNINSTALL_DIR;
+
+
+/* Remove the installed files of an application listed in its file log.
+   Files are grouped by directory. Each directory is opened once and its files are removed relative to it by parallel threads.
+   Afterwards emptied directories are removed bottom-up: Directories created by the install if the manifest records them,
+   otherwise directories below the program and data directory, which only contained files of the application */
+
+class Uninstaller
+{
+
+public:
+
+    Uninstaller();
+    ~Uninstaller();
+
+    int  Run (const char *pszFileList, const char *pszManifestFile, const char *pszProgramDir, const char *pszDataDir, int Threads);
+
+    int  GetRemovedFiles()
+    {
+        return m_RemovedFiles;
+    }
+
+    int  GetMissingFiles()
+    {
+        return m_MissingFiles;
+    }
+
+    int  GetRemovedDirectories()
+    {
+        return m_RemovedDirs;
+    }
+
+    int  GetErrors()
+    {
+        return m_Errors;
+    }
+
+private:
+
+    int  BuildDirectoryList();
+    void RemoveDirectoryFiles (const UNINSTALL_DIR *pDir);
+    void RemoveEmptyDirectories (const char *pszProgramDir, const char *pszDataDir);
+    void Report (int Error, const char *pszPath);
+    void Worker();
+
+    static void WorkerThread (Uninstaller *pUninstaller);
+
+    InstallManifest m_Files;
+    InstallManifest m_Manifest;
+
+    const char **m_ppPaths;
+    UNINSTALL_DIR *m_pDirs;
+    int  m_DirCount;
+
+    std::atomic<int> m_Next;
+    std::mutex m_Mutex;
+
+    int  m_RemovedFiles;
+    int  m_MissingFiles;
+    int  m_RemovedDirs;
+    int  m_Errors;
+};
+
+#endif
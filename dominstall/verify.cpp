@@ -0,0 +1,227 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <thread>
+
+#include "dominoinstall.hpp"
+#include "verify.hpp"
+
+#ifdef UNIX
+    #define LSTAT lstat
+#else
+    #define LSTAT stat
+    #define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
+    #define S_ISLNK(m) 0
+#endif
+
+#ifdef __linux__
+    #define IOPRIO_WHO_PROCESS   1
+    #define IOPRIO_CLASS_IDLE    3
+    #define IOPRIO_CLASS_SHIFT   13
+#endif
+
+
+static void SetBackgroundPriority()
+{
+    /* Verify runs on production servers. Only use disk and CPU time nobody else needs */
+
+#ifdef __linux__
+    syscall (SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+    setpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid), 19);
+#elif !defined(UNIX)
+    SetThreadPriority (GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#endif
+}
+
+
+InstallVerifier::InstallVerifier()
+{
+    m_pszName  = NULL;
+    m_bDeep    = FALSE;
+    m_Next     = 0;
+    m_Files    = 0;
+    m_Missing  = 0;
+    m_Modified = 0;
+    m_Extra    = 0;
+}
+
+void InstallVerifier::Report (int Result, const char *pszPath)
+{
+    const char *pszResult = NULL;
+
+    std::lock_guard<std::mutex> Lock (m_Mutex);
+
+    switch (Result)
+    {
+        case VERIFY_MISSING:
+            pszResult = "MISSING";
+            m_Missing++;
+            break;
+
+        case VERIFY_MODIFIED:
+            pszResult = "MODIFIED";
+            m_Modified++;
+            break;
+
+        case VERIFY_EXTRA:
+            pszResult = "EXTRA";
+            m_Extra++;
+            break;
+
+        default:
+            return;
+    } /* switch */
+
+    printf ("%s|%s|%s\n", pszResult, m_pszName, pszPath);
+}
+
+int InstallVerifier::CheckFile (const MANIFEST_ENTRY *pEntry)
+{
+    int Error = 0;
+    unsigned long long Hash = 0;
+    struct stat Stat = {0};
+
+    if (LSTAT (pEntry->pszPath, &Stat))
+        return VERIFY_MISSING;
+
+    if (S_ISDIR (Stat.st_mode))
+        return VERIFY_MODIFIED;
+
+    if (pEntry->Size != Stat.st_size)
+        return VERIFY_MODIFIED;
+
+    /* Only the content of files is hashed, links are checked by size */
+    if (S_ISLNK (Stat.st_mode))
+        return VERIFY_OK;
+
+    if ((pEntry->Mtime == Stat.st_mtime) && (FALSE == m_bDeep))
+        return VERIFY_OK;
+
+    Hash = HashFile (pEntry->pszPath, HASH_FILE_NOCACHE, &Error);
+
+    if (Error || (Hash != pEntry->Hash))
+        return VERIFY_MODIFIED;
+
+    return VERIFY_OK;
+}
+
+void InstallVerifier::Worker()
+{
+    int i = 0;
+    const MANIFEST_ENTRY *pEntry = NULL;
+
+    SetBackgroundPriority();
+
+    /* Entries are taken one by one. A large file does not hold up the remaining entries */
+    while ((i = m_Next++) < m_Manifest.GetCount())
+    {
+        pEntry = m_Manifest.GetEntry (i);
+
+        if (MANIFEST_TYPE_FILE == pEntry->Type)
+            Report (CheckFile (pEntry), pEntry->pszPath);
+    }
+}
+
+void InstallVerifier::WorkerThread (InstallVerifier *pVerifier)
+{
+    pVerifier->Worker();
+}
+
+int InstallVerifier::CheckExtraEntry (const char *pszFindPath, void *pCustomData)
+{
+    InstallVerifier *pVerifier = (InstallVerifier *) pCustomData;
+
+    if (NULL == pVerifier)
+        return 0;
+
+    if (NULL == pVerifier->m_Manifest.Find (pszFindPath))
+        pVerifier->Report (VERIFY_EXTRA, pszFindPath);
+
+    return 0;
+}
+
+int InstallVerifier::Run (const char *pszName, const char *pszManifestFile, int Threads, BOOL bDeep)
+{
+    /* Returns the number of missing, modified and extra files */
+
+    int i = 0;
+    const MANIFEST_ENTRY *pEntry = NULL;
+    std::thread *pThreads = NULL;
+
+    m_pszName = pszName;
+    m_bDeep   = bDeep;
+    m_Next    = 0;
+
+    if (m_Manifest.Read (pszManifestFile))
+    {
+        printf ("Cannot read manifest: [%s]\n", pszManifestFile);
+        return -1;
+    }
+
+    for (i=0; i<m_Manifest.GetCount(); i++)
+    {
+        if (MANIFEST_TYPE_FILE == m_Manifest.GetEntry (i)->Type)
+            m_Files++;
+    }
+
+    if (Threads < 1)
+        Threads = 1;
+
+    if (Threads > MAX_COPY_THREADS)
+        Threads = MAX_COPY_THREADS;
+
+    if (Threads > m_Files)
+        Threads = m_Files;
+
+    if (Threads > 0)
+    {
+        pThreads = new std::thread[Threads];
+
+        for (i=0; i<Threads; i++)
+            pThreads[i] = std::thread (WorkerThread, this);
+
+        for (i=0; i<Threads; i++)
+            pThreads[i].join();
+
+        delete [] pThreads;
+        pThreads = NULL;
+    }
+
+    /* Only directories created by the install. Shared directories also contain files of Domino and other applications */
+    for (i=0; i<m_Manifest.GetCount(); i++)
+    {
+        pEntry = m_Manifest.GetEntry (i);
+
+        if (MANIFEST_TYPE_OWNED_DIRECTORY == pEntry->Type)
+            RunCommandOnFileFind (RUN_COMMAND_ON_FIND_FLAG_FILE | RUN_COMMAND_ON_FIND_FLAG_DIRECTORY, pEntry->pszPath, "", CheckExtraEntry, this, 1);
+    }
+
+    return m_Missing + m_Modified + m_Extra;
+}
@@ -0,0 +1,94 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifndef VERIFY_HPP
+    #define VERIFY_HPP
+
+#include <atomic>
+#include <mutex>
+
+#include "dominoinstall.hpp"
+#include "manifest.hpp"
+
+#define VERIFY_OK         0
+#define VERIFY_MISSING    1
+#define VERIFY_MODIFIED   2
+#define VERIFY_EXTRA      3
+
+#define DEFAULT_VERIFY_THREADS  2
+
+
+/* Verify installed files of an application against its manifest.
+   Size and modification time are checked first. Files are only hashed if the time differs or for a deep check.
+   Verify threads run with idle IO and CPU priority and do not keep verified files in the page cache.
+   Directories created by the install are checked for files not listed in the manifest */
+
+class InstallVerifier
+{
+
+public:
+
+    InstallVerifier();
+
+    int  Run (const char *pszName, const char *pszManifestFile, int Threads, BOOL bDeep);
+
+    int  GetFileCount()
+    {
+        return m_Files;
+    }
+
+    int  GetMissing()
+    {
+        return m_Missing;
+    }
+
+    int  GetModified()
+    {
+        return m_Modified;
+    }
+
+    int  GetExtra()
+    {
+        return m_Extra;
+    }
+
+private:
+
+    int  CheckFile (const MANIFEST_ENTRY *pEntry);
+    void Report    (int Result, const char *pszPath);
+    void Worker();
+
+    static int  CheckExtraEntry (const char *pszFindPath, void *pCustomData);
+    static void WorkerThread    (InstallVerifier *pVerifier);
+
+    InstallManifest m_Manifest;
+    const char *m_pszName;
+    BOOL m_bDeep;
+
+    std::atomic<int> m_Next;
+    std::mutex m_Mutex;
+
+    int  m_Files;
+    int  m_Missing;
+    int  m_Modified;
+    int  m_Extra;
+};
+
+#endif
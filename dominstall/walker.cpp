@@ -0,0 +1,440 @@
+/*
+###########################################################################
+# Domino Add-On Install                                                   #
+# Version 0.2 19.10.2026                                                  #
+# (C) Copyright Daniel Nashed/NashCom 2023                                #
+#                                                                         #
+# Licensed under the Apache License, Version 2.0 (the "License");         #
+# you may not use this file except in compliance with the License.        #
+# You may obtain a copy of the License at                                 #
+#                                                                         #
+#      http://www.apache.org/licenses/LICENSE-2.0                         #
+#                                                                         #
+# Unless required by applicable law or agreed to in writing, software     #
+# distributed under the License is distributed on an "AS IS" BASIS,       #
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.#
+# See the License for the specific language governing permissions and     #
+# limitations under the License.                                          #
+###########################################################################
+*/
+
+#ifdef UNIX
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dominoinstall.hpp"
+
+#define WALK_PATH_INITIAL     1024
+#define WALK_LEVELS_STEP      16
+#define WALK_DENTS_BUFFER     (32*1024)
+
+#ifdef __linux__
+
+/* Layout of the entries returned by getdents64. glibc only provides the system call */
+typedef struct {
+    unsigned long long d_ino;
+    long long          d_off;
+    unsigned short     d_reclen;
+    unsigned char      d_type;
+    char               d_name[1];
+} LINUX_DIRENT64;
+
+#endif
+
+typedef struct {
+
+#ifdef __linux__
+    int   fd;
+    char  *pBuffer;
+    long  Size;
+    long  Pos;
+#elif defined (UNIX)
+    DIR   *pDir;
+#else
+    HANDLE hSearch;
+    BOOL  bPending;
+    WIN32_FIND_DATA FindData;
+#endif
+
+    size_t PathLen;
+
+} WALK_LEVEL;
+
+typedef struct {
+    char   *pszPath;
+    size_t Size;
+    WALK_LEVEL *pLevels;
+    int    LevelsMax;
+} WALK_STATE;
+
+
+static int SetWalkPath (WALK_STATE *pState, size_t DirLen, const char *pszName)
+{
+    /* One path buffer for the whole walk. The name replaces the previous entry of the same directory */
+
+    size_t len  = strlen (pszName);
+    size_t Size = 0;
+    char   *pNew = NULL;
+
+    if (DirLen + len + 2 > pState->Size)
+    {
+        Size = pState->Size ? pState->Size : WALK_PATH_INITIAL;
+
+        while (DirLen + len + 2 > Size)
+            Size *= 2;
+
+        pNew = (char *) realloc (pState->pszPath, Size);
+
+        if (NULL == pNew)
+            return 1;
+
+        pState->pszPath = pNew;
+        pState->Size    = Size;
+    }
+
+    if (DirLen)
+        pState->pszPath[DirLen++] = g_OsDirSep;
+
+    memcpy (pState->pszPath + DirLen, pszName, len + 1);
+    return 0;
+}
+
+static WALK_LEVEL *PushWalkLevel (WALK_STATE *pState, int Depth)
+{
+    WALK_LEVEL *pNew = NULL;
+
+    if (Depth >= pState->LevelsMax)
+    {
+        pNew = (WALK_LEVEL *) realloc (pState->pLevels, (pState->LevelsMax + WALK_LEVELS_STEP) * sizeof (WALK_LEVEL));
+
+        if (NULL == pNew)
+            return NULL;
+
+        memset (pNew + pState->LevelsMax, 0, WALK_LEVELS_STEP * sizeof (WALK_LEVEL));
+
+        pState->pLevels    = pNew;
+        pState->LevelsMax += WALK_LEVELS_STEP;
+    }
+
+    return pState->pLevels + Depth;
+}
+
+
+#ifdef __linux__
+
+static int OpenWalkLevel (WALK_STATE *pState, WALK_LEVEL *pParent, const char *pszName, WALK_LEVEL *pLevel)
+{
+    /* Sub directories are opened relative to their parent. Symbolic links are not followed */
+
+    if (pParent)
+        pLevel->fd = openat (pParent->fd, pszName, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    else
+        pLevel->fd = open (pszName, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if (pLevel->fd < 0)
+        return 1;
+
+    if (NULL == pLevel->pBuffer)
+    {
+        pLevel->pBuffer = (char *) malloc (WALK_DENTS_BUFFER);
+
+        if (NULL == pLevel->pBuffer)
+        {
+            close (pLevel->fd);
+            pLevel->fd = -1;
+            return 1;
+        }
+    }
+
+    pLevel->Size    = 0;
+    pLevel->Pos     = 0;
+    pLevel->PathLen = strlen (pState->pszPath);
+
+    return 0;
+}
+
+static const char *NextWalkEntry (WALK_LEVEL *pLevel, int *retpIsDir)
+{
+    LINUX_DIRENT64 *pEntry = NULL;
+    struct stat Stat = {0};
+
+    if (pLevel->Pos >= pLevel->Size)
+    {
+        pLevel->Size = syscall (SYS_getdents64, pLevel->fd, pLevel->pBuffer, WALK_DENTS_BUFFER);
+        pLevel->Pos  = 0;
+
+        if (pLevel->Size <= 0)
+            return NULL;
+    }
+
+    pEntry = (LINUX_DIRENT64 *) (pLevel->pBuffer + pLevel->Pos);
+    pLevel->Pos += pEntry->d_reclen;
+
+    if (DT_UNKNOWN != pEntry->d_type)
+    {
+        *retpIsDir = (DT_DIR == pEntry->d_type);
+    }
+    else
+    {
+        /* File system does not provide the type in the directory entry */
+        *retpIsDir = (0 == fstatat (pLevel->fd, pEntry->d_name, &Stat, AT_SYMLINK_NOFOLLOW)) && S_ISDIR (Stat.st_mode);
+    }
+
+    return pEntry->d_name;
+}
+
+static void CloseWalkLevel (WALK_LEVEL *pLevel)
+{
+    if (pLevel->fd >= 0)
+        close (pLevel->fd);
+
+    pLevel->fd = -1;
+}
+
+static void FreeWalkLevel (WALK_LEVEL *pLevel)
+{
+    if (pLevel->pBuffer)
+    {
+        free (pLevel->pBuffer);
+        pLevel->pBuffer = NULL;
+    }
+}
+
+#elif defined (UNIX)
+
+static int OpenWalkLevel (WALK_STATE *pState, WALK_LEVEL *pParent, const char *pszName, WALK_LEVEL *pLevel)
+{
+    int fd = -1;
+
+    if (pParent)
+        fd = openat (dirfd (pParent->pDir), pszName, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+    else
+        fd = open (pszName, O_RDONLY | O_DIRECTORY);
+
+    if (fd < 0)
+        return 1;
+
+    pLevel->pDir = fdopendir (fd);
+
+    if (NULL == pLevel->pDir)
+    {
+        close (fd);
+        return 1;
+    }
+
+    pLevel->PathLen = strlen (pState->pszPath);
+    return 0;
+}
+
+static const char *NextWalkEntry (WALK_LEVEL *pLevel, int *retpIsDir)
+{
+    struct dirent *pEntry = NULL;
+    struct stat Stat = {0};
+
+    pEntry = readdir (pLevel->pDir);
+
+    if (NULL == pEntry)
+        return NULL;
+
+    if (DT_UNKNOWN != pEntry->d_type)
+        *retpIsDir = (DT_DIR == pEntry->d_type);
+    else
+        *retpIsDir = (0 == fstatat (dirfd (pLevel->pDir), pEntry->d_name, &Stat, AT_SYMLINK_NOFOLLOW)) && S_ISDIR (Stat.st_mode);
+
+    return pEntry->d_name;
+}
+
+static void CloseWalkLevel (WALK_LEVEL *pLevel)
+{
+    if (pLevel->pDir)
+        closedir (pLevel->pDir);
+
+    pLevel->pDir = NULL;
+}
+
+static void FreeWalkLevel (WALK_LEVEL *pLevel)
+{
+}
+
+#else
+
+static int OpenWalkLevel (WALK_STATE *pState, WALK_LEVEL *pParent, const char *pszName, WALK_LEVEL *pLevel)
+{
+    /* The path buffer already contains the directory. The search pattern is appended temporarily */
+
+    size_t PathLen = strlen (pState->pszPath);
+
+    if (SetWalkPath (pState, PathLen, "*"))
+        return 1;
+
+    pLevel->hSearch = FindFirstFileEx (pState->pszPath, FindExInfoBasic, &pLevel->FindData, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+
+    pState->pszPath[PathLen] = '\0';
+
+    if (INVALID_HANDLE_VALUE == pLevel->hSearch)
+    {
+        pLevel->hSearch = NULL;
+        return 1;
+    }
+
+    pLevel->bPending = TRUE;
+    pLevel->PathLen  = PathLen;
+    return 0;
+}
+
+static const char *NextWalkEntry (WALK_LEVEL *pLevel, int *retpIsDir)
+{
+    if (pLevel->bPending)
+        pLevel->bPending = FALSE;
+    else if (!FindNextFile (pLevel->hSearch, &pLevel->FindData))
+        return NULL;
+
+    *retpIsDir = (0 != (FILE_ATTRIBUTE_DIRECTORY & pLevel->FindData.dwFileAttributes));
+
+    return pLevel->FindData.cFileName;
+}
+
+static void CloseWalkLevel (WALK_LEVEL *pLevel)
+{
+    if (pLevel->hSearch)
+        FindClose (pLevel->hSearch);
+
+    pLevel->hSearch = NULL;
+}
+
+static void FreeWalkLevel (WALK_LEVEL *pLevel)
+{
+}
+
+#endif
+
+
+int RunCommandOnFileFind (long lFlags, const char *pszDirectory, const char *pszMatchFileName, TYPE_CMD_FUNCTION_CALLBACK *pCommandCallbackFunction, void *pCustomData, int levels)
+{
+    /* Iterative walk with one open directory per level and a single growable path buffer.
+       Entries are reported in the same order as a recursive walk: A directory is reported before its content.
+       levels is the number of directory levels read. 1 only reads the specified directory */
+
+    int  ret   = 0;
+    int  i     = 0;
+    int  Depth = 0;
+    int  IsDir = 0;
+    const char *pszName = NULL;
+    WALK_LEVEL *pLevel  = NULL;
+    WALK_STATE State    = {0};
+
+    if (levels <= 0)
+        goto Done;
+
+    if (IsNullStr (pszDirectory))
+        goto Done;
+
+    if (NULL == pszMatchFileName)
+        goto Done;
+
+    if (NULL == pCommandCallbackFunction)
+        goto Done;
+
+    if (SetWalkPath (&State, 0, pszDirectory))
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    pLevel = PushWalkLevel (&State, 0);
+
+    if (NULL == pLevel)
+    {
+        ret = 1;
+        goto Done;
+    }
+
+    if (OpenWalkLevel (&State, NULL, State.pszPath, pLevel))
+        goto Done;
+
+    while (Depth >= 0)
+    {
+        pLevel  = State.pLevels + Depth;
+        pszName = NextWalkEntry (pLevel, &IsDir);
+
+        if (NULL == pszName)
+        {
+            CloseWalkLevel (pLevel);
+            Depth--;
+            continue;
+        }
+
+        if (('.' == pszName[0]) && (('\0' == pszName[1]) || (('.' == pszName[1]) && ('\0' == pszName[2]))))
+            continue;
+
+        if (SetWalkPath (&State, pLevel->PathLen, pszName))
+        {
+            ret = 1;
+            break;
+        }
+
+        if (IsDir)
+        {
+            if (RUN_COMMAND_ON_FIND_FLAG_DIRECTORY & lFlags)
+                pCommandCallbackFunction (State.pszPath, pCustomData);
+
+            if (Depth+1 >= levels)
+                continue;
+
+            /* The parent level may move when the level array grows */
+            if (NULL == PushWalkLevel (&State, Depth+1))
+            {
+                ret = 1;
+                break;
+            }
+
+            pLevel = State.pLevels + Depth;
+
+            if (0 == OpenWalkLevel (&State, pLevel, pszName, State.pLevels + Depth + 1))
+                Depth++;
+        }
+        else if (RUN_COMMAND_ON_FIND_FLAG_FILE & lFlags)
+        {
+            if ((0 == *pszMatchFileName) || (0 == strcmp (pszName, pszMatchFileName)))
+                pCommandCallbackFunction (State.pszPath, pCustomData);
+        }
+
+    } /* while */
+
+Done:
+
+    /* Levels still open after an error */
+    for (i=Depth; i>=0; i--)
+    {
+        if (State.pLevels)
+            CloseWalkLevel (State.pLevels + i);
+    }
+
+    for (i=0; i<State.LevelsMax; i++)
+        FreeWalkLevel (State.pLevels + i);
+
+    if (State.pLevels)
+    {
+        free (State.pLevels);
+        State.pLevels = NULL;
+    }
+
+    if (State.pszPath)
+    {
+        free (State.pszPath);
+        State.pszPath = NULL;
+    }
+
+    return ret;
+}